@@ -1,4 +1,5 @@
 #include <G4RunManager.hh>
+#include <G4RunManagerFactory.hh>
 #include <G4UImanager.hh>
 #include <G4VisExecutive.hh>
 #include <G4UIExecutive.hh>
@@ -18,6 +19,15 @@
 // allow ourselves to give the user extra info about available physics ctors
 #include "G4PhysicsConstructorFactory.hh"
 #include "PrimaryGeneratorAction.hh"
+#include "LoggingMessenger.hh"
+#include "EventSeeder.hh"
+#include "FastShower.hh"
+#include "G4FastSimulationPhysics.hh"
+
+#include <TROOT.h>
+
+#include <algorithm>
+#include <string>
 
 // forward declaration
 void PrintAvailable(G4int verb = 1);
@@ -34,23 +44,58 @@ int main(int argc, char** argv) {
   // pick physics list
   std::string physListName = "FTFP_BERT+PY8DK";
   G4long firstEvent = -1; // -1 indicates not set via command line
+  G4long nEvents = -1; // -1 leaves /run/beamOn to the macro
+  G4long seed = -1; // -1 draws a run seed from the clock
+  G4int nThreads = 0; // 0 runs the sequential event loop
+  G4bool fastSim = false; // fast shower model of the absorber (--fastsim 1)
   for (G4int i = 0; i < argc; i = i + 2) {
     G4String g4argv(argv[i]);  // convert only once
     if (g4argv == "-p") physListName = argv[i + 1];
-    else if (g4argv == "-f" || g4argv == "--firstEvent") {
+    else if (g4argv == "-f" || g4argv == "--firstEvent" || g4argv == "--first-event") {
       firstEvent = std::atol(argv[i + 1]);
     }
+    else if (g4argv == "-n" || g4argv == "--n-events") {
+      nEvents = std::atol(argv[i + 1]);
+    }
+    else if (g4argv == "-s" || g4argv == "--seed") {
+      seed = std::atol(argv[i + 1]);
+    }
+    else if (g4argv == "-t" || g4argv == "--threads") {
+      nThreads = std::atoi(argv[i + 1]);
+    }
+    else if (g4argv == "--fastsim") {
+      fastSim = std::atoi(argv[i + 1]) != 0;
+    }
   }
 
+  // every event is reseeded from (run seed, first event + event ID), so a
+  // shard given the same seed reproduces the same events
+  EventSeeder::SetRunSeed((seed >= 0) ? seed : EventSeeder::MakeRunSeed());
+  G4cout << "Run seed: " << EventSeeder::GetRunSeed() << " (repeat with --seed "
+         << EventSeeder::GetRunSeed() << ")" << G4endl;
+
   // Choose the Random engine
   //
   G4Random::setTheEngine(new CLHEP::RanecuEngine);
 
+  // global /log/ commands
+  LoggingMessenger* logMessenger = new LoggingMessenger();
+
   // invoke analysis manager before ui manager to invoke analysis manager messenger
   AnalysisManager* analysis = AnalysisManager::GetInstance();
 
   // Create the run manager (MT or non-MT) and make it a bit verbose.
-  auto runManager = new G4RunManager();
+  // With -t N the event loop runs on N worker threads sharing geometry and
+  // physics tables; /run/numberOfThreads can still override N from a macro.
+  G4RunManager* runManager = nullptr;
+  if (nThreads > 0) {
+    // ROOT must be told up front that TFile/TTree objects live on several threads
+    ROOT::EnableThreadSafety();
+    runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Tasking);
+    runManager->SetNumberOfThreads(nThreads);
+  } else {
+    runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Serial);
+  }
   runManager->SetVerboseLevel(1);
 
   // Set mandatory initialization classes
@@ -79,6 +124,18 @@ int main(int argc, char** argv) {
     G4Exception("extensibleFactory", "extensibleFactory001", FatalException, ed);
     exit(42);
   }
+
+  // fast simulation hooks for the absorber shower model (FastShowerModel),
+  // only on request so the default physics is untouched
+  FastShower::SetAvailable(fastSim);
+  if (fastSim) {
+    auto fastSimulationPhysics = new G4FastSimulationPhysics();
+    fastSimulationPhysics->ActivateFastSimulation("e-");
+    fastSimulationPhysics->ActivateFastSimulation("e+");
+    fastSimulationPhysics->ActivateFastSimulation("gamma");
+    physicsList->RegisterPhysics(fastSimulationPhysics);
+  }
+
   runManager->SetUserInitialization(physicsList);
 
   // Set user action classes
@@ -95,6 +152,10 @@ int main(int argc, char** argv) {
     PrimaryGeneratorAction::SetFirstEvent(firstEvent);
   }
 
+  // the shard is also visible to macros as {firstEvent} and {nEvents}
+  UImanager->ApplyCommand("/control/alias firstEvent " + std::to_string(std::max<G4long>(firstEvent, 0)));
+  if (nEvents >= 0) UImanager->ApplyCommand("/control/alias nEvents " + std::to_string(nEvents));
+
   // Parse command line arguments
   if (argc==1) {
     G4UIExecutive* ui = new G4UIExecutive(argc, argv);
@@ -106,6 +167,11 @@ int main(int argc, char** argv) {
     G4String command = "/control/execute ";
     G4String fileName = argv[1];
     UImanager->ApplyCommand(command+fileName);
+
+    // with --n-events the shard is run here unless the macro already did
+    if (nEvents >= 0 && !runManager->GetCurrentRun()) {
+      runManager->BeamOn(nEvents);
+    }
     if (argc==3) {
       G4String mode = argv[2];
       if (mode == "vis") {
@@ -121,6 +187,7 @@ int main(int argc, char** argv) {
 
   delete visManager;
   delete runManager;
+  delete logMessenger;
 
   G4cout<<"Application sucessfully ended.\nBye :-)"<<G4endl;
 
@@ -0,0 +1,118 @@
+#ifndef ACTSOUTPUT_HH
+#define ACTSOUTPUT_HH
+
+#include <cstdint>
+#include <vector>
+
+#include "PixelAccumulator.hh"
+#include "reco/Barcode.hh"
+
+#include "G4LorentzVector.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class G4Event;
+class TrackTable;
+
+// Truth of the pixel detector in the form ACTS works with (/out/saveActs).
+//
+// Simulated hits: one per crossing of a silicon plane by a track, built by
+// PixelSD from the pixel deposits of the event. The hit is placed at the
+// first step of the track in the plane and carries its four-momentum there
+// and the energy it deposited over the plane.
+//
+// Barcodes (ActsFatras::Barcode): a primary gets its vertex (counted from
+// 1, as ACTS requires a non-zero primary vertex) and its index in the
+// vertex. A secondary takes the barcode of its primary ancestor from the
+// TrackTable, with its generation (decay or interaction depth below the
+// primary) and a sub-particle number counting the secondaries of the same
+// ancestor and generation in track ID order; past 65535 it carries on in
+// the secondary vertex level, which primaries leave at zero. Barcodes are
+// given to the primaries and to the secondaries with hits, the only
+// particles written. A particle beyond the range of the levels keeps the
+// invalid barcode (0) and is not written, so no barcode is ever shared.
+//
+// Surfaces are identified by a GeometryId per silicon plane, pixels within
+// the plane by a PixelChannel.
+class ActsOutput
+{
+  public:
+    struct SimHit {
+      G4int trackID;
+      G4int layerID;
+      G4ThreeVector position;
+      G4double time;
+      G4LorentzVector p4;  // at the first step in the plane
+      G4double edep;       // summed over the plane
+      G4int index;         // along the track, in time order
+    };
+
+    ActsOutput() = default;
+
+    void SetEnabled(G4bool val) { fEnabled = val; }
+    G4bool IsEnabled() const { return fEnabled; }
+    // cache the pixel centres of the current geometry
+    void BeginOfRun();
+
+    // start a new event, the capacity is kept
+    void Clear();
+    // the plane crossings of the pixels of the last PixelAccumulator::Reduce()
+    void AddSimHits(const std::vector<PixelAccumulator::Pixel>& pixels, const PixelAccumulator& accumulator);
+    // sorted by track, then plane
+    const std::vector<SimHit>& GetSimHits() const { return fSimHits; }
+    // index of the hit of a track on a plane, -1 if it has none
+    G4int FindSimHit(G4int trackID, G4int layerID) const;
+
+    // barcodes of the primaries and of the tracks with hits of the event
+    void AssignBarcodes(const G4Event* event, const TrackTable& tracks);
+    // their track IDs, in barcode order
+    const std::vector<G4int>& GetParticles() const { return fParticles; }
+    // invalid (0) for tracks without a barcode
+    ActsFatras::Barcode GetBarcode(G4int trackID) const
+    {
+      return ActsFatras::Barcode(
+        (trackID > 0 && static_cast<std::size_t>(trackID) < fBarcodes.size()) ? fBarcodes[trackID] : 0u);
+    }
+    // invalid (0) when the vertex or index is beyond the range of its level
+    static ActsFatras::Barcode PrimaryBarcode(G4int vertex, G4int index);
+
+    // measurement of a fired pixel: its centre in the plane and the
+    // variance of a uniform distribution over the pixel
+    G4double GetPixelX(G4int rowID) const { return fPixelX[rowID]; }
+    G4double GetPixelY(G4int colID) const { return fPixelY[colID]; }
+    G4double GetVarianceX() const { return fVarianceX; }
+    G4double GetVarianceY() const { return fVarianceY; }
+
+  private:
+    void WarnBarcodeOverflow();
+
+    struct Deposit {
+      G4int trackID;
+      G4int layerID;
+      G4double edep;
+      const PixelAccumulator::Payload* payload;
+    };
+    struct Secondary {
+      G4int ancestorID;
+      G4int generation;
+      G4int trackID;
+    };
+
+    G4bool fEnabled = false;
+    std::vector<G4double> fPixelX;
+    std::vector<G4double> fPixelY;
+    G4double fVarianceX = 0.;
+    G4double fVarianceY = 0.;
+
+    std::vector<SimHit> fSimHits;
+    std::vector<G4int> fParticles;
+    std::vector<std::uint64_t> fBarcodes;  // by track ID
+    G4bool fBarcodeWarned = false;
+
+    // scratch buffers, reused between events
+    std::vector<Deposit> fDeposits;
+    std::vector<Secondary> fSecondaries;
+    std::vector<std::uint32_t> fOrder;
+};
+
+#endif
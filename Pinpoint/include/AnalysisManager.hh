@@ -4,8 +4,11 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <memory>
+#include <utility>
 
 #include "G4Event.hh"
+#include "G4Threading.hh"
 #include "TFile.h"
 #include "TTree.h"
 #include "TH2F.h"
@@ -13,6 +16,12 @@
 
 #include "AnalysisManagerMessenger.hh"
 #include "FPFParticle.hh"
+#include "OutputRecord.hh"
+#include "TrackTable.hh"
+#include "TrackHitTable.hh"
+#include "ActsOutput.hh"
+
+class OutputWriter;
 
 class AnalysisManager {
   public:
@@ -33,11 +42,23 @@ class AnalysisManager {
     void setFileName(std::string val) { fFilename = val; }
     void saveTrack(G4bool val) { fSaveTrack = val; }
     void saveTruthHits(G4bool val) { fSaveTruthHits = val; }
-
-    // build TID to primary ancestor association
+    void keepWorkerFiles(G4bool val) { fKeepWorkerFiles = val; }
+    void setCompression(const G4String& algorithm, G4int level);
+    void setBasketSize(G4int val) { fBasketSize = val; }
+    void setAutoFlush(G4int val) { fAutoFlush = val; }
+    void savePackedChannel(G4bool val) { fSavePackedChannel = val; }
+    void savePixelHits(G4bool val) { fSavePixelHits = val; }
+    void setAsyncQueueDepth(G4int val) { fAsyncQueueDepth = val; }
+    void saveActs(G4bool val) { fSaveActs = val; }
+
+    // track ID to primary ancestor and origin flags
     // filled progressively from StackingAction
-    void SetTrackPrimaryAncestor(G4int trackID, G4int ancestorID) { trackToPrimaryAncestor[trackID] = ancestorID; }
-    G4int GetTrackPrimaryAncestor(G4int trackID) { return trackToPrimaryAncestor.at(trackID); }
+    TrackTable& GetTrackTable() { return fTrackTable; }
+    G4int GetTrackPrimaryAncestor(G4int trackID) const { return fTrackTable.GetPrimaryAncestor(trackID); }
+    // track to pixel hit links, built by PixelSD at the end of the event
+    TrackHitTable& GetTrackHitTable() { return fTrackHitTable; }
+    // ACTS simulated hits (PixelSD) and barcodes
+    ActsOutput& GetActsOutput() { return fActsOutput; }
 
     // TODO: needed???
     void AddOnePrimaryTrack() { nTestNPrimaryTrack++; }
@@ -53,6 +74,10 @@ class AnalysisManager {
     void bookGeomTree();
     void bookHitsTrees();
     void bookScintTrees();
+    void bookDigiTree();
+    void bookClusterTree();
+    void bookPerfTree();
+    void bookActsTrees();
 
     void FillEventTree(const G4Event* event);
     void FillPrimariesTree(const G4Event* event);
@@ -60,14 +85,55 @@ class AnalysisManager {
     void FillGeomTree();
     void FillHitsOutput();
     void FillScintOutput();
+    void FillDigiOutput(const G4Event* event);
+    void FillClusterOutput();
+    void FillActsOutput();
+
+    // fill the trees from one event's record, on the writer thread if async
+    void WriteRecord(OutputRecord& record);
     
+    // apply the /out/basketSize and /out/autoFlush settings to a booked tree
+    void ConfigureTree(TTree* tree);
+
     float_t GetTotalEnergy(float_t px, float_t py, float_t pz, float_t m);
 
-    static AnalysisManager* fInstance;
+    // output file written by this thread: the configured name in sequential
+    // mode, a per-worker variant (e.g. out_t3.root) in MT mode
+    std::string GetThreadFileName() const;
+
+    // MT only: merge the per-worker files into fFilename on the master and
+    // append the geometry tree, which only the master writes
+    void MergeWorkerFiles();
+
+    // one instance per thread: workers never share trees or buffers
+    static G4ThreadLocal AnalysisManager* fInstance;
     AnalysisManagerMessenger* fMessenger{nullptr};
 
+    // files closed by the workers during this run with their thread IDs,
+    // consumed by MergeWorkerFiles
+    using WorkerFile = std::pair<G4int, std::string>;
+    static std::vector<WorkerFile> fWorkerFiles;
+    static G4Mutex fWorkerFilesMutex;
+
     G4bool fSaveTrack;
     G4bool fSaveTruthHits;
+    G4bool fKeepWorkerFiles;
+    G4bool fSavePackedChannel;
+    G4bool fSavePixelHits;
+    G4bool fSaveActs;
+
+    // ROOT I/O tuning: -1 (compression) and 0 (basket size, auto-flush)
+    // keep the ROOT defaults
+    G4int fCompression;
+    G4int fBasketSize;
+    G4int fAutoFlush;
+
+    // > 0: fill the trees on a writer thread with this many events in flight
+    G4int fAsyncQueueDepth;
+    std::unique_ptr<OutputWriter> fWriter;
+
+    // record of the event being processed
+    std::unique_ptr<OutputRecord> fRecord;
     
     std::map<int, std::string> fSDNamelist;
 
@@ -90,9 +156,22 @@ class AnalysisManager {
     TTree*   fPixelHitsTree;
 
     TTree* fScintTree = nullptr;
-
-    // track to primary ancestor
-    std::map<G4int, G4int> trackToPrimaryAncestor;
+    TTree* fPixelDigiTree = nullptr;
+    G4bool fSaveDigis = false;
+    TTree* fPixelClusterTree = nullptr;
+    G4bool fSaveClusters = false;
+    TTree* fPerf = nullptr;
+    G4bool fSavePerf = false;
+
+    TDirectory* fActsDir = nullptr;
+    TTree* fActsParticlesTree = nullptr;
+    TTree* fActsHitsTree = nullptr;
+    TTree* fActsMeasurementsTree = nullptr;
+
+    // track to primary ancestor and origin flags
+    TrackTable fTrackTable;
+    TrackHitTable fTrackHitTable;
+    ActsOutput fActsOutput;
 
     // TODO: no longer needed?
     G4int nTestNPrimaryTrack;
@@ -101,60 +180,11 @@ class AnalysisManager {
     // OUTPUT VARIABLES FOR COMMON TREES
 
     G4int evtID;
-    G4int vertexID;
-    double weight;
-    std::string genType;
-    std::string processName;    
-    int initPDG;           
-    double initX, initY, initZ, initT;
-    double initPx, initPy, initPz, initE;
-    double initM;     
-    double initQ;    
-    int intType;           
-    int scatteringType;    
-    int fslPDG;           
-    int tgtPDG;     
-    int tgtA;      
-    int tgtZ;      
-    int hitnucPDG; 
-    double xs;
-    double Q2;  
-    double xBj; 
-    double y;   
-    double W;  
- 
-    //---------------------------------------------------
-    // Output variables for TRAJECTORIES tree
-    int trackTID;
-    int trackPID;
-    int trackPDG;
-    double trackKinE;
-    int trackNPoints;
-    std::vector<double> trackPointX;
-    std::vector<double> trackPointY;
-    std::vector<double> trackPointZ;
-
-    //---------------------------------------------------
-    // Output variables for PRIMARIES tree
-    UInt_t primVtxID;
-    UInt_t primParticleID;
-    UInt_t primTrackID;
-    UInt_t primPDG; // why unsigned?
-    float_t primM;
-    float_t primQ;
-    float_t primEta;
-    float_t primPhi;
-    float_t primPt;
-    float_t primP;
-    float_t primVx;
-    float_t primVy;
-    float_t primVz;
-    float_t primVt;
-    float_t primPx;
-    float_t primPy;
-    float_t primPz;
-    float_t primE;
-    float_t primKE;
+    // branch buffers, only touched by WriteRecord (see OutputRecord.hh)
+    G4int fOutEvtID;
+    EventRow fEvtRow;
+    PrimaryRow fPrimRow;
+    TrajectoryRow fTrkRow;
 
     //---------------------------------------------------
     // Output variables for GEOMETRY tree
@@ -165,46 +195,24 @@ class AnalysisManager {
     Int_t nLayers;
     Int_t simFlag;
     Int_t scintBarFlag;
+    ULong64_t geometryFingerprint;
     std::vector<double_t> pixelsXPos;
     std::vector<double_t> pixelsYPos;
     std::vector<double_t> pixelsZPos;
 
     //---------------------------------------------------
-    // OUTPUT VARIABLES FOR Hits TREES
-
-    //* Reco space points
-    UInt_t fPixelEventID;
-    std::vector<UInt_t> fPixelRowIDs;
-    std::vector<UInt_t> fPixelColIDs;
-    std::vector<UInt_t> fPixelLayerIDs;
-    std::vector<UInt_t> fPixelPDGCs;
-    std::vector<UInt_t> fPixelTrackIDs;
-    std::vector<UInt_t> fPixelParentIDs;
-    std::vector<Float_t> fPixelPxs;
-    std::vector<Float_t> fPixelPys;
-    std::vector<Float_t> fPixelPzs;
-    std::vector<Float_t> fPixelEnergies;
-    std::vector<Float_t> fPixelCharges;
-    std::vector<Float_t> fPixelEDep;
-    // std::vector<G4bool> fPixelFromPrimaryPizero;
-    // std::vector<G4bool> fPixelFromFSLPizero;
-    std::vector<G4bool> fPixelFromPrimaryLepton;
-
-    // Truth position of hit in x, y, z
-    std::vector<Float_t> fPixelTruthX;
-    std::vector<Float_t> fPixelTruthY;
-    std::vector<Float_t> fPixelTruthZ;
-
-    //----------------------------------------------------
-    //OUTPUT VARIABLES FOR SCINTILLATOR
-    UInt_t fScintEventID;
-    std::vector<int> fScintLayerID;
-    std::vector<int> fScintTrackID;
-    std::vector<int> fScintParentID;
-    std::vector<int> fScintPDG;
-    std::vector<float> fScintEdep;
-    std::vector<int> fScintFromMuon;
-    std::vector<int> fScintFromPrimaryLepton;
+    // OUTPUT VARIABLES FOR Hits TREES (branch buffers)
+    PixelHitsRow fPixelHitsRow;
+    ScintHitsRow fScintRow;
+    PixelDigisRow fDigiRow;
+    PixelClustersRow fClusterRow;
+    ActsParticlesRow fActsParticlesRow;
+    ActsHitRow fActsHitRow;
+    ActsMeasurementRow fActsMeasurementRow;
+
+    //---------------------------------------------------
+    // OUTPUT VARIABLES FOR PERF TREE (branch buffer)
+    PerfRow fPerfRow;
     
   };
 
@@ -58,6 +58,14 @@ class AnalysisManagerMessenger: public G4UImessenger
     G4UIcmdWithAString* fFileCmd;
     G4UIcmdWithABool* fSaveTrackCmd;
     G4UIcmdWithABool* fSaveTruthHitsCmd; 
+    G4UIcmdWithABool* fKeepWorkerFilesCmd;
+    G4UIcommand* fCompressionCmd;
+    G4UIcmdWithAnInteger* fBasketSizeCmd;
+    G4UIcmdWithAnInteger* fAutoFlushCmd;
+    G4UIcmdWithABool* fPackedChannelCmd;
+    G4UIcmdWithABool* fSavePixelHitsCmd;
+    G4UIcmdWithAnInteger* fAsyncQueueDepthCmd;
+    G4UIcmdWithABool* fSaveActsCmd;
 
 };
 
@@ -8,7 +8,12 @@
 #include "G4RunManager.hh"
 #include "G4OpticalSurface.hh"
 
+#include <cstdint>
+#include <map>
+
 class G4VPhysicalVolume;
+class G4ProductionCuts;
+class G4UserLimits;
 
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -48,10 +53,34 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     void SetPixelWidth(G4double width) { fPixelWidth = width; }
     void SetDetectorWidth(G4double width) { fDetectorWidth = width; }
     void SetDetectorHeight(G4double height) { fDetectorHeight = height; }
+    // startup: overlap checks, GDML export and the volume printout are
+    // opt-ins, a production run builds the geometry without any of them
     void SetCheckOverlaps(G4bool check) { fCheckOverlaps = check; }
-    void SetGDMLFile(const G4String& filename) { fWriteFile = filename; }
+    void SetGDMLFile(const G4String& filename) { fWriteFile = (filename == "none") ? "" : filename; }
+    void SetPrintVolumes(G4bool print) { fPrintVolumes = print; }
     void SetSimFlag(G4int flag) { sim_flag = flag; }
     void SetScintBarFlag(G4bool flag) { scint_bar_flag = flag; }
+    void SetAnalyticPixels(G4bool flag) { fAnalyticPixels = flag; }
+
+    // Regions: "Absorber" (tungsten plates), "PixelSilicon" (silicon layers
+    // and pixels) and "Scintillator" (scintillator panels). Production cuts
+    // and user limits set here override the defaults of the physics list in
+    // that region only; they can be changed between runs. The user limits
+    // need the G4StepLimiterPhysics constructor (-p FTFP_BERT+PY8DK+STEPLIMIT).
+    static const std::vector<G4String>& GetRegionNames();
+    // particle: gamma, e-, e+, proton or all
+    void SetRegionCut(const G4String& region, const G4String& particle, G4double cut);
+    void SetRegionMaxStep(const G4String& region, G4double maxStep);
+    void SetRegionMinEkin(const G4String& region, G4double minEkin);
+    void SetRegionMaxTime(const G4String& region, G4double maxTime);
+    void PrintRegions() const;
+
+    // Hash of every parameter the geometry is built from (not of the volumes
+    // themselves), the same across runs, threads and builds. Artifacts derived
+    // from the geometry (GDML export, shower libraries, ...) can be cached
+    // under it and reused as long as it does not change.
+    std::uint64_t GetGeometryFingerprint() const;
+    G4String GetGeometryFingerprintString() const;
 
 
     std::vector<G4double> GetPixelXPositions() const {
@@ -93,6 +122,7 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     G4double GetDetectorHeight() const { return fDetectorHeight; }
     G4double GetLayerThickness() const { return fLayerThickness; }
     G4int GetSimFlag() const {return sim_flag;}
+    G4bool GetAnalyticPixels() const { return fAnalyticPixels; }
     G4int GetScintBarFlag() const {
     if (false) {
         return 0;
@@ -106,9 +136,26 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     
 
   private:
-    G4String fWriteFile = "pinpoint.gdml";
+    struct RegionSettings {
+      std::map<G4String, G4double> cuts;  // by particle name
+      G4double maxStep = -1.;             // < 0: not set
+      G4double minEkin = -1.;
+      G4double maxTime = -1.;
+      G4ProductionCuts* productionCuts = nullptr;
+      G4UserLimits* userLimits = nullptr;
+    };
+
+    // false (with a warning) for an unknown region name
+    G4bool CheckRegionName(const G4String& region) const;
+    // push the settings to the regions, once built
+    void ApplyRegionSettings();
+    // export to fWriteFile, unless it was written for the same fingerprint
+    void WriteGDML(G4VPhysicalVolume* worldPV);
+
+    G4String fWriteFile;  // empty: no GDML export
     G4GDMLParser fParser;
-    G4LogicalVolume* fPixelLV;
+    G4LogicalVolume* fPixelLV = nullptr;
+    G4LogicalVolume* fSiliconLayerLV = nullptr;
 
     DetectorConstructionMessenger* messenger;
 
@@ -128,8 +175,11 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     G4double fLayerThickness = 0.0 * mm;
     G4int sim_flag = 0;
     G4bool scint_bar_flag = true;
+    // silicon layers are single sensitive volumes, pixels are computed in PixelSD
+    G4bool fAnalyticPixels = false;
 
-    G4bool fCheckOverlaps = true;
+    G4bool fCheckOverlaps = false;
+    G4bool fPrintVolumes = false;
 
     std::vector<G4LogicalVolume*> scintLVs;
     std::vector<G4VPhysicalVolume*> fTarget_phys;
@@ -138,6 +188,8 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     G4OpticalSurface* scintWrap;
 
     G4Material* scintillator = nullptr;
+
+    std::map<G4String, RegionSettings> fRegionSettings;
 };
 
 
@@ -9,6 +9,7 @@
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
 #include "globals.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -25,6 +26,9 @@ class DetectorConstructionMessenger: public G4UImessenger {
     void SetNewValue(G4UIcommand*, G4String);
 
   private:
+    G4UIparameter* MakeRegionParameter() const;
+    G4UIcommand* MakeRegionLimitCommand(const G4String& path, const G4String& what, const G4String& defaultUnit);
+
     DetectorConstruction* det;
     G4UIdirectory* detDir;
 
@@ -41,6 +45,18 @@ class DetectorConstructionMessenger: public G4UImessenger {
     G4UIcmdWithAString* detGdmlCmd;
     G4UIcmdWithAnInteger* simFlagCmd;
     G4UIcmdWithABool* scintBarFlagCmd;
+    G4UIcmdWithABool* analyticPixelsCmd;
+    G4UIcmdWithABool* checkOverlapsCmd;
+    G4UIcmdWithABool* printVolumesCmd;
+    G4UIcmdWithoutParameter* fingerprintCmd;
+
+    // regions
+    G4UIdirectory* regionDir;
+    G4UIcommand* regionCutCmd;
+    G4UIcommand* regionMaxStepCmd;
+    G4UIcommand* regionMinEkinCmd;
+    G4UIcommand* regionMaxTimeCmd;
+    G4UIcmdWithoutParameter* regionListCmd;
 
     // G4UIcmdWithABool* detCheckOverlapCmd;
 
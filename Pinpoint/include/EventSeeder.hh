@@ -0,0 +1,34 @@
+#ifndef EVENTSEEDER_HH
+#define EVENTSEEDER_HH
+
+#include <cstdint>
+
+#include "globals.hh"
+
+// Deterministic per-event seeding for sharded production.
+//
+// At the start of every event the random engine of the calling thread is
+// reseeded from (run seed, global event index) through splitmix64, where the
+// global index is the first event of the shard plus the Geant4 event ID. An
+// event therefore sees the same random sequence whichever shard, thread or
+// order it is simulated in, and any shard can be re-run bit for bit.
+class EventSeeder
+{
+  public:
+    // set once on the master before the run starts
+    static void SetRunSeed(G4long seed) { fRunSeed = seed; }
+    static G4long GetRunSeed() { return fRunSeed; }
+
+    // seed for the run when none is given, printed so the run can be repeated
+    static G4long MakeRunSeed();
+
+    // reseed the engine of the calling thread for this event
+    static void SeedEvent(G4long globalEventIndex);
+
+  private:
+    static std::uint64_t SplitMix64(std::uint64_t x);
+
+    static G4long fRunSeed;
+};
+
+#endif
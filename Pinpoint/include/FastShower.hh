@@ -0,0 +1,105 @@
+#ifndef FASTSHOWER_HH
+#define FASTSHOWER_HH
+
+#include <cstdint>
+#include <vector>
+
+#include "ShowerLibrary.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+class FastShowerMessenger;
+
+// Settings and run statistics of the fast shower parameterisation of the
+// tungsten absorber (FastShowerModel), configured with the /fastsim/ commands.
+//
+// When enabled, electrons, positrons and photons created or entering deep
+// inside a tungsten plate (isotropic safety above a minimum) with a kinetic
+// energy inside [min, max] are killed. Their energy is deposited directly
+// as hits in the pixels of the downstream silicon layers, following a
+// parameterised longitudinal and radial shower profile.
+//
+// The model and the fast simulation process of e-, e+ and photons are only
+// built when Pinpoint is started with --fastsim; without it the /fastsim/
+// settings have no effect.
+//
+// In validation mode nothing is killed. The tracks the model would have
+// taken are simulated in full and tagged in the TrackTable, together with
+// their descendants. The parameterised hits of the same tracks are computed
+// on the side. At the end of each event PixelSD reports the fired pixels of
+// both per layer, and the mean multiplicities are compared at the end of the
+// run.
+//
+// The deposits come from the analytic profile, or from a shower library
+// (ShowerLibrary) when one is loaded. The library is recorded in the same
+// way as the validation runs: the tagged tracks are simulated in full and
+// their deposits are stored as patterns. One instance per thread.
+class FastShower
+{
+  public:
+    FastShower();
+    ~FastShower();
+    static FastShower* GetInstance();
+
+    // set once on the master before the physics is built (--fastsim): only
+    // then are the fast simulation process and FastShowerModel added
+    static void SetAvailable(G4bool val) { fAvailable = val; }
+    static G4bool IsAvailable() { return fAvailable; }
+
+    // configuration (messenger)
+    void SetEnabled(G4bool val) { fEnabled = val; }
+    void SetValidate(G4bool val) { fValidate = val; }
+    void SetMinEnergy(G4double val) { fMinEnergy = val; }
+    void SetMaxEnergy(G4double val) { fMaxEnergy = val; }
+    void SetMinSafety(G4double val) { fMinSafety = val; }
+    void SetSpotEnergy(G4double val) { fSpotEnergy = val; }
+    // "none" stops the recording / unloads the library
+    void SetRecordFile(const G4String& fileName) { fRecordFile = (fileName == "none") ? "" : fileName; }
+    void LoadLibrary(const G4String& fileName);
+
+    G4bool IsEnabled() const { return fEnabled || fValidate || IsRecording(); }
+    G4bool IsValidating() const { return fValidate; }
+    G4bool IsRecording() const { return !fRecordFile.empty(); }
+    ShowerLibrary& GetLibrary() { return fLibrary; }
+    G4double GetMinEnergy() const { return fMinEnergy; }
+    G4double GetMaxEnergy() const { return fMaxEnergy; }
+    G4double GetMinSafety() const { return fMinSafety; }
+    G4double GetSpotEnergy() const { return fSpotEnergy; }
+
+    // model and sensitive detector hooks
+    void CountShower(G4double energy) { ++fNShowers; fShowerEnergy += energy; }
+    // fired pixels (packed PixelChannel values, duplicates allowed) of the
+    // tagged tracks in full simulation and of their parameterised showers
+    void AddValidationEvent(std::vector<std::uint64_t>& fullPixels, std::vector<std::uint64_t>& fastPixels);
+    void CountLibraryShower() { ++fNLibraryShowers; }
+
+    void BeginOfRun();
+    void EndOfRun();
+
+  private:
+    static G4ThreadLocal FastShower* fInstance;
+    static G4bool fAvailable;
+    FastShowerMessenger* fMessenger{nullptr};
+
+    G4bool fEnabled = false;
+    G4bool fValidate = false;
+    G4double fMinEnergy = 20 * MeV;
+    G4double fMaxEnergy = 1 * GeV;
+    G4double fMinSafety = 1 * mm;
+    G4double fSpotEnergy = 15 * keV;
+    G4String fRecordFile;
+    ShowerLibrary fLibrary;
+
+    // run totals
+    G4long fNShowers = 0;
+    G4double fShowerEnergy = 0.;
+    G4long fNLibraryShowers = 0;
+    G4int fNValidationEvents = 0;
+    // fired pixels summed over events, per layer
+    std::vector<G4long> fFullPixelsPerLayer;
+    std::vector<G4long> fFastPixelsPerLayer;
+};
+
+#endif
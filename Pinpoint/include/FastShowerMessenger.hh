@@ -0,0 +1,42 @@
+#ifndef FastShowerMessenger_h
+#define FastShowerMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class FastShower;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+class FastShowerMessenger: public G4UImessenger
+{
+  public:
+
+    FastShowerMessenger(FastShower* );
+    ~FastShowerMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+
+  private:
+
+    FastShower* fFastShower;
+
+    G4UIdirectory* fFastSimDir;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithABool* fValidateCmd;
+    G4UIcmdWithADoubleAndUnit* fMinEnergyCmd;
+    G4UIcmdWithADoubleAndUnit* fMaxEnergyCmd;
+    G4UIcmdWithADoubleAndUnit* fMinSafetyCmd;
+    G4UIcmdWithADoubleAndUnit* fSpotEnergyCmd;
+
+    G4UIdirectory* fLibraryDir;
+    G4UIcmdWithAString* fRecordCmd;
+    G4UIcmdWithAString* fLoadCmd;
+    G4UIcmdWithAnInteger* fEnergyBinsCmd;
+    G4UIcmdWithAnInteger* fAngleBinsCmd;
+};
+
+#endif
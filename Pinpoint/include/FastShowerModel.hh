@@ -0,0 +1,63 @@
+#ifndef FASTSHOWERMODEL_HH
+#define FASTSHOWERMODEL_HH
+
+#include "G4VFastSimulationModel.hh"
+#include "G4ThreeVector.hh"
+#include "ShowerLibrary.hh"
+
+#include <vector>
+
+class G4FastSimHitMaker;
+class G4Navigator;
+class G4Region;
+class FastShower;
+class TrackTable;
+
+// Fast shower parameterisation attached to the Absorber region, configured
+// through FastShower (/fastsim/). One instance per thread, built with the
+// sensitive detectors.
+//
+// From the point where a triggering e-, e+ or photon is taken over, the
+// shower axis is followed through the geometry and the depth is counted in
+// radiation lengths of the materials crossed. Each silicon layer crossed
+// gets the energy of a gamma-distributed longitudinal profile over its depth
+// interval:
+//   dE/dt = E b^a t^(a-1) exp(-bt) / Gamma(a), b = 0.5, a = b tmax + 1,
+//   tmax = ln(E/Ec) -0.5 (e+-) or +0.5 (photon)
+// The energy is split into spots of about a MIP deposit, spread around the
+// axis with a two-component radial profile (core and Moliere radius of the
+// plate). With a shower library loaded, a recorded pattern of the bin of
+// the particle replaces the profile. The spots are given to the pixel SD as
+// G4FastHits, so they are read out like the steps of the full simulation.
+class FastShowerModel : public G4VFastSimulationModel
+{
+  public:
+    FastShowerModel(const G4String& name, G4Region* envelope);
+    ~FastShowerModel() override;
+
+    G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+    G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+    void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+
+  private:
+    // depth of the shower maximum in X0, and the critical energy of the plate
+    G4double ShowerMaximum(const G4Track* track, G4double& criticalEnergy) const;
+    // silicon layers crossed by the shower axis up to the depth (X0), into fCrossings
+    void FindCrossings(const G4Track* track, G4double depth);
+    // parameterised hits of the shower of the track
+    void Deposit(const G4FastTrack& fastTrack);
+    // hits of a library pattern, false when the library has none for the track
+    G4bool DepositFromLibrary(const G4FastTrack& fastTrack);
+    void DepositInSilicon(const G4FastTrack& fastTrack, const G4ThreeVector& centre,
+                          const G4ThreeVector& axis, G4double energy, G4double moliereRadius);
+
+    FastShower* fConfig;
+    TrackTable* fTrackTable;
+    G4FastSimHitMaker* fHitMaker;
+    // private navigator, the tracking one must not be moved
+    G4Navigator* fNavigator;
+    const G4Region* fSiliconRegion = nullptr;
+    std::vector<ShowerLibrary::Crossing> fCrossings;
+};
+
+#endif
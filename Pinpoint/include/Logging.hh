@@ -0,0 +1,49 @@
+#ifndef LOGGING_HH
+#define LOGGING_HH
+
+#include <atomic>
+
+#include "globals.hh"
+#include "G4ios.hh"
+
+// Verbosity levelled logging.
+//
+// Messages above the compile-time maximum (PINPOINT_LOG_MAX_LEVEL, set from
+// CMake) are removed by the compiler; the others are filtered at run time
+// against the level chosen with /log/level. The message expression is only
+// evaluated when the message is printed, so a disabled message costs one
+// relaxed atomic load, or nothing when compiled out:
+//
+//   LOG_DEBUG("Filling " << nHits << " hits");
+
+#ifndef PINPOINT_LOG_MAX_LEVEL
+#define PINPOINT_LOG_MAX_LEVEL 3
+#endif
+
+namespace Logging {
+
+  enum Level { kError = 0, kWarning = 1, kInfo = 2, kDebug = 3 };
+
+  // run-time level, shared by all threads
+  extern std::atomic<int> gLevel;
+
+  inline void SetLevel(int level) { gLevel.store(level, std::memory_order_relaxed); }
+  inline int GetLevel() { return gLevel.load(std::memory_order_relaxed); }
+
+  constexpr bool IsCompiled(int level) { return level <= PINPOINT_LOG_MAX_LEVEL; }
+  inline bool IsEnabled(int level) { return IsCompiled(level) && level <= GetLevel(); }
+
+  // "error", "warning", "info", "debug" or a number, -1 if not recognised
+  int ParseLevel(const G4String& name);
+
+}  // namespace Logging
+
+#define PINPOINT_LOG(level, stream, msg) \
+  do { if (Logging::IsEnabled(level)) { stream << msg << G4endl; } } while (false)
+
+#define LOG_ERROR(msg)   PINPOINT_LOG(Logging::kError, G4cerr, msg)
+#define LOG_WARNING(msg) PINPOINT_LOG(Logging::kWarning, G4cout, "WARNING: " << msg)
+#define LOG_INFO(msg)    PINPOINT_LOG(Logging::kInfo, G4cout, msg)
+#define LOG_DEBUG(msg)   PINPOINT_LOG(Logging::kDebug, G4cout, msg)
+
+#endif
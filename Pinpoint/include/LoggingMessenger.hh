@@ -0,0 +1,29 @@
+#ifndef LoggingMessenger_h
+#define LoggingMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+// /log/ commands: the logging level and the progress report interval are
+// global, so the commands live on the master only and are not broadcast
+class LoggingMessenger: public G4UImessenger
+{
+  public:
+
+    LoggingMessenger();
+    ~LoggingMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+
+  private:
+
+    G4UIdirectory* fLogDir;
+    G4UIcmdWithAString* fLevelCmd;
+    G4UIcmdWithAnInteger* fProgressCmd;
+};
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef OUTPUTRECORD_HH
+#define OUTPUTRECORD_HH
+
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "Rtypes.h"
+#include "globals.hh"
+#include "PerfMonitor.hh"
+
+// Flattened output of one event.
+//
+// Filled on the event loop thread by AnalysisManager::EndOfEvent and written
+// to the trees by AnalysisManager::WriteRecord, either right away or on the
+// OutputWriter thread. The row structs also serve as the branch buffers of
+// the output trees: a row is swapped into the buffer before each Fill().
+
+// event tree: one row per generator vertex
+struct EventRow {
+  G4int vertexID;
+  double weight;
+  std::string genType;
+  std::string processName;
+  int initPDG;
+  double initX, initY, initZ, initT;
+  double initPx, initPy, initPz, initE;
+  double initM;
+  double initQ;
+  int intType;
+  int scatteringType;
+  int fslPDG;
+  int tgtPDG;
+  int tgtA;
+  int tgtZ;
+  int hitnucPDG;
+  double xs;
+  double Q2;
+  double xBj;
+  double y;
+  double W;
+};
+
+// primaries tree: one row per primary particle
+struct PrimaryRow {
+  UInt_t primVtxID;
+  ULong64_t primParticleID;  // barcode, see ActsOutput
+  UInt_t primTrackID;
+  UInt_t primPDG; // why unsigned?
+  float_t primM;
+  float_t primQ;
+  float_t primEta;
+  float_t primPhi;
+  float_t primPt;
+  float_t primP;
+  float_t primVx;
+  float_t primVy;
+  float_t primVz;
+  float_t primVt;
+  float_t primPx;
+  float_t primPy;
+  float_t primPz;
+  float_t primE;
+  float_t primKE;
+};
+
+// trajectories tree: one row per stored trajectory
+struct TrajectoryRow {
+  int trackTID;
+  int trackPID;
+  int trackPDG;
+  double trackKinE;
+  int trackNPoints;
+  std::vector<double> trackPointX;
+  std::vector<double> trackPointY;
+  std::vector<double> trackPointZ;
+};
+
+// Hits/pixelHits: one row per event
+struct PixelHitsRow {
+  UInt_t eventID;
+  std::vector<UInt_t> rowIDs;
+  std::vector<UInt_t> colIDs;
+  std::vector<UInt_t> layerIDs;
+  std::vector<ULong64_t> channels;  // packed (layer, row, col), see reco/PixelChannel.hh
+  std::vector<UInt_t> pdgCodes;
+  std::vector<UInt_t> trackIDs;
+  std::vector<UInt_t> parentIDs;
+  std::vector<Float_t> pxs;
+  std::vector<Float_t> pys;
+  std::vector<Float_t> pzs;
+  std::vector<Float_t> energies;
+  std::vector<Float_t> charges;
+  std::vector<Float_t> edeps;
+  std::vector<G4bool> fromPrimaryLepton;
+
+  // Truth position of hit in x, y, z
+  std::vector<Float_t> truthX;
+  std::vector<Float_t> truthY;
+  std::vector<Float_t> truthZ;
+
+  // track to hit links (CSR), see TrackHitTable
+  std::vector<UInt_t> trackHitOffsets;
+  std::vector<UInt_t> trackHitIndices;
+
+  // barcode of the track of the hit, with /out/saveActs
+  std::vector<ULong64_t> barcodes;
+
+  void clear()
+  {
+    rowIDs.clear(); colIDs.clear(); layerIDs.clear(); channels.clear();
+    pdgCodes.clear(); trackIDs.clear(); parentIDs.clear();
+    pxs.clear(); pys.clear(); pzs.clear(); energies.clear(); charges.clear(); edeps.clear();
+    fromPrimaryLepton.clear();
+    truthX.clear(); truthY.clear(); truthZ.clear();
+    trackHitOffsets.clear(); trackHitIndices.clear();
+    barcodes.clear();
+  }
+};
+
+// Hits/scintHits: one row per event
+struct ScintHitsRow {
+  UInt_t eventID;
+  std::vector<int> layerID;
+  std::vector<int> trackID;
+  std::vector<int> parentID;
+  std::vector<int> pdg;
+  std::vector<float> edep;
+  std::vector<int> fromMuon;
+  std::vector<int> fromPrimaryLepton;
+
+  void clear()
+  {
+    layerID.clear(); trackID.clear(); parentID.clear(); pdg.clear();
+    edep.clear(); fromMuon.clear(); fromPrimaryLepton.clear();
+  }
+};
+
+// Hits/pixelDigis: one row per event
+struct PixelDigisRow {
+  UInt_t eventID;
+  std::vector<UInt_t> layerIDs;
+  std::vector<UInt_t> rowIDs;
+  std::vector<UInt_t> colIDs;
+  std::vector<Float_t> charges;
+  std::vector<UShort_t> tots;
+  std::vector<Int_t> trackIDs;
+
+  void clear()
+  {
+    layerIDs.clear(); rowIDs.clear(); colIDs.clear();
+    charges.clear(); tots.clear(); trackIDs.clear();
+  }
+};
+
+// Hits/pixelClusters: one row per event [x, y, z in mm, edep in MeV]
+struct PixelClustersRow {
+  UInt_t eventID;
+  std::vector<UInt_t> layerIDs;
+  std::vector<Float_t> xs;
+  std::vector<Float_t> ys;
+  std::vector<Float_t> zs;
+  std::vector<UInt_t> sizes;
+  std::vector<Float_t> edeps;
+  std::vector<Int_t> trackIDs;
+
+  void clear()
+  {
+    layerIDs.clear(); xs.clear(); ys.clear(); zs.clear();
+    sizes.clear(); edeps.clear(); trackIDs.clear();
+  }
+};
+
+// acts/particles: one row per event, layout of the ACTS RootParticleWriter
+// [mm, ns, GeV, e]
+struct ActsParticlesRow {
+  UInt_t eventID;
+  std::vector<ULong64_t> particleID;
+  std::vector<Int_t> particleType;
+  std::vector<UInt_t> process;
+  std::vector<Float_t> vx, vy, vz, vt;
+  std::vector<Float_t> px, py, pz;
+  std::vector<Float_t> m, q;
+  std::vector<Float_t> eta, phi, pt, p;
+  std::vector<UInt_t> vertexPrimary, vertexSecondary, particle, generation, subParticle;
+
+  void clear()
+  {
+    particleID.clear(); particleType.clear(); process.clear();
+    vx.clear(); vy.clear(); vz.clear(); vt.clear();
+    px.clear(); py.clear(); pz.clear();
+    m.clear(); q.clear();
+    eta.clear(); phi.clear(); pt.clear(); p.clear();
+    vertexPrimary.clear(); vertexSecondary.clear(); particle.clear(); generation.clear(); subParticle.clear();
+  }
+};
+
+// acts/hits: one row per simulated hit, layout of the ACTS RootSimHitWriter
+// [mm, ns, GeV]
+struct ActsHitRow {
+  UInt_t eventID;
+  ULong64_t geometryID;
+  ULong64_t particleID;
+  Float_t tx, ty, tz, tt;
+  Float_t tpx, tpy, tpz, te;
+  Float_t deltapx, deltapy, deltapz, deltae;
+  Int_t index;
+  UInt_t volumeID, boundaryID, layerID, approachID, sensitiveID;
+};
+
+// acts/measurements: one row per pixel hit, columns of the ACTS measurement
+// CSV format plus the pixel and its truth [mm, ns]
+struct ActsMeasurementRow {
+  UInt_t eventID;
+  ULong64_t measurementID;
+  ULong64_t geometryID;
+  UInt_t localKey;  // bit mask of the measured parameters
+  Float_t local0, local1, phi, theta, time;
+  Float_t varLocal0, varLocal1, varPhi, varTheta, varTime;
+  ULong64_t channel;  // see reco/PixelChannel.hh
+  UInt_t channelLoc0, channelLoc1;
+  Int_t hitID;  // entry of the simulated hit in the event, -1 if none
+  ULong64_t particleID;
+};
+
+struct OutputRecord {
+  G4int evtID = 0;
+  std::vector<EventRow> events;
+  std::vector<PrimaryRow> primaries;
+  std::vector<TrajectoryRow> trajectories;
+
+  // the hits trees are only filled for events with a hits collection
+  G4bool hasHits = false;
+  PixelHitsRow pixelHits;
+  ScintHitsRow scintHits;
+  PixelDigisRow pixelDigis;
+  PixelClustersRow pixelClusters;
+
+  // ACTS output, only filled with /out/saveActs
+  ActsParticlesRow actsParticles;
+  std::vector<ActsHitRow> actsHits;
+  std::vector<ActsMeasurementRow> actsMeasurements;
+
+  // perf tree, only filled with /perf/enable
+  PerfRow perf;
+
+  // reset for reuse, keeping the allocated capacity
+  void clear()
+  {
+    evtID = 0;
+    events.clear();
+    primaries.clear();
+    trajectories.clear();
+    hasHits = false;
+    pixelHits.clear();
+    scintHits.clear();
+    pixelDigis.clear();
+    pixelClusters.clear();
+    actsParticles.clear();
+    actsHits.clear();
+    actsMeasurements.clear();
+  }
+};
+
+#endif
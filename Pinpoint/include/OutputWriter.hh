@@ -0,0 +1,63 @@
+#ifndef OUTPUTWRITER_HH
+#define OUTPUTWRITER_HH
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "OutputRecord.hh"
+
+// Hands the per-event output records to a dedicated thread.
+//
+// The event loop thread pushes each finished OutputRecord by move into a
+// bounded queue and continues tracking; the writer thread pops the records
+// in order and passes them to the write function (the TTree fills and the
+// compression of full baskets). When the queue is full Push() blocks until
+// the writer catches up, which bounds the memory held by pending events.
+// Written records are recycled through Acquire() so their vectors keep
+// their capacity from one event to the next.
+class OutputWriter
+{
+  public:
+    using WriteFunction = std::function<void(OutputRecord&)>;
+
+    OutputWriter(std::size_t queueDepth, WriteFunction write);
+    ~OutputWriter();
+
+    // an empty record, reused from an already written event if possible
+    std::unique_ptr<OutputRecord> Acquire();
+
+    // queue a record for writing, blocks while the queue is full
+    void Push(std::unique_ptr<OutputRecord> record);
+
+    // write all queued records and join the writer thread
+    void Stop();
+
+    // number of records pushed, and how many of them found the queue full
+    std::size_t GetNumberOfRecords() const { return fNRecords; }
+    std::size_t GetNumberOfFullQueue() const { return fNFullQueue; }
+
+  private:
+    void Run();
+
+    const std::size_t fQueueDepth;
+    WriteFunction fWrite;
+
+    std::mutex fMutex;
+    std::condition_variable fNotEmpty;
+    std::condition_variable fNotFull;
+    std::deque<std::unique_ptr<OutputRecord>> fQueue;
+    std::deque<std::unique_ptr<OutputRecord>> fFree;
+    bool fStop = false;
+
+    std::size_t fNRecords = 0;
+    std::size_t fNFullQueue = 0;
+
+    std::thread fThread;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef PERFMONITOR_HH
+#define PERFMONITOR_HH
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+#include "G4Threading.hh"
+#include "Rtypes.h"
+#include "globals.hh"
+
+class G4Step;
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class PerfMonitorMessenger;
+
+// Per-event performance counters, one row of the perf tree
+struct PerfRow {
+  // volume categories and sensitive detectors the counters are split by
+  enum VolumeCategory { kTungsten, kSilicon, kScintillator, kOther, kNVolumeCategories };
+  enum Detector { kPixelSD, kScintSD, kNDetectors };
+
+  G4double wallTime;   // s, BeginOfEventAction to end of digitization
+  G4double cpuTime;    // s, CPU time of this thread over the same interval
+  ULong64_t nSteps;
+
+  // steps per particle species, in order of first appearance
+  std::vector<Int_t> speciesPDG;
+  std::vector<ULong64_t> speciesSteps;
+
+  // steps and wall time (s) per volume category of the pre-step point
+  ULong64_t volumeSteps[kNVolumeCategories];
+  G4double volumeTime[kNVolumeCategories];
+
+  // sensitive detector ProcessHits calls, EndOfEvent time (s) and hits in
+  // the collection (fired pixels for the pixel detector)
+  ULong64_t sdProcessHits[kNDetectors];
+  G4double sdEndOfEventTime[kNDetectors];
+  ULong64_t sdHits[kNDetectors];
+};
+
+// Opt-in instrumentation of the event loop, enabled with /perf/enable.
+//
+// One instance per thread. The stepping action reports every step, which
+// is attributed to the particle species and to the volume category of the
+// pre-step point; the time since the previous step is charged to the same
+// category. The counters of an event are written to the perf tree by the
+// AnalysisManager, next to the event tree, and summed for an end of run
+// summary. When disabled every hook returns right away.
+class PerfMonitor
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    PerfMonitor();
+    ~PerfMonitor();
+    static PerfMonitor* GetInstance();
+
+    void SetEnabled(G4bool val) { fEnabled = val; }
+    G4bool IsEnabled() const { return fEnabled; }
+
+    void BeginOfRun();
+    void EndOfRun();
+    void BeginOfEvent();
+    void EndOfEvent();
+
+    void RecordStep(const G4Step* step);
+    void CountProcessHits(PerfRow::Detector detector) { if (fEnabled) ++fRow.sdProcessHits[detector]; }
+    void CountHits(PerfRow::Detector detector, std::size_t nHits) { if (fEnabled) fRow.sdHits[detector] = nHits; }
+
+    // counters of the last finished event
+    const PerfRow& GetRow() const { return fRow; }
+
+    // CPU time (s) of the calling thread
+    static G4double ThreadCPUTime();
+
+    // times the enclosing scope as a sensitive detector's EndOfEvent
+    class SDTimer {
+      public:
+        SDTimer(PerfMonitor* monitor, PerfRow::Detector detector);
+        ~SDTimer();
+      private:
+        PerfMonitor* fMonitor;
+        PerfRow::Detector fDetector;
+        Clock::time_point fStart;
+    };
+
+  private:
+    static PerfRow::VolumeCategory Categorize(const G4LogicalVolume* volume);
+
+    static G4ThreadLocal PerfMonitor* fInstance;
+    PerfMonitorMessenger* fMessenger{nullptr};
+
+    G4bool fEnabled = false;
+    PerfRow fRow{};
+
+    Clock::time_point fEventStart;
+    Clock::time_point fLastStep;
+    G4double fEventCPUStart = 0.;
+
+    // lookups are cached for the previous step, consecutive steps mostly
+    // belong to the same track and volume
+    std::vector<const G4ParticleDefinition*> fSpeciesDefinitions;
+    const G4ParticleDefinition* fLastDefinition = nullptr;
+    std::size_t fLastSpecies = 0;
+    std::unordered_map<const G4LogicalVolume*, PerfRow::VolumeCategory> fVolumeCategories;
+    const G4LogicalVolume* fLastVolume = nullptr;
+    PerfRow::VolumeCategory fLastCategory = PerfRow::kOther;
+
+    // run totals for the summary
+    G4int fNEvents = 0;
+    G4double fTotalWallTime = 0.;
+    G4double fTotalCPUTime = 0.;
+    ULong64_t fTotalVolumeSteps[PerfRow::kNVolumeCategories] = {};
+    G4double fTotalVolumeTime[PerfRow::kNVolumeCategories] = {};
+    ULong64_t fTotalSDHits[PerfRow::kNDetectors] = {};
+};
+
+#endif
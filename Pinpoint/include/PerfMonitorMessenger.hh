@@ -0,0 +1,28 @@
+#ifndef PerfMonitorMessenger_h
+#define PerfMonitorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PerfMonitor;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+
+class PerfMonitorMessenger: public G4UImessenger
+{
+  public:
+
+    PerfMonitorMessenger(PerfMonitor* );
+    ~PerfMonitorMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+
+  private:
+
+    PerfMonitor* fPerfMonitor;
+
+    G4UIdirectory* fPerfDir;
+    G4UIcmdWithABool* fEnableCmd;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef PixelAccumulator_hh
+#define PixelAccumulator_hh
+
+#include "globals.hh"
+#include "G4LorentzVector.hh"
+#include "G4ThreeVector.hh"
+#include "reco/MultiIndex.hh"
+
+#include <cstdint>
+#include <vector>
+
+// Per-event accumulator of pixel energy deposits, keyed by (layer, row, col, track).
+//
+// Steps are merged into an open-addressing hash table (power-of-two capacity,
+// linear probing) on a packed 64-bit pixel key and the track ID, kept as a
+// separate 32-bit field so that any Geant4 track ID fits. The hot per-step
+// data (keys, edep) lives in flat arrays; the truth payload of a (pixel, track) pair is only
+// written for the first step that creates it. Clearing is O(1): table slots
+// are tagged with an epoch and become invalid when the epoch is bumped.
+class PixelAccumulator
+{
+  public:
+    // 16 bits layer | 24 bits row | 24 bits column
+    using Key = Acts::MultiIndex<std::uint64_t, 16, 24, 24>;
+
+    // Truth information of the first step of a track in a pixel
+    struct Payload {
+      G4LorentzVector p4;
+      G4ThreeVector truthPos;
+      G4double time;  // global time at truthPos
+      G4int pdgCode;
+      G4int charge;
+      G4int parentID;
+      G4bool fromPrimaryPi0;
+      G4bool fromFSLPi0;
+      G4bool fromPrimaryLepton;
+    };
+
+    // Path of a track through a pixel w.r.t. the pixel centre: from the
+    // start of its first step in the pixel to the end of its last one
+    struct Segment {
+      G4double startX;
+      G4double startY;
+      G4double endX;
+      G4double endY;
+    };
+
+    // One fired pixel after reduction: the representative (highest energy)
+    // track and the deposit summed over all contributing tracks
+    struct Pixel {
+      G4int layerID;
+      G4int rowID;
+      G4int colID;
+      G4int trackID;
+      G4double edep;
+      G4double localX;      // energy weighted position w.r.t. the pixel centre
+      G4double localY;
+      G4bool fromMuon;
+      std::uint32_t entry;  // index of the representative's payload
+      // contributing tracks, see GetContributorTrackID
+      std::uint32_t firstContributor;
+      std::uint32_t nContributors;
+    };
+
+    explicit PixelAccumulator(std::size_t initialCapacity = 1024);
+
+    // Forget all deposits of the previous event, keeping the allocated memory
+    void Clear();
+
+    // Add the deposit of a step going from (startX, startY) to (endX, endY)
+    // w.r.t. the pixel centre. Returns the entry index of the (pixel, track)
+    // pair and sets isNew when this step created it, in which case the
+    // caller must fill the payload through GetPayload(entry).
+    std::uint32_t Add(G4int layerID, G4int rowID, G4int colID, G4int trackID, G4double edep,
+                      G4double startX, G4double startY, G4double endX, G4double endY,
+                      G4bool fromMuon, G4bool& isNew);
+
+    Payload& GetPayload(std::uint32_t entry) { return fPayloads[entry]; }
+    const Payload& GetPayload(std::uint32_t entry) const { return fPayloads[entry]; }
+
+    // Number of distinct (pixel, track) pairs seen this event
+    std::size_t GetNumberOfEntries() const { return fKeys.size(); }
+
+    // Reduce to one entry per pixel, ordered by layer, row, representative
+    // track and column (the order hits have always been written in)
+    const std::vector<Pixel>& Reduce();
+    // track ID of the i-th contributor of the pixels of the last Reduce(),
+    // for i in [firstContributor, firstContributor + nContributors)
+    G4int GetContributorTrackID(std::uint32_t i) const { return fTrackIDs[fOrder[i]]; }
+    G4double GetContributorEdep(std::uint32_t i) const { return fEdeps[fOrder[i]]; }
+    const Payload& GetContributorPayload(std::uint32_t i) const { return fPayloads[fOrder[i]]; }
+    const Segment& GetContributorSegment(std::uint32_t i) const { return fSegments[fOrder[i]]; }
+
+  private:
+    static std::uint64_t Hash(std::uint64_t key, G4int trackID);
+    void Rehash(std::size_t capacity);
+
+    // hash table: slot -> entry index, valid only if the slot epoch is current
+    std::vector<std::uint64_t> fSlotKeys;
+    std::vector<G4int> fSlotTrackIDs;
+    std::vector<std::uint32_t> fSlotEntries;
+    std::vector<std::uint32_t> fSlotEpochs;
+    std::uint32_t fEpoch = 1;
+    std::size_t fMask = 0;
+    unsigned fShift = 0;
+
+    // dense entries in insertion order (SoA: hot fields apart from payload)
+    std::vector<std::uint64_t> fKeys;
+    std::vector<G4int> fTrackIDs;
+    std::vector<G4double> fEdeps;
+    std::vector<G4double> fSumX;  // edep weighted local positions
+    std::vector<G4double> fSumY;
+    std::vector<char> fFromMuon;
+    std::vector<Segment> fSegments;
+    std::vector<Payload> fPayloads;
+
+    // reduction scratch space
+    std::vector<std::uint32_t> fOrder;
+    std::vector<Pixel> fPixels;
+};
+
+#endif
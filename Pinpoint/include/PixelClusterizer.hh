@@ -0,0 +1,85 @@
+#ifndef PIXELCLUSTERIZER_HH
+#define PIXELCLUSTERIZER_HH
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "PixelAccumulator.hh"
+
+#include "G4Threading.hh"
+#include "globals.hh"
+
+class PixelClusterizerMessenger;
+
+// Groups the fired pixels of each layer into clusters of adjacent pixels,
+// configured with the /cluster/ commands.
+//
+// Runs at the end of each event on the pixels of the PixelAccumulator, i.e.
+// on the same pixels as the pixel hits. The pixels are sorted by (layer,
+// row, column) and labelled with a union-find: each pixel is joined with its
+// left neighbour and with the neighbours in the previous row, found by a
+// pointer walking along that row. 4-connectivity joins pixels sharing an
+// edge, 8-connectivity also those sharing a corner.
+//
+// A cluster has the energy weighted centroid of its pixel centres, taken
+// from DetectorConstruction::GetPixelXPositions/YPositions/ZPositions, the
+// number of pixels, the summed deposit and the dominant truth track: the
+// track that deposited most energy over all pixels of the cluster. One
+// instance per thread.
+class PixelClusterizer
+{
+  public:
+    struct Cluster {
+      G4int layerID;
+      G4double x;  // centroid
+      G4double y;
+      G4double z;
+      G4int size;  // pixels
+      G4double edep;
+      G4int trackID;
+    };
+
+    PixelClusterizer();
+    ~PixelClusterizer();
+    static PixelClusterizer* GetInstance();
+
+    // configuration (messenger)
+    void SetEnabled(G4bool val) { fEnabled = val; }
+    // 4 or 8
+    void SetConnectivity(G4int val) { fConnectivity = val; }
+
+    G4bool IsEnabled() const { return fEnabled; }
+    G4int GetConnectivity() const { return fConnectivity; }
+
+    // cluster the pixels of the last PixelAccumulator::Reduce()
+    void Clusterize(const std::vector<PixelAccumulator::Pixel>& pixels, const PixelAccumulator& accumulator);
+    const std::vector<Cluster>& GetClusters() const { return fClusters; }
+
+    void BeginOfRun();
+
+  private:
+    std::uint32_t Find(std::uint32_t i);
+    void Join(std::uint32_t a, std::uint32_t b);
+
+    static G4ThreadLocal PixelClusterizer* fInstance;
+    PixelClusterizerMessenger* fMessenger{nullptr};
+
+    G4bool fEnabled = false;
+    G4int fConnectivity = 8;
+
+    // pixel centres of the current geometry
+    std::vector<G4double> fXPositions;
+    std::vector<G4double> fYPositions;
+    std::vector<G4double> fZPositions;
+
+    // scratch buffers, reused between events
+    std::vector<const PixelAccumulator::Pixel*> fSorted;
+    std::vector<std::uint32_t> fParent;
+    std::vector<std::uint32_t> fClusterOf;
+    std::vector<std::pair<std::uint64_t, G4double>> fTrackDeposits;  // (cluster, track), edep
+    std::vector<G4double> fBestEdep;
+    std::vector<Cluster> fClusters;
+};
+
+#endif
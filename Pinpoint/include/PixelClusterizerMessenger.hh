@@ -0,0 +1,28 @@
+#ifndef PixelClusterizerMessenger_h
+#define PixelClusterizerMessenger_h
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PixelClusterizer;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+
+
+class PixelClusterizerMessenger: public G4UImessenger
+{
+  public:
+    PixelClusterizerMessenger(PixelClusterizer*);
+    ~PixelClusterizerMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+    PixelClusterizer* fClusterizer;
+
+    G4UIdirectory* fClusterDir;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithAnInteger* fConnectivityCmd;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef fasernux_PixelDigi_hh
+#define fasernux_PixelDigi_hh
+
+#include "G4VDigi.hh"
+#include "G4TDigiCollection.hh"
+#include "G4Allocator.hh"
+#include "G4Threading.hh"
+
+// A fired pixel after digitization: collected charge above threshold and
+// its time-over-threshold, with the track that contributed most charge
+class PixelDigi : public G4VDigi
+{
+public:
+  PixelDigi() = default;
+  PixelDigi(const PixelDigi&) = default;
+  ~PixelDigi() override = default;
+
+  PixelDigi& operator=(const PixelDigi&) = default;
+  G4bool operator==(const PixelDigi&) const;
+
+  inline void* operator new(size_t);
+  inline void operator delete(void*);
+
+  void Draw() override {}
+  void Print() override;
+
+  void SetLayerID(G4int layer) { fLayerID = layer; }
+  void SetRowID(G4int row) { fRowID = row; }
+  void SetColID(G4int column) { fColID = column; }
+  void SetCharge(G4double charge) { fCharge = charge; }
+  void SetToT(G4int tot) { fToT = tot; }
+  void SetTrackID(G4int trackID) { fTrackID = trackID; }
+
+  G4int GetLayerID() const { return fLayerID; }
+  G4int GetRowID() const { return fRowID; }
+  G4int GetColID() const { return fColID; }
+  G4double GetCharge() const { return fCharge; }  // in electrons
+  G4int GetToT() const { return fToT; }           // in clock counts
+  G4int GetTrackID() const { return fTrackID; }
+
+private:
+  G4int fLayerID = -1;
+  G4int fRowID = -1;
+  G4int fColID = -1;
+  G4double fCharge = 0.0;
+  G4int fToT = 0;
+  G4int fTrackID = -1;
+};
+
+
+using PixelDigiCollection = G4TDigiCollection<PixelDigi>;
+
+extern G4ThreadLocal G4Allocator<PixelDigi>* PixelDigiAllocator;
+
+
+inline void* PixelDigi::operator new(size_t)
+{
+  if (!PixelDigiAllocator) PixelDigiAllocator = new G4Allocator<PixelDigi>;
+  return (void*)PixelDigiAllocator->MallocSingle();
+}
+
+
+inline void PixelDigi::operator delete(void* digi)
+{
+  PixelDigiAllocator->FreeSingle((PixelDigi*)digi);
+}
+
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef fasernux_PixelDigitizer_hh
+#define fasernux_PixelDigitizer_hh
+
+#include "G4VDigitizerModule.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class PixelDigitizerMessenger;
+
+// Turns the PixelHitsCollection of an event into fired pixels.
+//
+// Each hit's deposit is converted to electrons and shared with its 3x3
+// neighbourhood by lateral diffusion. The path of every contributing
+// track through the pixel (PixelHit::Segment) is split into Gaussian
+// charge clouds at most one diffusion width apart, so the charge of an
+// inclined track is integrated along its path rather than taken at one
+// point. Contributions are summed per pixel, Gaussian noise is added and
+// only pixels above threshold are kept, with a linear time-over-threshold.
+// All per-cloud work runs over flat arrays so it scales with the hit count.
+class PixelDigitizer : public G4VDigitizerModule
+{
+public:
+  PixelDigitizer(const G4String& name);
+  ~PixelDigitizer() override;
+
+  void Digitize() override;
+
+  void SetEnabled(G4bool val) { fEnabled = val; }
+  void SetThreshold(G4double val) { fThreshold = val; }
+  void SetNoise(G4double val) { fNoise = val; }
+  void SetDiffusionSigma(G4double val) { fDiffusionSigma = val; }
+  void SetToTChargePerCount(G4double val) { fToTChargePerCount = val; }
+  void SetToTMax(G4int val) { fToTMax = val; }
+
+  G4bool IsEnabled() const { return fEnabled; }
+
+private:
+  PixelDigitizerMessenger* fMessenger = nullptr;
+
+  G4bool fEnabled = false;
+  G4double fPairEnergy = 3.6 * eV;         // mean energy per e-h pair in silicon
+  G4double fThreshold = 120.;              // electrons
+  G4double fNoise = 5.;                    // electrons (ENC)
+  G4double fDiffusionSigma = 3. * um;      // lateral charge cloud width
+  G4double fToTChargePerCount = 50.;       // electrons per ToT count
+  G4int fToTMax = 255;
+
+  // scratch buffers, reused between events
+  std::vector<G4int> fCloudLayer, fCloudRow, fCloudCol, fCloudTrack;
+  std::vector<G4double> fCloudCharge, fCloudX, fCloudY;
+  std::vector<G4double> fFracX, fFracY;     // 3 sharing fractions per cloud and axis
+  std::vector<std::uint64_t> fKeys;         // (layer, row, col) of each contribution
+  std::vector<G4double> fCharges;
+  std::vector<G4int> fTracks;
+  std::vector<std::uint32_t> fOrder;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef PixelDigitizerMessenger_h
+#define PixelDigitizerMessenger_h
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PixelDigitizer;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+
+
+class PixelDigitizerMessenger: public G4UImessenger
+{
+  public:
+    PixelDigitizerMessenger(PixelDigitizer*);
+    ~PixelDigitizerMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+    PixelDigitizer* fDigitizer;
+
+    G4UIdirectory* fDigiDir;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithADouble* fThresholdCmd;
+    G4UIcmdWithADouble* fNoiseCmd;
+    G4UIcmdWithADoubleAndUnit* fDiffusionSigmaCmd;
+    G4UIcmdWithADouble* fToTChargePerCountCmd;
+    G4UIcmdWithAnInteger* fToTMaxCmd;
+};
+
+#endif
@@ -8,9 +8,22 @@
 #include "G4Threading.hh"
 #include "G4LorentzVector.hh"
 
+#include <vector>
+
 class PixelHit : public G4VHit
 {
 public:
+  // Path of one contributing track through the pixel, from its first entry
+  // to its last exit, w.r.t. the pixel centre, with the energy it deposited
+  struct Segment {
+    G4int trackID;
+    G4double edep;
+    G4double startX;
+    G4double startY;
+    G4double endX;
+    G4double endY;
+  };
+
   PixelHit() = default;
   PixelHit(const PixelHit&) = default;
   ~PixelHit() override = default;
@@ -43,6 +56,8 @@ public:
   void SetFromFSLPizero(G4bool fromFSLPizero) { fFromFSLPizero = fromFSLPizero; }
   void SetFromPrimaryLepton(G4bool fromPrimaryLepton) { fFromPrimaryLepton = fromPrimaryLepton; }
   void SetTruthHitPos(G4ThreeVector pos) { fTruthHitPos = pos; }
+  void SetLocalPos(G4double x, G4double y) { fLocalX = x; fLocalY = y; }
+  void AddSegment(const Segment& segment) { fSegments.push_back(segment); }
 
   G4int GetPDGCode() const { return fPDGCode; }
   G4int GetRowID() const { return fRowID; }
@@ -53,6 +68,11 @@ public:
   G4LorentzVector GetP4() const { return fP4; }
   G4int GetCharge() const { return fCharge; }
   G4ThreeVector GetTruthHitPos() const { return fTruthHitPos; }
+  // energy weighted deposit position w.r.t. the pixel centre (x along rows, y along columns)
+  G4double GetLocalX() const { return fLocalX; }
+  G4double GetLocalY() const { return fLocalY; }
+  // one per contributing track, only filled when the digitizer runs
+  const std::vector<Segment>& GetSegments() const { return fSegments; }
   // G4bool GetIsFromPrimary() const { return fIsFromPrimary; }
   G4double GetEnergyDeposit() const { return fEnergyDeposit; }
   G4bool GetFromMuon() const { return fFromMuon; }
@@ -77,6 +97,9 @@ private:
   G4bool fFromPrimaryPizero = false;
   G4bool fFromFSLPizero = false;
   G4ThreeVector fTruthHitPos;
+  G4double fLocalX = 0.0;
+  G4double fLocalY = 0.0;
+  std::vector<Segment> fSegments;
 
   G4double fEnergyDeposit = 0.0;
   G4bool fFromMuon = false;
@@ -2,15 +2,25 @@
 #define fasernux_PixelSD_hh
 
 #include "PixelHit.hh"
+#include "PixelAccumulator.hh"
 #include "G4VSensitiveDetector.hh"
-#include <set>
-#include <tuple>
+#include "G4VFastSimSensitiveDetector.hh"
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 
 class G4Step;
+class G4Track;
 class G4HCofThisEvent;
+class PerfMonitor;
+class StackingPolicy;
+class TrackTable;
+class TrackHitTable;
+class FastShower;
+class PixelClusterizer;
+class ActsOutput;
 
-class PixelSD : public G4VSensitiveDetector
+class PixelSD : public G4VSensitiveDetector, public G4VFastSimSensitiveDetector
 {
 public:
   PixelSD(const G4String& name, const G4String& hitsCollectionName);
@@ -18,28 +28,49 @@ public:
 
   void Initialize(G4HCofThisEvent* hitCollection) override;
   G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
+  // spots of the fast shower model, read out as a step through the point
+  G4bool ProcessHits(const G4FastHit* hit, const G4FastTrack* track, G4TouchableHistory* history) override;
   void EndOfEvent(G4HCofThisEvent* hitCollection) override;
 
-  // Static methods to track if particles come from muons
-  static void RecordMuonDescendant(G4int trackID, G4bool fromMuon);
-  static G4bool IsFromMuon(G4int trackID);
-  static void ClearMuonHistory();
-
-  // Static method to track descendants of primary lepton (trackId 1)
-  // static void RecordTrackParent(G4int trackID, G4int parentID);
-  // static G4bool IsFromPrimaryTrack(G4int trackID);
-  // static void ClearTrackHistory();
+  // Use a single solid silicon layer as sensitive volume instead of the
+  // pixel replicas; row (x) and column (y) are computed from the step position
+  // with the same numbering as the replicas
+  void SetAnalyticReadout(G4int nPixelsX, G4int nPixelsY, G4double pitchX, G4double pitchY);
 
 private:
+  // start/end: path of the deposit relative to the pixel centre; truthPos
+  // and truthTime: global position and time where the deposit starts
+  void AddDeposit(const G4Track* track, G4int layerID, G4int rowID, G4int colID, G4double edep,
+                  G4double startX, G4double startY, G4double endX, G4double endY,
+                  const G4ThreeVector& truthPos, G4double truthTime, const G4LorentzVector& p4);
+  // replica navigation puts points beyond the last pixel into the edge pixel
+  static G4int ClampPixel(G4int index, G4int nPixels) { return std::min(std::max(index, 0), nPixels - 1); }
+
   PixelHitsCollection* fHitsCollection = nullptr;
-  // Static set to track all descendants of the primary lepton (trackId 1)
-  static std::set<G4int> sPrimaryDescendants;
-  // Static set to track particles that have already hit each layer: (trackID, layerID)
-  static std::set<std::pair<G4int, G4int>> sHitParticles;
-  // Static set to track which particles come from muons
-  static std::set<G4int> sMuonDescendants;
-
-  G4long fCurrentHitId = 0;
+  PerfMonitor* fPerfMonitor = nullptr;
+  StackingPolicy* fStackingPolicy = nullptr;
+  // ancestry and origin flags of the tracks of this event
+  const TrackTable* fTrackTable = nullptr;
+  // links of every contributing track to the hits, built in EndOfEvent
+  TrackHitTable* fTrackHits = nullptr;
+  FastShower* fFastShower = nullptr;
+  PixelClusterizer* fClusterizer = nullptr;
+  // ACTS simulated hits, built in EndOfEvent with /out/saveActs
+  ActsOutput* fActsOutput = nullptr;
+
+  G4bool fAnalyticReadout = false;
+  G4int fNPixelsX = 0;
+  G4int fNPixelsY = 0;
+  G4double fPixelPitchX = 0.;
+  G4double fPixelPitchY = 0.;
+
+  // Per-instance deposit buffer: cleared every event but its capacity
+  // is kept, so steady-state events do not allocate
+  PixelAccumulator fAccumulator;
+  // fast shower validation: pixels fired by the tagged tracks in full
+  // simulation and by their parameterised showers
+  std::vector<std::uint64_t> fFullShowerPixels;
+  std::vector<std::uint64_t> fFastShowerPixels;
 };
 
 #endif
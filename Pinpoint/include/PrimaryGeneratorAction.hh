@@ -15,13 +15,20 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     
     void GeneratePrimaries(G4Event* anEvent) override;
     void SetGenerator(G4String name);
-    static void SetFirstEvent(G4int firstEvent) { fFirstEvent = firstEvent; }
+    void SetIOCacheSize(G4long bytes) { fIOCacheSize = bytes; }
+    void SetPrintIOStats(G4bool val) { fPrintIOStats = val; }
+
+    // called by the RunAction at the end of each run
+    void EndOfRun() const;
+    static void SetFirstEvent(G4long firstEvent) { fFirstEvent = firstEvent; }
 
   private:
 
     PrimaryGeneratorMessenger* fGenMessenger;
     GeneratorBase* fGenerator;
     G4bool fInitialized;
+    G4long fIOCacheSize;
+    G4bool fPrintIOStats;
 
     static G4long fFirstEvent;
 };
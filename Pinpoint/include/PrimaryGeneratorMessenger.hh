@@ -8,6 +8,8 @@
 class PrimaryGeneratorAction;
 class G4UIdirectory;
 class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -24,6 +26,8 @@ class PrimaryGeneratorMessenger: public G4UImessenger
 
     G4UIdirectory* fGeneratorDir;
     G4UIcmdWithAString* fGeneratorOption;
+    G4UIcmdWithAnInteger* fIOCacheSizeCmd;
+    G4UIcmdWithABool* fPrintIOStatsCmd;
 
 };
 
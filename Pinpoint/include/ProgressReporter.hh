@@ -0,0 +1,33 @@
+#ifndef PROGRESSREPORTER_HH
+#define PROGRESSREPORTER_HH
+
+#include <atomic>
+#include <chrono>
+
+#include "globals.hh"
+
+// Prints the run progress every N finished events, counted over all
+// threads: events done, throughput (events/s) and estimated time left.
+// Replaces following the run through the per-event printout.
+class ProgressReporter
+{
+  public:
+    // 0 disables the report
+    static void SetInterval(G4int nEvents) { fInterval.store(nEvents, std::memory_order_relaxed); }
+
+    // called once per run, before any event starts (master or sequential)
+    static void BeginOfRun(G4int nEventsToProcess);
+    // called by every thread at the end of each event
+    static void EventDone();
+    static void EndOfRun();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    static std::atomic<G4int> fInterval;
+    static std::atomic<G4long> fNDone;
+    static G4int fNTotal;
+    static Clock::time_point fStart;
+};
+
+#endif
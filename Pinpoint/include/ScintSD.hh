@@ -3,11 +3,12 @@
 
 #include "ScintHit.hh"
 #include "G4VSensitiveDetector.hh"
-#include <set>
 #include <vector>
 
 class G4Step;
 class G4HCofThisEvent;
+class PerfMonitor;
+class TrackTable;
 
 class ScintillatorSD : public G4VSensitiveDetector
 {
@@ -19,20 +20,25 @@ public:
     G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
     void EndOfEvent(G4HCofThisEvent* hitCollection) override;
 
-    // ---- Muon ancestry tracking (same as PixelSD) ----
-    static void RecordMuonDescendant(G4int trackID, G4bool fromMuon);
-    static G4bool IsFromMuon(G4int trackID);
-    static void ClearMuonHistory();
-
 private:
+    // One energy deposit of a track in a scintillator layer
+    struct ScintStep {
+        G4int layerID;
+        G4int trackID;
+        G4int pdgCode;
+        G4int parentID;
+        G4bool fromPrimaryLepton;
+        G4bool fromMuon;
+        G4double edep;
+    };
+
     ScintHitsCollection* fHitsCollection = nullptr;
+    PerfMonitor* fPerfMonitor = nullptr;
+    // ancestry and origin flags of the tracks of this event
+    const TrackTable* fTrackTable = nullptr;
 
-    // Static set to track all descendants of the primary lepton (trackId 1)
-    static std::set<G4int> sScintPrimaryDescendants;
-    // Static set to track particles that have already hit each layer: (trackID, layerID)
-    static std::set<std::pair<G4int, G4int>> sScintHitParticles;
-    // Static set to track which particles come from muons
-     static std::set<G4int> sScintMuonDescendants;
+    // Per-instance event buffers, capacity is reused between events
+    std::vector<ScintStep> fSteps;
 
     G4long fScintCurrentHitId = 0;
 };
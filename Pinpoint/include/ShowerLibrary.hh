@@ -0,0 +1,136 @@
+#ifndef SHOWERLIBRARY_HH
+#define SHOWERLIBRARY_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+// Library of silicon deposit patterns of e-, e+ and photon showers starting
+// inside a tungsten plate, for the fast shower model (FastShowerModel).
+//
+// Recording: the showers the model would take are simulated in full. Every
+// pixel deposit of a shower is stored relative to its axis: the index of
+// the silicon layer along the axis (0 for the first layer crossed), and the
+// transverse offset from the axis in a frame turned by the azimuth of the
+// axis. The patterns are binned in log(energy) and |cos(theta_z)| and
+// written at the end of the run, from all threads, to a single file.
+//
+// Replay: the file is memory-mapped read-only, so the threads share the
+// same pages and nothing is parsed at load time. A pattern drawn at random
+// from the bin of the particle is turned to the azimuth of its axis,
+// placed on the layers it crosses and scaled to its energy.
+//
+// File layout (native byte order):
+//   FileHeader
+//   uint32 binStart[nBins + 1]  first pattern of each bin, padded to 8 bytes
+//   PatternRecord[nPatterns]    sorted by bin
+//   Spot[nSpots]
+class ShowerLibrary
+{
+  public:
+    struct Spot {
+      std::int32_t layer;  // silicon layer crossed by the axis, counted from the start
+      float u;             // mm, transverse offset along the axis azimuth
+      float v;             // mm, transverse offset perpendicular to it
+      float energy;        // MeV
+    };
+
+    struct PatternRecord {
+      std::uint64_t firstSpot;
+      std::uint32_t nSpots;
+      float energy;  // MeV, kinetic energy of the recorded particle
+    };
+
+    struct FileHeader {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t nEnergyBins;
+      std::uint32_t nAngleBins;
+      std::uint32_t nPatterns;
+      std::uint64_t nSpots;
+      double minEnergy;  // MeV, log binning
+      double maxEnergy;
+    };
+
+    // a silicon layer crossed by the shower axis, in the order of the axis
+    struct Crossing {
+      G4ThreeVector centre;  // axis point in the middle of the layer
+      G4double depth;        // X0 from the start, to the middle of the layer
+      G4double thickness;    // X0 along the axis
+      G4double zMin;
+      G4double zMax;
+    };
+
+    ShowerLibrary() = default;
+    ~ShowerLibrary();
+    ShowerLibrary(const ShowerLibrary&) = delete;
+    ShowerLibrary& operator=(const ShowerLibrary&) = delete;
+
+    // replay
+    G4bool Load(const G4String& fileName);
+    void Unload();
+    G4bool IsLoaded() const { return fHeader != nullptr; }
+    // draw a pattern of the bin of the particle, false when the bin is empty
+    G4bool Sample(G4double energy, G4double cosTheta, const PatternRecord*& pattern, const Spot*& spots) const;
+
+    // recording
+    void SetEnergyBins(G4int n) { fNEnergyBins = std::max(n, 1); }
+    void SetAngleBins(G4int n) { fNAngleBins = std::max(n, 1); }
+    void SetEnergyRange(G4double minEnergy, G4double maxEnergy);
+    void BeginShower(G4int trackID, G4double energy, const G4ThreeVector& axis, std::vector<Crossing> crossings);
+    void AddDeposit(G4int trackID, const G4ThreeVector& position, G4double edep);
+    void EndOfEvent();
+    // hand the patterns of the thread over; the master (or the only thread)
+    // writes all of them to the file
+    void EndOfRun(const G4String& fileName);
+    G4long GetNRecorded() const { return fNRecorded; }
+
+  private:
+    struct Recorded {
+      std::size_t bin;
+      G4double energy;
+      std::vector<Spot> spots;
+    };
+    struct Pending {
+      G4double energy;
+      G4double cosTheta;
+      G4ThreeVector axis;
+      std::vector<Crossing> crossings;
+      std::vector<Spot> spots;
+    };
+
+    static std::size_t FindBin(G4double energy, G4double cosTheta, std::uint32_t nEnergyBins,
+                               std::uint32_t nAngleBins, G4double minEnergy, G4double maxEnergy);
+    static std::size_t BinTableSize(std::size_t nBins);
+    static G4bool Write(const G4String& fileName, std::vector<Recorded>& showers, std::uint32_t nEnergyBins,
+                        std::uint32_t nAngleBins, G4double minEnergy, G4double maxEnergy);
+
+    // mapped file
+    void* fMapping = nullptr;
+    std::size_t fMappingSize = 0;
+    const FileHeader* fHeader = nullptr;
+    const std::uint32_t* fBinStart = nullptr;
+    const PatternRecord* fPatterns = nullptr;
+    const Spot* fSpots = nullptr;
+
+    // recording
+    G4int fNEnergyBins = 10;
+    G4int fNAngleBins = 5;
+    G4double fMinEnergy = 0.;
+    G4double fMaxEnergy = 0.;
+    std::map<G4int, Pending> fPending;  // by track ID, the current event
+    std::vector<Recorded> fRecorded;
+    G4long fNRecorded = 0;
+
+    // patterns of all threads, written by the master at the end of the run
+    static std::vector<Recorded> sMerged;
+    static G4Mutex sMergeMutex;
+};
+
+#endif
@@ -6,6 +6,8 @@
 
 class RunAction;
 class EventAction;
+class StackingPolicy;
+class TrackTable;
 
 class StackingAction : public G4UserStackingAction {
   public:
@@ -14,10 +16,14 @@ class StackingAction : public G4UserStackingAction {
 
     //! Main interface
     G4ClassificationOfNewTrack ClassifyNewTrack (const G4Track*);
+    void NewStage();
+    void PrepareNewEvent();
 
   private:
     RunAction* fRunAction;
     EventAction* fEventAction;
+    StackingPolicy* fPolicy;
+    TrackTable* fTrackTable;
 };
 
 #endif
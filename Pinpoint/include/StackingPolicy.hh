@@ -0,0 +1,113 @@
+#ifndef STACKINGPOLICY_HH
+#define STACKINGPOLICY_HH
+
+#include <unordered_map>
+#include <vector>
+
+#include "G4ClassificationOfNewTrack.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+class G4Track;
+class G4Region;
+class G4LogicalVolume;
+class StackingPolicyMessenger;
+
+// Track killing and prioritisation rules applied by the StackingAction,
+// configured with the /stack/ commands. Primaries are never touched.
+//
+//  - species threshold: kill a species below a kinetic energy
+//  - region threshold: kill a species (or any) below a kinetic energy when
+//    created in a given region
+//  - neutron time cut: kill neutrons created later than a global time
+//  - waiting stack: secondaries created in tungsten and travelling nearly
+//    parallel to the layers (|cos(theta_z)| below a minimum) are postponed
+//    to the waiting stack, and optionally dropped when the urgent stack is
+//    done
+//
+// In validation mode no track is killed: the tracks a rule would have
+// removed, and their descendants, are tagged, and the CPU time spent on them
+// and the steps they make in the pixel SD (charged steps with a deposit) are
+// accumulated per rule. This gives the CPU saved by each rule and how many
+// pixel SD steps it removes; a step count, not a change in the number of
+// pixel hits, as several steps feed one pixel. One instance per thread; the
+// summary is printed at the end of run.
+class StackingPolicy
+{
+  public:
+    enum Rule { kSpeciesThreshold, kRegionThreshold, kNeutronTime, kWaitingDrop, kNRules };
+
+    StackingPolicy();
+    ~StackingPolicy();
+    static StackingPolicy* GetInstance();
+
+    // configuration (messenger)
+    void SetSpeciesThreshold(G4int pdg, G4double ekin) { fSpeciesThresholds[pdg] = ekin; }
+    void SetRegionThreshold(const G4String& region, G4int pdg, G4double ekin);
+    void SetNeutronTimeCut(G4double time) { fNeutronTimeCut = time; }
+    void SetPostponeAwayFromSilicon(G4bool val) { fPostpone = val; }
+    void SetPostponeMinCosZ(G4double val) { fPostponeMinCosZ = val; }
+    void SetDropWaiting(G4bool val) { fDropWaiting = val; }
+    void SetValidate(G4bool val) { fValidate = val; }
+    void ClearRules();
+
+    // stacking hooks
+    G4ClassificationOfNewTrack Classify(const G4Track* track);
+    // true if the postponed tracks should be discarded at the new stage;
+    // Geant4 has already moved them to the urgent stack at that point
+    G4bool DropWaitingStack(G4int nPromoted);
+
+    // run, event, tracking and sensitive detector hooks
+    void BeginOfRun();
+    void EndOfRun();
+    void BeginOfEvent();
+    void BeginOfTrack(const G4Track* track);
+    void EndOfTrack(const G4Track* track);
+    // one step of the track with a deposit in the pixel SD
+    void CountPixelStep(G4int trackID);
+
+  private:
+    struct RegionRule {
+      G4String region;
+      G4int pdg;   // 0 for any species
+      G4double ekin;
+    };
+
+    // rule a new secondary falls under, kNRules if none
+    Rule Match(const G4Track* track);
+    G4bool IsActive() const;
+
+    static G4ThreadLocal StackingPolicy* fInstance;
+    StackingPolicyMessenger* fMessenger{nullptr};
+
+    // rules
+    std::unordered_map<G4int, G4double> fSpeciesThresholds;
+    std::vector<RegionRule> fRegionRules;
+    G4double fNeutronTimeCut = -1.;  // < 0 disables it
+    G4bool fPostpone = false;
+    G4double fPostponeMinCosZ = 0.2;
+    G4bool fDropWaiting = false;
+    G4bool fValidate = false;
+
+    // region rules resolved per region, and the tungsten volume test, are
+    // cached on first use
+    std::unordered_map<const G4Region*, std::vector<const RegionRule*>> fRegionCache;
+    std::unordered_map<const G4LogicalVolume*, G4bool> fTungstenCache;
+
+    // validation: rule tagged on each track removed in enforcing mode
+    std::unordered_map<G4int, G4int> fTrackRule;
+    G4int fCurrentRule = kNRules;
+    G4double fTrackCPUStart = 0.;
+
+    // run totals
+    G4int fNEvents = 0;
+    G4long fNPostponed = 0;
+    G4long fNTracks[kNRules] = {};
+    G4double fEnergy[kNRules] = {};
+    G4double fCPUTime[kNRules] = {};
+    G4long fPixelSteps[kNRules] = {};
+    G4long fTotalPixelSteps = 0;
+    G4double fTotalCPUTime = 0.;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef StackingPolicyMessenger_h
+#define StackingPolicyMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class StackingPolicy;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+class StackingPolicyMessenger: public G4UImessenger
+{
+  public:
+
+    StackingPolicyMessenger(StackingPolicy* );
+    ~StackingPolicyMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+
+  private:
+
+    // PDG code of a particle name, 0 for "all"; -1 if unknown
+    G4int ParticleCode(const G4String& name) const;
+
+    StackingPolicy* fPolicy;
+
+    G4UIdirectory* fStackDir;
+    G4UIcommand* fKillBelowCmd;
+    G4UIcommand* fRegionKillBelowCmd;
+    G4UIcmdWithADoubleAndUnit* fNeutronTimeCutCmd;
+    G4UIcmdWithABool* fPostponeCmd;
+    G4UIcmdWithADouble* fPostponeMinCosZCmd;
+    G4UIcmdWithABool* fDropWaitingCmd;
+    G4UIcmdWithABool* fValidateCmd;
+    G4UIcmdWithoutParameter* fClearCmd;
+};
+
+#endif
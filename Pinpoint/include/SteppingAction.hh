@@ -3,17 +3,18 @@
 
 #include <G4UserSteppingAction.hh>
 
-class RunAction;
+class SteppingHooks;
 
+// Runs the active stepping hooks (SteppingHooks). It is only installed for
+// the runs where at least one hook is active.
 class SteppingAction : public G4UserSteppingAction {
   public:
-    SteppingAction(RunAction*);
+    SteppingAction();
 
     void UserSteppingAction(const G4Step*) override;
-    void TrackLiveDebugging(const G4Step*);
 
   private:
-    RunAction* fRunAction;
+    SteppingHooks* fHooks;
 };
 
 #endif
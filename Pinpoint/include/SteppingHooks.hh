@@ -0,0 +1,89 @@
+#ifndef STEPPINGHOOKS_HH
+#define STEPPINGHOOKS_HH
+
+#include <vector>
+
+#include "G4Threading.hh"
+#include "globals.hh"
+
+class G4Step;
+class SteppingAction;
+class SteppingHooksMessenger;
+
+// A piece of per-step work, run by the SteppingAction while it is active
+class SteppingHook
+{
+  public:
+    explicit SteppingHook(const G4String& name) : fName(name) {}
+    virtual ~SteppingHook() = default;
+
+    const G4String& GetName() const { return fName; }
+    virtual G4bool IsActive() const = 0;
+    virtual void BeginOfRun() {}
+    virtual void Step(const G4Step* step) = 0;
+    virtual void EndOfRun() {}
+
+  private:
+    G4String fName;
+};
+
+class LiveDebugHook;
+class VolumeKillHook;
+class StepLengthHook;
+
+// Registry of the stepping hooks, configured with the /step/ commands.
+//
+// Hooks:
+//  - perf: PerfMonitor step accounting per species and volume (/perf/enable)
+//  - liveDebug: print every step of every track (/step/liveDebug)
+//  - volumeKill: kill the tracks entering given logical volumes (/step/killInVolume)
+//  - stepLength: step length distribution of charged and neutral particles,
+//    printed at the end of the run (/step/lengthHistogram)
+//
+// At the start of each run the active hooks are collected and the
+// SteppingAction is installed only if there is at least one. Otherwise
+// the stepping manager has no user action and pays nothing per step.
+// /step/keepAction keeps the action installed with no hook, to measure
+// the cost of an installed action that does nothing. One instance per
+// thread.
+class SteppingHooks
+{
+  public:
+    SteppingHooks();
+    ~SteppingHooks();
+    static SteppingHooks* GetInstance();
+
+    // takes ownership
+    void Register(SteppingHook* hook);
+    // the action of this thread, installed or removed at each run start
+    void SetSteppingAction(SteppingAction* action) { fSteppingAction = action; }
+
+    // configuration (messenger)
+    void SetLiveDebug(G4bool val);
+    void AddKillVolume(const G4String& name);
+    void ClearKillVolumes();
+    void SetStepLengthHistogram(G4bool val);
+    void SetKeepAction(G4bool val) { fKeepAction = val; }
+    void Print() const;
+
+    void BeginOfRun();
+    void EndOfRun();
+
+    const std::vector<SteppingHook*>& GetActiveHooks() const { return fActive; }
+
+  private:
+    static G4ThreadLocal SteppingHooks* fInstance;
+    SteppingHooksMessenger* fMessenger{nullptr};
+
+    std::vector<SteppingHook*> fHooks;
+    std::vector<SteppingHook*> fActive;
+    SteppingAction* fSteppingAction = nullptr;
+    G4bool fInstalled = true;  // as registered by ActionInitialization
+    G4bool fKeepAction = false;
+
+    LiveDebugHook* fLiveDebug;
+    VolumeKillHook* fVolumeKill;
+    StepLengthHook* fStepLength;
+};
+
+#endif
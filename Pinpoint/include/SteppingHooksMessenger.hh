@@ -0,0 +1,35 @@
+#ifndef SteppingHooksMessenger_h
+#define SteppingHooksMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class SteppingHooks;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+
+class SteppingHooksMessenger: public G4UImessenger
+{
+  public:
+
+    SteppingHooksMessenger(SteppingHooks* );
+    ~SteppingHooksMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+
+  private:
+
+    SteppingHooks* fHooks;
+
+    G4UIdirectory* fStepDir;
+    G4UIcmdWithABool* fLiveDebugCmd;
+    G4UIcmdWithAString* fKillInVolumeCmd;
+    G4UIcmdWithoutParameter* fClearKillVolumesCmd;
+    G4UIcmdWithABool* fLengthHistogramCmd;
+    G4UIcmdWithABool* fKeepActionCmd;
+    G4UIcmdWithoutParameter* fListCmd;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef TRACKHITTABLE_HH
+#define TRACKHITTABLE_HH
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "globals.hh"
+
+// Per-event track to pixel hit links, in compressed sparse row form.
+//
+// PixelSD links every track contributing to a hit while it creates the hits
+// at the end of the event; Build() then groups the links by track with a
+// counting sort over the dense track IDs. The hits of track t are
+//   indices[offsets[t]] ... indices[offsets[t + 1] - 1]
+// in increasing hit order, where a hit index is the position of the hit in
+// the pixelHits branches of the same event. offsets has one entry more than
+// the largest linked track ID, so a lookup is two reads and no search. The
+// buffers are cleared every event but keep their capacity.
+class TrackHitTable
+{
+  public:
+    TrackHitTable();
+
+    void Clear()
+    {
+      fLinks.clear();
+      fOffsets.clear();
+      fIndices.clear();
+    }
+    void Link(G4int trackID, std::uint32_t hitIndex) { fLinks.emplace_back(trackID, hitIndex); }
+    // group the links of this event by track
+    void Build();
+
+    const std::vector<std::uint32_t>& GetOffsets() const { return fOffsets; }
+    const std::vector<std::uint32_t>& GetIndices() const { return fIndices; }
+    // number of hits of a track, and the first of them
+    std::uint32_t GetNHits(G4int trackID) const
+    {
+      return IsLinked(trackID) ? fOffsets[trackID + 1] - fOffsets[trackID] : 0;
+    }
+    const std::uint32_t* GetHits(G4int trackID) const
+    {
+      return IsLinked(trackID) ? fIndices.data() + fOffsets[trackID] : nullptr;
+    }
+
+  private:
+    G4bool IsLinked(G4int trackID) const
+    {
+      return trackID >= 0 && static_cast<std::size_t>(trackID) + 1 < fOffsets.size();
+    }
+
+    std::vector<std::pair<G4int, std::uint32_t>> fLinks;  // (track, hit) in hit order
+    std::vector<std::uint32_t> fOffsets;
+    std::vector<std::uint32_t> fIndices;
+};
+
+#endif
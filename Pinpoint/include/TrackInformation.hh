@@ -28,22 +28,10 @@ class TrackInformation : public G4VUserTrackInformation
     inline G4int IsTrackFromFSLPizero() const {return fFromFSLPizero;}
     inline G4int IsTrackFromPrimaryLepton() const {return fFromPrimaryLepton;}
 
-    inline void InsertHit(G4long hitIndex) { 
-      if (!fHitIndices) {
-        fHitIndices = std::make_shared<std::vector<G4long>>();
-      }
-      fHitIndices->push_back(hitIndex); }
-    inline std::shared_ptr<std::vector<G4long>> GetHitIndices() const { return fHitIndices; }
-
-
   private:
     G4int fFromPrimaryPizero;
     G4int fFromFSLPizero;
     G4int fFromPrimaryLepton;
-
-    std::shared_ptr<std::vector<G4long>> fHitIndices;
-
-    // std::vector<G4long>* fHitIndices; //TODO: Make this a smart pointer?
 };
 
 extern G4ThreadLocal
@@ -0,0 +1,135 @@
+#ifndef TRACKTABLE_HH
+#define TRACKTABLE_HH
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class G4Track;
+class G4VProcess;
+
+// Per-event truth of every track, indexed by track ID.
+//
+// Geant4 assigns track IDs densely from 1 in the order the tracks are
+// stacked, and a parent is always stacked before its secondaries. The table
+// is therefore a plain vector filled from StackingAction::ClassifyNewTrack,
+// where each new track is resolved against its parent's entry in O(1). It is
+// cleared at the start of each event but keeps its capacity, so after the
+// first events no allocation happens on the stacking or step path.
+//
+// Origin flags:
+//  - kFromMuon: the track is a muon or has a muon among its ancestors
+//  - kFromPrimaryLepton: decay product of a primary tau or muon (track 1)
+//  - kFromPrimaryPizero: decay product of a primary pi0
+//  - kFromFSLPizero: decay product of a pi0 from the decay of track 1
+//  - kFastShower: track the fast shower model would have taken, or a
+//    descendant of one (FastShower validation mode)
+// kFromMuon and kFastShower are inherited by the descendants; the decay
+// product flags are set on the direct decay products only, as these count
+// as primary particles. Decay products are recognised by their creator
+// process, whose name is compared once per process object and run rather
+// than once per track.
+//
+// With SetRecordProduction (ACTS output) the production vertex, momentum
+// and creator process of every track are kept as well, in a second vector
+// with the same indexing.
+class TrackTable
+{
+  public:
+    enum Flag : std::uint8_t {
+      kFromMuon = 1 << 0,
+      kFromPrimaryLepton = 1 << 1,
+      kFromPrimaryPizero = 1 << 2,
+      kFromFSLPizero = 1 << 3,
+      kDecayProduct = 1 << 4,  // created by the "Decay" process
+      kFastShower = 1 << 5
+    };
+
+    struct Entry {
+      G4int ancestorID = -1;  // -1 for tracks whose parent was not registered
+      G4int parentID = 0;
+      G4int pdg = 0;
+      std::uint8_t flags = 0;
+      std::uint8_t generation = 0;  // 0 for primaries, saturates at 255
+    };
+
+    // creator process categories, as ActsFatras::ProcessType
+    enum Process : std::uint8_t {
+      kUndefined = 0,
+      kDecay = 1,
+      kPhotonConversion = 2,
+      kBremsstrahlung = 3,
+      kNuclearInteraction = 4
+    };
+
+    struct Production {
+      G4ThreeVector position;
+      G4double time = 0.;
+      G4ThreeVector momentum;
+      G4double mass = 0.;
+      G4double charge = 0.;
+      Process process = kUndefined;
+    };
+
+    TrackTable();
+
+    // start a new event, the capacity is kept
+    void Clear()
+    {
+      fEntries.clear();
+      fProductions.clear();
+    }
+    void SetRecordProduction(G4bool val) { fRecordProduction = val; }
+    // start a new run: the creator processes are classified again
+    void ResetProcesses()
+    {
+      fProcesses.clear();
+      fLastProcess = nullptr;
+    }
+
+    // resolve a new track against its parent and store it
+    const Entry& Register(const G4Track* track);
+    // flag a track while it is tracked, secondaries created afterwards
+    // inherit kFastShower
+    void Tag(G4int trackID, Flag flag)
+    {
+      if (trackID > 0 && static_cast<std::size_t>(trackID) < fEntries.size()) fEntries[trackID].flags |= flag;
+    }
+
+    G4int GetPrimaryAncestor(G4int trackID) const { return Get(trackID).ancestorID; }
+    // oldest ancestor carrying an inherited flag (the track itself if its
+    // parent has not), 0 if the track has not the flag
+    G4int GetFlagOrigin(G4int trackID, Flag flag) const;
+    G4bool Has(G4int trackID, Flag flag) const { return (Get(trackID).flags & flag) != 0; }
+    const Entry& Get(G4int trackID) const
+    {
+      return (trackID > 0 && static_cast<std::size_t>(trackID) < fEntries.size()) ? fEntries[trackID] : fUnknown;
+    }
+    // only with SetRecordProduction, nullptr for unknown tracks
+    const Production* GetProduction(G4int trackID) const
+    {
+      return (trackID > 0 && static_cast<std::size_t>(trackID) < fProductions.size()) ? &fProductions[trackID] : nullptr;
+    }
+
+  private:
+    struct ProcessClass {
+      G4bool isDecay;  // named "Decay"
+      Process process;
+    };
+    const ProcessClass& Classify(const G4VProcess* process);
+
+    std::vector<Entry> fEntries;
+    G4bool fRecordProduction = false;
+    std::vector<Production> fProductions;
+    // creator processes seen in this run, and their category; consecutive
+    // tracks mostly share the creator
+    std::vector<std::pair<const G4VProcess*, ProcessClass>> fProcesses;
+    const G4VProcess* fLastProcess = nullptr;
+    ProcessClass fLastClass{false, kUndefined};
+    const Entry fUnknown{};
+};
+
+#endif
@@ -19,16 +19,16 @@ class GENIEGenerator : public GeneratorBase
     // override methods from common base class
     void LoadData() override;
     void GeneratePrimaries(G4Event *anEvent) override;
+    void PrintIOStats() const override;
 
     // setter methods for messenger
     void SetGSTFilename(G4String val) { fGSTFilename = val; }
-    void SetEvtStartIdx(G4int val) { fEvtStartIdx = val; }
+    void SetEvtStartIdx(G4long val) { fEvtStartIdx = val; }
     void SetRandomVertex(G4bool val) { fRandomVtx = val; }
 
   private:
     G4String fGSTFilename;
-    G4int fEventCounter;
-    G4int fEvtStartIdx;
+    G4long fEvtStartIdx;
     G4bool fRandomVtx;
     TFile *fGSTFile;
     TTree *fGSTTree;
@@ -44,7 +44,7 @@ class GENIEGenerator : public GeneratorBase
     G4int m_pdgf[250];
     G4double m_Ef[250], m_pxf[250], m_pyf[250], m_pzf[250];
     G4bool m_qel, m_mec, m_res, m_dis, m_coh, m_dfr, m_imd;
-    G4bool m_imdanh, m_nuel, m_em, m_cc, m_nc, m_charm;
+    G4bool m_imdanh, m_nuel, m_em, m_cc, m_nc;
     G4bool m_singlek, m_amnugamma;
     G4int m_neuPDG, m_fslPDG;
     G4int m_tgt, m_Z, m_A, m_hitnuc;
@@ -55,7 +55,7 @@ class GENIEGenerator : public GeneratorBase
     G4int DecodeInteractionType() const;
     G4int DecodeScatteringType() const;
     G4String EncodeProcessName() const;
-    G4ThreeVector GenerateRandomPoint(G4int currentIdx) const;
+    G4ThreeVector GenerateRandomPoint() const;
 };
 
 #endif
@@ -21,6 +21,7 @@ class GFaserGenerator : public GeneratorBase
     ~GFaserGenerator() override;
     void GeneratePrimaries(G4Event*) override;
     void LoadData() override;
+    void PrintIOStats() const override;
 
     void SetInputFileName(const G4String& filename) { fInputFileName = filename; }
     void SetFirstEvent(G4long event) { fFirstEvent = event; }
@@ -48,7 +49,6 @@ class GFaserGenerator : public GeneratorBase
     int fTgtZ, fTgtA, fTgtPdg;
     double xsec;
 
-    std::vector<std::string>* fName = nullptr;
     std::vector<int>* fPdgc = nullptr;
     std::vector<int>* fStatus = nullptr;
     std::vector<double>* fPx = nullptr;
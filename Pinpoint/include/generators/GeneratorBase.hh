@@ -31,10 +31,18 @@ class GeneratorBase
     // return single vertex metadata
     GeneratorVertexMetadata GetEventMetadataPerVertex(G4int i) const { return fVertexMetadata.at(i); }
 
+    // read-ahead cache size (bytes) for the generators reading ROOT trees,
+    // set before LoadData
+    void SetIOCacheSize(G4long bytes) { fIOCacheSize = bytes; }
+
+    // print the input I/O statistics of the run, if the generator reads a file
+    virtual void PrintIOStats() const {}
+
   protected : 
 
     G4String fGeneratorName; 
     G4UImessenger* fMessenger;
+    G4long fIOCacheSize = 0;
     std::vector<GeneratorVertexMetadata> fVertexMetadata;
 };
 
@@ -0,0 +1,39 @@
+#ifndef HepMCEventIndex_HH
+#define HepMCEventIndex_HH
+
+#include "globals.hh"
+
+#include <ios>
+#include <vector>
+
+// Byte offset of every event ("E ..." line) in a HepMC2/HepMC3 ASCII file.
+// The offsets are cached next to the input in <file>.idx, a text file:
+//
+//   # pinpoint hepmc index v1
+//   <file size> <modification time> <number of events>
+//   <offset of event 0>
+//   ...
+//
+// The sidecar is rebuilt whenever the size or modification time of the
+// input no longer match, and is only a cache: if it cannot be written the
+// offsets are kept in memory for this job.
+class HepMCEventIndex
+{
+  public:
+    // load the sidecar if it is up to date, otherwise scan the input
+    G4bool Load(const G4String& filename);
+
+    std::size_t GetNumberOfEvents() const { return fOffsets.size(); }
+    std::streamoff GetOffset(std::size_t entry) const { return fOffsets[entry]; }
+
+    static G4String GetIndexFilename(const G4String& filename) { return filename + ".idx"; }
+
+  private:
+    G4bool ReadSidecar(const G4String& indexName, long long size, long long mtime);
+    G4bool Build(const G4String& filename);
+    void WriteSidecar(const G4String& indexName, long long size, long long mtime) const;
+
+    std::vector<std::streamoff> fOffsets;
+};
+
+#endif
@@ -2,12 +2,18 @@
 #define HepMCGenerator_HH
 
 #include "generators/GeneratorBase.hh"
+#include "generators/HepMCEventIndex.hh"
+#include "generators/HepMCPrefetcher.hh"
 
 #include "HepMC3/ReaderAscii.h"
 #include "HepMC3/ReaderAsciiHepMC2.h"
 #include <HepMC3/Print.h>
 
 #include "globals.hh"
+#include "G4Threading.hh"
+
+#include <istream>
+#include <memory>
 
 class G4Event;
 
@@ -26,6 +32,9 @@ class HepMCGenerator : public GeneratorBase
     void SetUseHepMC2(G4bool val) { fUseHepMC2 = val; }
     void SetHepMCVertexOffset(G4ThreeVector val) { fVtxOffset = val; }
     void SetPlaceInDecayVolume(G4bool val) { fPlaceInDecayVolume = val; }    
+    void SetFirstEvent(G4long val) { fFirstEvent = val; }
+    void SetUseIndex(G4bool val) { fUseIndex = val; }
+    void SetPrefetchDepth(G4int val) { fPrefetchDepth = val; }
 
   private:
 
@@ -33,12 +42,34 @@ class HepMCGenerator : public GeneratorBase
     G4bool fUseHepMC2;
     G4bool fPlaceInDecayVolume;
     G4ThreeVector fVtxOffset;
-    HepMC3::Reader* fAsciiInput;
+    G4long fFirstEvent;
+    G4bool fUseIndex;
+    G4int fPrefetchDepth;
+    std::shared_ptr<HepMC3::Reader> fAsciiInput;
+    std::shared_ptr<HepMCPrefetcher> fPrefetcher;
+    G4int fRunID;  // run the reader pointers above belong to
+
+    // a single reader is shared by all worker threads so that every event
+    // in the file is consumed exactly once; reads are serialised by sReaderMutex.
+    // With the index, entry fFirstEvent + event ID is read by seeking the stream,
+    // without it the file is read sequentially. With a prefetch depth the
+    // reader is driven by the prefetch thread instead. Every run starts again
+    // at fFirstEvent, the first thread to generate an event of a run rewinds
+    // the shared input (sSharedRunID)
+    static std::shared_ptr<HepMC3::Reader> sSharedInput;
+    static std::shared_ptr<std::istream> sSharedStream;
+    static std::shared_ptr<HepMCEventIndex> sSharedIndex;
+    static std::shared_ptr<HepMCPrefetcher> sSharedPrefetcher;
+    static G4String sSharedFilename;
+    static G4int sSharedRunID;
+    static G4Mutex sReaderMutex;
         
     // specific internal functions
-    std::shared_ptr<HepMC3::GenEvent> GenerateHepMCEvent();
+    void BeginOfRun(G4int runID);
+    void RewindInput();
+    std::shared_ptr<HepMC3::GenEvent> GenerateHepMCEvent(G4long entry);
     G4bool CheckVertexInsideWorld (const G4ThreeVector& pos) const;
-    void HepMC2G4(const std::shared_ptr<HepMC3::GenEvent> hepmcevt, G4Event* g4event);
+    void HepMC2G4(const HepMC3::GenEvent& hepmcevt, G4Event* g4event);
     G4double GetStartOfDecayVolume();
         
 };
@@ -11,6 +11,7 @@ class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWith3VectorAndUnit;
 class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -30,6 +31,9 @@ class HepMCGeneratorMessenger: public G4UImessenger
     G4UIcmdWith3VectorAndUnit* fHepMCVertexOffsetCmd;
     G4UIcmdWithABool* fUseHepMC2Cmd;
     G4UIcmdWithABool* fHepMCPlaceInDecayVolumeCmd;
+    G4UIcmdWithAnInteger* fHepMCFirstEventCmd;
+    G4UIcmdWithABool* fHepMCUseIndexCmd;
+    G4UIcmdWithAnInteger* fHepMCPrefetchDepthCmd;
 
 };
 
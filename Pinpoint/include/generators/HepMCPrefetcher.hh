@@ -0,0 +1,69 @@
+#ifndef HepMCPrefetcher_HH
+#define HepMCPrefetcher_HH
+
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/Reader.h"
+
+#include "globals.hh"
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Parses HepMC events on a background thread ahead of the simulation.
+//
+// The reader must be positioned at firstEntry; the prefetch thread then
+// reads the file sequentially into a ring of depth reusable GenEvents, entry
+// e going to slot (e - firstEntry) % depth once the previous occupant has been
+// released. Acquire(e) blocks until entry e is decoded, so the entry seen by
+// an event does not depend on which worker thread gets there first. As long
+// as every thread asks for its entries in increasing order (the Geant4 event
+// IDs), the smallest outstanding entry can always be filled.
+class HepMCPrefetcher
+{
+  public:
+    HepMCPrefetcher(std::shared_ptr<HepMC3::Reader> reader, G4long firstEntry, std::size_t depth);
+    ~HepMCPrefetcher();
+
+    // the decoded entry, or nullptr if the file ends before it; the event
+    // stays valid until Release(entry)
+    const HepMC3::GenEvent* Acquire(G4long entry);
+    void Release(G4long entry);
+
+    // join the prefetch thread, pending entries are dropped
+    void Stop();
+
+    // number of Acquire() calls, and how many of them had to wait for the parser
+    std::size_t GetNumberOfAcquired() const { return fNAcquired; }
+    std::size_t GetNumberOfWaits() const { return fNWaits; }
+
+  private:
+    struct Slot {
+      HepMC3::GenEvent event;
+      G4long entry = -1;   // -1 while the slot is free
+      G4bool ready = false;
+    };
+
+    void Run();
+    Slot& SlotFor(G4long entry) { return fSlots[(entry - fFirstEntry) % fSlots.size()]; }
+
+    std::shared_ptr<HepMC3::Reader> fReader;
+    const G4long fFirstEntry;
+    std::vector<Slot> fSlots;
+
+    std::mutex fMutex;
+    std::condition_variable fReady;
+    std::condition_variable fFree;
+    G4long fEndEntry = -1;  // first entry past the end of the file, once known
+    bool fStop = false;
+
+    std::size_t fNAcquired = 0;
+    std::size_t fNWaits = 0;
+
+    std::thread fThread;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef TreeInput_HH
+#define TreeInput_HH
+
+#include "globals.hh"
+
+#include "TTree.h"
+
+// Helpers for the generators reading their input from a ROOT tree.
+//
+// Begin() switches every branch off and sets up a read-ahead TTreeCache for
+// the entries the current run will read, from firstEntry on; Bind() then
+// enables, binds and caches one branch at a time, so GetEntry() only
+// decompresses what the generator uses. End() closes the cache learning phase.
+namespace TreeInput {
+
+  // cacheSize in bytes, 0 disables the cache
+  void Begin(TTree* tree, Long64_t cacheSize, Long64_t firstEntry);
+
+  template <typename T>
+  void Bind(TTree* tree, const char* name, T* address)
+  {
+    tree->SetBranchStatus(name, 1);
+    tree->SetBranchAddress(name, address);
+    if (tree->GetCacheSize() > 0) tree->AddBranchToCache(name);
+  }
+
+  void End(TTree* tree);
+
+  // bytes and read calls on the file, and the cache efficiency
+  void PrintStats(const TTree* tree, const G4String& label);
+}
+
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "reco/MultiIndex.hh"
+
+#include <cstdint>
+
+// Surface identifier with the bit layout of Acts::GeometryIdentifier
+// (volume, boundary, layer, approach, sensitive, extra), so the value can be
+// used as geometry_id by the ACTS readers. Same MultiIndex encoding as
+// Channel and PixelChannel.
+//
+// Each silicon plane is one sensitive surface: volume 1, layer 2 * (n + 1)
+// for plane n (ACTS numbers the sensitive layers with even values),
+// sensitive 1. The pixel within the plane is given by a PixelChannel.
+class GeometryId : public Acts::MultiIndex<std::uint64_t, 8, 8, 12, 8, 20, 8> {
+  using Base = Acts::MultiIndex<std::uint64_t, 8, 8, 12, 8, 20, 8>;
+
+ public:
+  using Base::Base;
+  using Base::Value;
+
+  // Construct an invalid GeometryId with all levels set to zero.
+  constexpr GeometryId() : Base(Base::Zeros()) {}
+  GeometryId(const GeometryId&) = default;
+  GeometryId(GeometryId&&) = default;
+  GeometryId& operator=(const GeometryId&) = default;
+  GeometryId& operator=(GeometryId&&) = default;
+
+  /// The surface of a silicon plane.
+  static constexpr GeometryId ForPlane(Value plane) {
+    return GeometryId().setVolume(1).setLayer(2 * (plane + 1)).setSensitive(1);
+  }
+
+  /// Return the volume identifier.
+  constexpr Value volume() const { return level(0); }
+  /// Return the boundary identifier.
+  constexpr Value boundary() const { return level(1); }
+  /// Return the layer identifier.
+  constexpr Value layer() const { return level(2); }
+  /// Return the approach identifier.
+  constexpr Value approach() const { return level(3); }
+  /// Return the sensitive identifier.
+  constexpr Value sensitive() const { return level(4); }
+
+  /// Set the volume identifier.
+  constexpr GeometryId& setVolume(Value id) {
+    set(0, id);
+    return *this;
+  }
+  /// Set the layer identifier.
+  constexpr GeometryId& setLayer(Value id) {
+    set(2, id);
+    return *this;
+  }
+  /// Set the sensitive identifier.
+  constexpr GeometryId& setSensitive(Value id) {
+    set(4, id);
+    return *this;
+  }
+
+  friend inline std::ostream& operator<<(std::ostream& os, GeometryId id) {
+    os << "vol=" << id.volume() << "|bnd=" << id.boundary() << "|lay=" << id.layer()
+       << "|apr=" << id.approach() << "|sen=" << id.sensitive();
+    return os;
+  }
+};
+
+// specialize std::hash so GeometryId can be used e.g. in an unordered_map
+namespace std {
+template <>
+struct hash<GeometryId> {
+  auto operator()(GeometryId id) const noexcept {
+    return std::hash<GeometryId::Value>()(id.value());
+  }
+};
+}  // namespace std
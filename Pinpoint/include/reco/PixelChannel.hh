@@ -0,0 +1,64 @@
+#pragma once
+
+#include "reco/MultiIndex.hh"
+
+#include <cstdint>
+
+// Pixel address (layer, row, column) packed into a single 64-bit value.
+// Same MultiIndex encoding as Channel, with levels sized for the pixel
+// planes (16 bits layer, 24 bits row and column, the same as the key of
+// PixelAccumulator): the packed value orders by layer, then row, then
+// column.
+class PixelChannel : public Acts::MultiIndex<std::uint64_t, 16, 24, 24> {
+  using Base = Acts::MultiIndex<std::uint64_t, 16, 24, 24>;
+
+ public:
+  using Base::Base;
+  using Base::Value;
+
+  // Construct an invalid PixelChannel with all levels set to zero.
+  constexpr PixelChannel() : Base(Base::Zeros()) {}
+  PixelChannel(const PixelChannel&) = default;
+  PixelChannel(PixelChannel&&) = default;
+  PixelChannel& operator=(const PixelChannel&) = default;
+  PixelChannel& operator=(PixelChannel&&) = default;
+
+  /// Return the layer identifier.
+  constexpr Value layerNumber() const { return level(0); }
+  /// Return the row identifier.
+  constexpr Value rowNumber() const { return level(1); }
+  /// Return the column identifier.
+  constexpr Value colNumber() const { return level(2); }
+
+  /// Set the layer identifier.
+  constexpr PixelChannel& setLayer(Value id) {
+    set(0, id);
+    return *this;
+  }
+  /// Set the row identifier.
+  constexpr PixelChannel& setRow(Value id) {
+    set(1, id);
+    return *this;
+  }
+  /// Set the column identifier.
+  constexpr PixelChannel& setCol(Value id) {
+    set(2, id);
+    return *this;
+  }
+
+  friend inline std::ostream& operator<<(std::ostream& os, PixelChannel channel) {
+    os << "l=" << channel.layerNumber()
+       << "|r=" << channel.rowNumber() << "|c=" << channel.colNumber();
+    return os;
+  }
+};
+
+// specialize std::hash so PixelChannel can be used e.g. in an unordered_map
+namespace std {
+template <>
+struct hash<PixelChannel> {
+  auto operator()(PixelChannel channel) const noexcept {
+    return std::hash<PixelChannel::Value>()(channel.value());
+  }
+};
+}  // namespace std
@@ -15,10 +15,12 @@ void ActionInitialization::Build() const {
   SetUserAction(theEventAction);
   SetUserAction(new TrackingAction);
   SetUserAction(new StackingAction(theRunAction, theEventAction));
-  SetUserAction(new SteppingAction(theRunAction));
+  // removed again at run start if no stepping hook is active
+  SetUserAction(new SteppingAction());
 }
 
 void ActionInitialization::BuildForMaster() const {
-  // By default, don't do anything. This applies only in MT mode
-  //SetUserAction(new RunAction);
+  // Only used in MT mode: the master has no event loop, but still
+  // needs a RunAction to open/close the run on the AnalysisManager side
+  SetUserAction(new RunAction());
 }
@@ -0,0 +1,190 @@
+#include "ActsOutput.hh"
+#include "DetectorConstruction.hh"
+#include "TrackTable.hh"
+
+#include "G4Event.hh"
+#include "G4Exception.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4RunManager.hh"
+
+#include <algorithm>
+#include <numeric>
+
+void ActsOutput::BeginOfRun()
+{
+  Clear();
+  if (!fEnabled) return;
+
+  // the geometry cannot change during a run
+  const auto det = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  fPixelX = det->GetPixelXPositions();
+  fPixelY = det->GetPixelYPositions();
+  fVarianceX = det->GetPixelWidth() * det->GetPixelWidth() / 12.;
+  fVarianceY = det->GetPixelHeight() * det->GetPixelHeight() / 12.;
+}
+
+void ActsOutput::Clear()
+{
+  fSimHits.clear();
+  fParticles.clear();
+  fBarcodes.clear();
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+ActsFatras::Barcode ActsOutput::PrimaryBarcode(G4int vertex, G4int index)
+{
+  // beyond the range of the levels the barcode would be shared, keep it invalid
+  const auto vertexID = static_cast<ActsFatras::Barcode::Value>(vertex) + 1;
+  const auto particleID = static_cast<ActsFatras::Barcode::Value>(index);
+  if (vertexID >> ActsFatras::Barcode::bits(0) || particleID >> ActsFatras::Barcode::bits(2))
+    return ActsFatras::Barcode();
+  return ActsFatras::Barcode().setVertexPrimary(vertexID).setParticle(particleID);
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void ActsOutput::AddSimHits(const std::vector<PixelAccumulator::Pixel>& pixels, const PixelAccumulator& accumulator)
+{
+  // every (pixel, track) deposit, grouped by (track, plane)
+  fDeposits.clear();
+  for (const auto& pixel : pixels) {
+    for (std::uint32_t k = pixel.firstContributor; k < pixel.firstContributor + pixel.nContributors; ++k) {
+      fDeposits.push_back({accumulator.GetContributorTrackID(k), pixel.layerID,
+                           accumulator.GetContributorEdep(k), &accumulator.GetContributorPayload(k)});
+    }
+  }
+  std::sort(fDeposits.begin(), fDeposits.end(), [](const Deposit& a, const Deposit& b) {
+    if (a.trackID != b.trackID) return a.trackID < b.trackID;
+    return a.layerID < b.layerID;
+  });
+
+  // one hit per group, at the earliest first step in a pixel
+  std::size_t i = 0;
+  while (i < fDeposits.size()) {
+    const Deposit& first = fDeposits[i];
+    const PixelAccumulator::Payload* earliest = first.payload;
+    G4double edep = 0.;
+    for (; i < fDeposits.size() && fDeposits[i].trackID == first.trackID && fDeposits[i].layerID == first.layerID; ++i) {
+      if (fDeposits[i].payload->time < earliest->time) earliest = fDeposits[i].payload;
+      edep += fDeposits[i].edep;
+    }
+    fSimHits.push_back({first.trackID, first.layerID, earliest->truthPos, earliest->time, earliest->p4, edep, 0});
+  }
+
+  // the hits of a track are adjacent, number them in time order
+  std::size_t begin = 0;
+  while (begin < fSimHits.size()) {
+    std::size_t end = begin;
+    while (end < fSimHits.size() && fSimHits[end].trackID == fSimHits[begin].trackID) ++end;
+
+    fOrder.resize(end - begin);
+    std::iota(fOrder.begin(), fOrder.end(), static_cast<std::uint32_t>(begin));
+    std::stable_sort(fOrder.begin(), fOrder.end(),
+                     [this](std::uint32_t a, std::uint32_t b) { return fSimHits[a].time < fSimHits[b].time; });
+    for (std::size_t rank = 0; rank < fOrder.size(); ++rank) fSimHits[fOrder[rank]].index = rank;
+
+    begin = end;
+  }
+}
+
+G4int ActsOutput::FindSimHit(G4int trackID, G4int layerID) const
+{
+  auto it = std::lower_bound(fSimHits.begin(), fSimHits.end(), std::make_pair(trackID, layerID),
+                             [](const SimHit& hit, const std::pair<G4int, G4int>& key) {
+                               if (hit.trackID != key.first) return hit.trackID < key.first;
+                               return hit.layerID < key.second;
+                             });
+  if (it == fSimHits.end() || it->trackID != trackID || it->layerID != layerID) return -1;
+  return static_cast<G4int>(it - fSimHits.begin());
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void ActsOutput::WarnBarcodeOverflow()
+{
+  if (fBarcodeWarned) return;
+  G4Exception("ActsOutput::AssignBarcodes", "BarcodeOverflow", JustWarning,
+              "More particles than the barcode levels can number, the extra ones get the invalid "
+              "barcode 0 and are not written as particles");
+  fBarcodeWarned = true;
+}
+
+void ActsOutput::AssignBarcodes(const G4Event* event, const TrackTable& tracks)
+{
+  fParticles.clear();
+
+  G4int nPrimaries = 0;
+  for (G4int ivtx = 0; ivtx < event->GetNumberOfPrimaryVertex(); ++ivtx)
+    nPrimaries += event->GetPrimaryVertex(ivtx)->GetNumberOfParticle();
+  const G4int maxTrackID = fSimHits.empty() ? nPrimaries : std::max(nPrimaries, fSimHits.back().trackID);
+  fBarcodes.assign(static_cast<std::size_t>(maxTrackID) + 1, 0u);
+
+  // Geant4 numbers the primary tracks from 1, in vertex and particle order
+  G4int trackID = 0;
+  for (G4int ivtx = 0; ivtx < event->GetNumberOfPrimaryVertex(); ++ivtx) {
+    for (G4int ipp = 0; ipp < event->GetPrimaryVertex(ivtx)->GetNumberOfParticle(); ++ipp) {
+      ++trackID;
+      fBarcodes[trackID] = PrimaryBarcode(ivtx, ipp).value();
+      if (fBarcodes[trackID] != 0) fParticles.push_back(trackID);
+      else WarnBarcodeOverflow();
+    }
+  }
+
+  // secondaries with hits, grouped by primary ancestor and generation; the
+  // hits are sorted by track, so each track is seen once
+  fSecondaries.clear();
+  for (std::size_t i = 0; i < fSimHits.size(); ++i) {
+    const G4int id = fSimHits[i].trackID;
+    if (id <= nPrimaries || (i > 0 && fSimHits[i - 1].trackID == id)) continue;
+    const TrackTable::Entry& entry = tracks.Get(id);
+    // tracks of an unregistered parent keep the invalid barcode
+    if (entry.ancestorID <= 0 || entry.ancestorID > nPrimaries) continue;
+    fSecondaries.push_back({entry.ancestorID, entry.generation, id});
+  }
+  std::sort(fSecondaries.begin(), fSecondaries.end(), [](const Secondary& a, const Secondary& b) {
+    if (a.ancestorID != b.ancestorID) return a.ancestorID < b.ancestorID;
+    if (a.generation != b.generation) return a.generation < b.generation;
+    return a.trackID < b.trackID;
+  });
+
+  // the sub-particle number counts on into the secondary vertex level, which
+  // primaries leave at zero, so the barcodes stay unique
+  const std::size_t subBits = ActsFatras::Barcode::bits(4);
+  const ActsFatras::Barcode::Value maxSub = (ActsFatras::Barcode::Value{1} << subBits) - 1;
+  const ActsFatras::Barcode::Value maxCount =
+    (ActsFatras::Barcode::Value{1} << (ActsFatras::Barcode::bits(1) + subBits)) - 1;
+  const ActsFatras::Barcode::Value maxGeneration = (ActsFatras::Barcode::Value{1} << ActsFatras::Barcode::bits(3)) - 1;
+  ActsFatras::Barcode::Value count = 0;
+  for (std::size_t i = 0; i < fSecondaries.size(); ++i) {
+    const Secondary& secondary = fSecondaries[i];
+    if (i > 0 && secondary.ancestorID == fSecondaries[i - 1].ancestorID
+        && secondary.generation == fSecondaries[i - 1].generation) {
+      ++count;
+    }
+    else {
+      count = 0;
+    }
+    // beyond the levels the particle keeps the invalid barcode and is not written
+    const ActsFatras::Barcode ancestor(fBarcodes[secondary.ancestorID]);
+    if (ancestor.value() == 0 || count > maxCount
+        || static_cast<ActsFatras::Barcode::Value>(secondary.generation) > maxGeneration) {
+      WarnBarcodeOverflow();
+      continue;
+    }
+
+    fBarcodes[secondary.trackID] = ActsFatras::Barcode(ancestor)
+                                     .setVertexSecondary(count >> subBits)
+                                     .setGeneration(secondary.generation)
+                                     .setSubParticle(count & maxSub)
+                                     .value();
+    fParticles.push_back(secondary.trackID);
+  }
+
+  std::sort(fParticles.begin(), fParticles.end(),
+            [this](G4int a, G4int b) { return fBarcodes[a] < fBarcodes[b]; });
+}
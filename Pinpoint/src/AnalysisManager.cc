@@ -5,6 +5,7 @@
 #include <map>
 #include <iomanip>
 #include <random>
+#include <algorithm>
 
 #include <G4Event.hh>
 #include <G4SDManager.hh>
@@ -17,10 +18,15 @@
 #include "G4THitsCollection.hh"
 #include "G4VVisManager.hh"
 #include "G4Circle.hh"
+#include "G4AutoLock.hh"
 
 
 #include <TDirectory.h>
 #include <TFile.h>
+#include <TFileMerger.h>
+#include <TROOT.h>
+#include <Compression.h>
+#include <TSystem.h>
 #include <TTree.h>
 #include <TH2F.h>
 #include <THnSparse.h>
@@ -30,10 +36,20 @@
 #include "DetectorConstruction.hh"
 #include "EventInformation.hh"
 #include "AnalysisManager.hh"
+#include "OutputWriter.hh"
 #include "reco/Barcode.hh"
+#include "reco/GeometryId.hh"
+#include "reco/PixelChannel.hh"
 #include "FPFParticle.hh"
 #include "PixelHit.hh"
 #include "ScintHit.hh"
+#include "PixelDigi.hh"
+#include "PixelDigitizer.hh"
+#include "PixelClusterizer.hh"
+#include "G4DigiManager.hh"
+#include "G4DCofThisEvent.hh"
+#include "PerfMonitor.hh"
+#include "Logging.hh"
 
 
 //---------------------------------------------------------------------
@@ -41,7 +57,11 @@
 // AnalysisManager "singleton" instance
 // once initialized, can be used to point to AnalysisManager
 // from anywhere else in the codebase
-AnalysisManager *AnalysisManager::fInstance = 0;
+// In MT mode every worker thread gets its own instance (and output file)
+G4ThreadLocal AnalysisManager *AnalysisManager::fInstance = 0;
+
+std::vector<AnalysisManager::WorkerFile> AnalysisManager::fWorkerFiles;
+G4Mutex AnalysisManager::fWorkerFilesMutex = G4MUTEX_INITIALIZER;
 
 AnalysisManager *AnalysisManager::GetInstance()
 {
@@ -66,9 +86,18 @@ AnalysisManager::AnalysisManager()
   fTrk = nullptr;
   fPrim = nullptr;
   fPixelHitsTree = nullptr;
-  // fActsParticlesTree = nullptr;
   
   fSaveTrack = false;
+  fSaveTruthHits = false;
+  fKeepWorkerFiles = false;
+  fSavePackedChannel = false;
+  fSavePixelHits = true;
+  fSaveActs = false;
+
+  fCompression = -1;
+  fBasketSize = 0;
+  fAutoFlush = 0;
+  fAsyncQueueDepth = 0;
 }
 
 AnalysisManager::~AnalysisManager() {}
@@ -79,59 +108,59 @@ AnalysisManager::~AnalysisManager() {}
 void AnalysisManager::bookEvtTree()
 {
   fEvt = new TTree("event", "event info");
-  fEvt->Branch("evtID", &evtID, "evtID/I");
-  fEvt->Branch("vtxID", &vertexID, "vtxID/I");
-  fEvt->Branch("weight", &weight, "weight/D");
-  fEvt->Branch("genType", &genType);
-  fEvt->Branch("processName", &processName);
-  fEvt->Branch("initPDG", &initPDG, "initPDG/I");
-  fEvt->Branch("initX", &initX, "initX/D");
-  fEvt->Branch("initY", &initY, "initY/D");
-  fEvt->Branch("initZ", &initZ, "initZ/D");
-  fEvt->Branch("initT", &initT, "initT/D");
-  fEvt->Branch("initPx", &initPx, "initPx/D");
-  fEvt->Branch("initPy", &initPy, "initPy/D");
-  fEvt->Branch("initPz", &initPz, "initPz/D"); 
-  fEvt->Branch("initE", &initE, "initE/D");
-  fEvt->Branch("initM", &initM, "initM/D");
-  fEvt->Branch("initQ", &initQ, "initQ/D");
-  fEvt->Branch("intType", &intType, "intType/I");
-  fEvt->Branch("scatteringType", &scatteringType, "scatteringType/I");
-  fEvt->Branch("fslPDG", &fslPDG, "fslPDG/I");
-  fEvt->Branch("tgtPDG", &tgtPDG, "tgtPDG/I");
-  fEvt->Branch("tgtA", &tgtA, "tgtA/I");
-  fEvt->Branch("tgtZ", &tgtZ, "tgtZ/I");
-  fEvt->Branch("hitnucPDG", &hitnucPDG, "hitnucPDG/I");
-  fEvt->Branch("xs", &xs, "xs/D");
-  fEvt->Branch("Q2", &Q2, "Q2/D");
-  fEvt->Branch("xBj", &xBj, "xBj/D");
-  fEvt->Branch("y", &y, "y/D");
-  fEvt->Branch("W", &W, "W/D");
+  fEvt->Branch("evtID", &fOutEvtID, "evtID/I");
+  fEvt->Branch("vtxID", &fEvtRow.vertexID, "vtxID/I");
+  fEvt->Branch("weight", &fEvtRow.weight, "weight/D");
+  fEvt->Branch("genType", &fEvtRow.genType);
+  fEvt->Branch("processName", &fEvtRow.processName);
+  fEvt->Branch("initPDG", &fEvtRow.initPDG, "initPDG/I");
+  fEvt->Branch("initX", &fEvtRow.initX, "initX/D");
+  fEvt->Branch("initY", &fEvtRow.initY, "initY/D");
+  fEvt->Branch("initZ", &fEvtRow.initZ, "initZ/D");
+  fEvt->Branch("initT", &fEvtRow.initT, "initT/D");
+  fEvt->Branch("initPx", &fEvtRow.initPx, "initPx/D");
+  fEvt->Branch("initPy", &fEvtRow.initPy, "initPy/D");
+  fEvt->Branch("initPz", &fEvtRow.initPz, "initPz/D"); 
+  fEvt->Branch("initE", &fEvtRow.initE, "initE/D");
+  fEvt->Branch("initM", &fEvtRow.initM, "initM/D");
+  fEvt->Branch("initQ", &fEvtRow.initQ, "initQ/D");
+  fEvt->Branch("intType", &fEvtRow.intType, "intType/I");
+  fEvt->Branch("scatteringType", &fEvtRow.scatteringType, "scatteringType/I");
+  fEvt->Branch("fslPDG", &fEvtRow.fslPDG, "fslPDG/I");
+  fEvt->Branch("tgtPDG", &fEvtRow.tgtPDG, "tgtPDG/I");
+  fEvt->Branch("tgtA", &fEvtRow.tgtA, "tgtA/I");
+  fEvt->Branch("tgtZ", &fEvtRow.tgtZ, "tgtZ/I");
+  fEvt->Branch("hitnucPDG", &fEvtRow.hitnucPDG, "hitnucPDG/I");
+  fEvt->Branch("xs", &fEvtRow.xs, "xs/D");
+  fEvt->Branch("Q2", &fEvtRow.Q2, "Q2/D");
+  fEvt->Branch("xBj", &fEvtRow.xBj, "xBj/D");
+  fEvt->Branch("y", &fEvtRow.y, "y/D");
+  fEvt->Branch("W", &fEvtRow.W, "W/D");
 }
 
 void AnalysisManager::bookPrimTree()
 {
   fPrim = new TTree("primaries", "primaries info");
-  fPrim->Branch("evtID", &evtID, "evtID/I");
-  fPrim->Branch("vtxID", &primVtxID, "vtxID/I");
-  fPrim->Branch("PDG", &primPDG, "PDG/I");
-  fPrim->Branch("trackID", &primTrackID, "trackID/I");
-  fPrim->Branch("barcode", &primParticleID, "bardcode/I");
-  fPrim->Branch("mass", &primM, "mass/F");
-  fPrim->Branch("charge", &primQ, "charge/F");
-  fPrim->Branch("Vx", &primVx, "Vx/F"); // position
-  fPrim->Branch("Vy", &primVy, "Vy/F");
-  fPrim->Branch("Vz", &primVz, "Vz/F");
-  fPrim->Branch("Vt", &primVt, "Vt/F");
-  fPrim->Branch("Px", &primPx, "Px/F"); // momentum
-  fPrim->Branch("Py", &primPy, "Py/F");
-  fPrim->Branch("Pz", &primPz, "Pz/F");
-  fPrim->Branch("E", &primE, "E/F");    // initial total energy
-  fPrim->Branch("KE", &primKE, "KE/F"); // initial kinetic energy
-  fPrim->Branch("Eta", &primEta, "Eta/F");
-  fPrim->Branch("Phi", &primPhi, "Phi/F");
-  fPrim->Branch("Pt", &primPt, "Pt/F");
-  fPrim->Branch("P", &primP, "P/F");
+  fPrim->Branch("evtID", &fOutEvtID, "evtID/I");
+  fPrim->Branch("vtxID", &fPrimRow.primVtxID, "vtxID/I");
+  fPrim->Branch("PDG", &fPrimRow.primPDG, "PDG/I");
+  fPrim->Branch("trackID", &fPrimRow.primTrackID, "trackID/I");
+  fPrim->Branch("barcode", &fPrimRow.primParticleID, "barcode/l");
+  fPrim->Branch("mass", &fPrimRow.primM, "mass/F");
+  fPrim->Branch("charge", &fPrimRow.primQ, "charge/F");
+  fPrim->Branch("Vx", &fPrimRow.primVx, "Vx/F"); // position
+  fPrim->Branch("Vy", &fPrimRow.primVy, "Vy/F");
+  fPrim->Branch("Vz", &fPrimRow.primVz, "Vz/F");
+  fPrim->Branch("Vt", &fPrimRow.primVt, "Vt/F");
+  fPrim->Branch("Px", &fPrimRow.primPx, "Px/F"); // momentum
+  fPrim->Branch("Py", &fPrimRow.primPy, "Py/F");
+  fPrim->Branch("Pz", &fPrimRow.primPz, "Pz/F");
+  fPrim->Branch("E", &fPrimRow.primE, "E/F");    // initial total energy
+  fPrim->Branch("KE", &fPrimRow.primKE, "KE/F"); // initial kinetic energy
+  fPrim->Branch("Eta", &fPrimRow.primEta, "Eta/F");
+  fPrim->Branch("Phi", &fPrimRow.primPhi, "Phi/F");
+  fPrim->Branch("Pt", &fPrimRow.primPt, "Pt/F");
+  fPrim->Branch("P", &fPrimRow.primP, "P/F");
 }
 
 //---------------------------------------------------------------------
@@ -140,17 +169,48 @@ void AnalysisManager::bookPrimTree()
 void AnalysisManager::bookTrkTree()
 {
   fTrk = new TTree("trajectories", "trajectories info");
-  fTrk->Branch("evtID", &evtID, "evtID/I");
-  fTrk->Branch("trackTID", &trackTID, "trackTID/I");
-  fTrk->Branch("trackPID", &trackPID, "trackPID/I");
-  fTrk->Branch("trackPDG", &trackPDG, "trackPDG/I");
-  fTrk->Branch("trackKinE", &trackKinE, "trackKinE/D");
-  fTrk->Branch("trackNPoints", &trackNPoints, "trackNPoints/I");
-  fTrk->Branch("trackPointX", &trackPointX);
-  fTrk->Branch("trackPointY", &trackPointY);
-  fTrk->Branch("trackPointZ", &trackPointZ);
+  fTrk->Branch("evtID", &fOutEvtID, "evtID/I");
+  fTrk->Branch("trackTID", &fTrkRow.trackTID, "trackTID/I");
+  fTrk->Branch("trackPID", &fTrkRow.trackPID, "trackPID/I");
+  fTrk->Branch("trackPDG", &fTrkRow.trackPDG, "trackPDG/I");
+  fTrk->Branch("trackKinE", &fTrkRow.trackKinE, "trackKinE/D");
+  fTrk->Branch("trackNPoints", &fTrkRow.trackNPoints, "trackNPoints/I");
+  fTrk->Branch("trackPointX", &fTrkRow.trackPointX);
+  fTrk->Branch("trackPointY", &fTrkRow.trackPointY);
+  fTrk->Branch("trackPointZ", &fTrkRow.trackPointZ);
 }
 
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void AnalysisManager::bookPerfTree()
+{
+  // per-event timing and step counts [times in s], see PerfMonitor
+  static const char* const categories[PerfRow::kNVolumeCategories] = {"tungsten", "silicon", "scint", "other"};
+  static const char* const detectors[PerfRow::kNDetectors] = {"pixel", "scint"};
+
+  fPerf = new TTree("perf", "event loop performance");
+  fPerf->Branch("evtID", &fOutEvtID, "evtID/I");
+  fPerf->Branch("wall_time", &fPerfRow.wallTime, "wall_time/D");
+  fPerf->Branch("cpu_time", &fPerfRow.cpuTime, "cpu_time/D");
+  fPerf->Branch("n_steps", &fPerfRow.nSteps, "n_steps/l");
+  fPerf->Branch("species_pdg", &fPerfRow.speciesPDG);
+  fPerf->Branch("species_steps", &fPerfRow.speciesSteps);
+  for (int i = 0; i < PerfRow::kNVolumeCategories; ++i) {
+    TString steps = TString::Format("steps_%s", categories[i]);
+    TString time = TString::Format("time_%s", categories[i]);
+    fPerf->Branch(steps, &fPerfRow.volumeSteps[i], steps + "/l");
+    fPerf->Branch(time, &fPerfRow.volumeTime[i], time + "/D");
+  }
+  for (int i = 0; i < PerfRow::kNDetectors; ++i) {
+    TString calls = TString::Format("%s_process_hits", detectors[i]);
+    TString time = TString::Format("%s_eoe_time", detectors[i]);
+    TString hits = TString::Format("%s_hits", detectors[i]);
+    fPerf->Branch(calls, &fPerfRow.sdProcessHits[i], calls + "/l");
+    fPerf->Branch(time, &fPerfRow.sdEndOfEventTime[i], time + "/D");
+    fPerf->Branch(hits, &fPerfRow.sdHits[i], hits + "/l");
+  }
+}
 
 //---------------------------------------------------------------------
 //---------------------------------------------------------------------
@@ -167,6 +227,7 @@ void AnalysisManager::bookGeomTree()
   fGeom->Branch("pixel_Zpos", &pixelsZPos);
   fGeom->Branch("sim_flag", &simFlag, "simFlag/F");
   fGeom->Branch("scint_bar_flag", &scintBarFlag, "scintBarFlag/F");
+  fGeom->Branch("fingerprint", &geometryFingerprint, "fingerprint/l");
 }
 
 
@@ -180,30 +241,50 @@ void AnalysisManager::bookHitsTrees()
   fHits = fFile->mkdir("Hits","Hits output",kTRUE);
   fFile->cd(fHits->GetName());
 
+  // the clusters can replace the per-pixel tree
+  fPixelHitsTree = nullptr;
+  if (!fSavePixelHits)
+  {
+    fFile->cd();
+    return;
+  }
+
   //* Reco Hits Tree [i == unsigned int; F == float; l == Long unsigned 64 int]
   fPixelHitsTree = new TTree("pixelHits", "pixelHits_Tree");
-  fPixelHitsTree->Branch("event_id", &fPixelEventID, "event_id/i");
-  fPixelHitsTree->Branch("hit_rowID", &fPixelRowIDs);
-  fPixelHitsTree->Branch("hit_colID", &fPixelColIDs);
-  fPixelHitsTree->Branch("hit_layerID", &fPixelLayerIDs);
-  fPixelHitsTree->Branch("hit_pdgc", &fPixelPDGCs);
-  fPixelHitsTree->Branch("hit_trackID", &fPixelTrackIDs);
-  fPixelHitsTree->Branch("hit_parentID", &fPixelParentIDs);
-  fPixelHitsTree->Branch("hit_px", &fPixelPxs);
-  fPixelHitsTree->Branch("hit_py", &fPixelPys);
-  fPixelHitsTree->Branch("hit_pz", &fPixelPzs);
-  fPixelHitsTree->Branch("hit_energy", &fPixelEnergies);
-  fPixelHitsTree->Branch("hit_charge", &fPixelCharges);
-  fPixelHitsTree->Branch("hit_edep", & fPixelEDep);
+  fPixelHitsTree->Branch("event_id", &fPixelHitsRow.eventID, "event_id/i");
+  if (fSavePackedChannel)
+  {
+    // one 64-bit word per hit instead of three index branches
+    fPixelHitsTree->Branch("hit_channel", &fPixelHitsRow.channels);
+  }
+  else
+  {
+    fPixelHitsTree->Branch("hit_rowID", &fPixelHitsRow.rowIDs);
+    fPixelHitsTree->Branch("hit_colID", &fPixelHitsRow.colIDs);
+    fPixelHitsTree->Branch("hit_layerID", &fPixelHitsRow.layerIDs);
+  }
+  fPixelHitsTree->Branch("hit_pdgc", &fPixelHitsRow.pdgCodes);
+  fPixelHitsTree->Branch("hit_trackID", &fPixelHitsRow.trackIDs);
+  fPixelHitsTree->Branch("hit_parentID", &fPixelHitsRow.parentIDs);
+  fPixelHitsTree->Branch("hit_px", &fPixelHitsRow.pxs);
+  fPixelHitsTree->Branch("hit_py", &fPixelHitsRow.pys);
+  fPixelHitsTree->Branch("hit_pz", &fPixelHitsRow.pzs);
+  fPixelHitsTree->Branch("hit_energy", &fPixelHitsRow.energies);
+  fPixelHitsTree->Branch("hit_charge", &fPixelHitsRow.charges);
+  fPixelHitsTree->Branch("hit_edep", &fPixelHitsRow.edeps);
   // fPixelHitsTree->Branch("hit_fromPrimaryPizero", &fPixelFromPrimaryPizero);
   // fPixelHitsTree->Branch("hit_fromFSLPizero", &fPixelFromFSLPizero);
-  fPixelHitsTree->Branch("hit_fromPrimaryLepton", &fPixelFromPrimaryLepton);
+  fPixelHitsTree->Branch("hit_fromPrimaryLepton", &fPixelHitsRow.fromPrimaryLepton);
+  // hits of track t: track_hit_indices[track_hit_offsets[t] .. track_hit_offsets[t + 1])
+  fPixelHitsTree->Branch("track_hit_offsets", &fPixelHitsRow.trackHitOffsets);
+  fPixelHitsTree->Branch("track_hit_indices", &fPixelHitsRow.trackHitIndices);
+  if (fSaveActs) fPixelHitsTree->Branch("hit_barcode", &fPixelHitsRow.barcodes);
 
   if (fSaveTruthHits)
   {
-    fPixelHitsTree->Branch("hit_truth_x", &fPixelTruthX);
-    fPixelHitsTree->Branch("hit_truth_y", &fPixelTruthY);
-    fPixelHitsTree->Branch("hit_truth_z", &fPixelTruthZ);
+    fPixelHitsTree->Branch("hit_truth_x", &fPixelHitsRow.truthX);
+    fPixelHitsTree->Branch("hit_truth_y", &fPixelHitsRow.truthY);
+    fPixelHitsTree->Branch("hit_truth_z", &fPixelHitsRow.truthZ);
   }
 
   fFile->cd();
@@ -216,14 +297,147 @@ void AnalysisManager::bookScintTrees()
 
     fScintTree = new TTree("scintHits", "scintillator hits");
 
-    fScintTree->Branch("event_id", &fScintEventID, "event_id/i");
-    fScintTree->Branch("layerID", &fScintLayerID);
-    fScintTree->Branch("trackID", &fScintTrackID);
-    fScintTree->Branch("parentID", &fScintParentID);
-    fScintTree->Branch("pdg", &fScintPDG);
-    fScintTree->Branch("edep", &fScintEdep);
-    fScintTree->Branch("fromMuon", &fScintFromMuon);
-    fScintTree->Branch("fromPrimaryLepton", &fScintFromPrimaryLepton);
+    fScintTree->Branch("event_id", &fScintRow.eventID, "event_id/i");
+    fScintTree->Branch("layerID", &fScintRow.layerID);
+    fScintTree->Branch("trackID", &fScintRow.trackID);
+    fScintTree->Branch("parentID", &fScintRow.parentID);
+    fScintTree->Branch("pdg", &fScintRow.pdg);
+    fScintTree->Branch("edep", &fScintRow.edep);
+    fScintTree->Branch("fromMuon", &fScintRow.fromMuon);
+    fScintTree->Branch("fromPrimaryLepton", &fScintRow.fromPrimaryLepton);
+}
+
+void AnalysisManager::bookDigiTree()
+{
+  fFile->cd(fHits->GetName());
+
+  //* Digitized pixels [charge in electrons, ToT in counts]
+  fPixelDigiTree = new TTree("pixelDigis", "pixelDigis_Tree");
+  fPixelDigiTree->Branch("event_id", &fDigiRow.eventID, "event_id/i");
+  fPixelDigiTree->Branch("digi_layerID", &fDigiRow.layerIDs);
+  fPixelDigiTree->Branch("digi_rowID", &fDigiRow.rowIDs);
+  fPixelDigiTree->Branch("digi_colID", &fDigiRow.colIDs);
+  fPixelDigiTree->Branch("digi_charge", &fDigiRow.charges);
+  fPixelDigiTree->Branch("digi_tot", &fDigiRow.tots);
+  fPixelDigiTree->Branch("digi_trackID", &fDigiRow.trackIDs);
+
+  fFile->cd();
+}
+
+void AnalysisManager::bookClusterTree()
+{
+  fFile->cd(fHits->GetName());
+
+  //* Pixel clusters [x, y, z in mm, edep in MeV]
+  fPixelClusterTree = new TTree("pixelClusters", "pixelClusters_Tree");
+  fPixelClusterTree->Branch("event_id", &fClusterRow.eventID, "event_id/i");
+  fPixelClusterTree->Branch("cluster_layerID", &fClusterRow.layerIDs);
+  fPixelClusterTree->Branch("cluster_x", &fClusterRow.xs);
+  fPixelClusterTree->Branch("cluster_y", &fClusterRow.ys);
+  fPixelClusterTree->Branch("cluster_z", &fClusterRow.zs);
+  fPixelClusterTree->Branch("cluster_size", &fClusterRow.sizes);
+  fPixelClusterTree->Branch("cluster_edep", &fClusterRow.edeps);
+  fPixelClusterTree->Branch("cluster_trackID", &fClusterRow.trackIDs);
+
+  fFile->cd();
+}
+
+void AnalysisManager::bookActsTrees()
+{
+  // create subdirectory in file, the trees follow the ACTS ROOT readers
+  fActsDir = fFile->mkdir("acts", "ACTS output", kTRUE);
+  fFile->cd(fActsDir->GetName());
+
+  //* Particles: one entry per event [mm, ns, GeV]
+  fActsParticlesTree = new TTree("particles", "particles_Tree");
+  fActsParticlesTree->Branch("event_id", &fActsParticlesRow.eventID, "event_id/i");
+  fActsParticlesTree->Branch("particle_id", &fActsParticlesRow.particleID);
+  fActsParticlesTree->Branch("particle_type", &fActsParticlesRow.particleType);
+  fActsParticlesTree->Branch("process", &fActsParticlesRow.process);
+  fActsParticlesTree->Branch("vx", &fActsParticlesRow.vx);
+  fActsParticlesTree->Branch("vy", &fActsParticlesRow.vy);
+  fActsParticlesTree->Branch("vz", &fActsParticlesRow.vz);
+  fActsParticlesTree->Branch("vt", &fActsParticlesRow.vt);
+  fActsParticlesTree->Branch("px", &fActsParticlesRow.px);
+  fActsParticlesTree->Branch("py", &fActsParticlesRow.py);
+  fActsParticlesTree->Branch("pz", &fActsParticlesRow.pz);
+  fActsParticlesTree->Branch("m", &fActsParticlesRow.m);
+  fActsParticlesTree->Branch("q", &fActsParticlesRow.q);
+  fActsParticlesTree->Branch("eta", &fActsParticlesRow.eta);
+  fActsParticlesTree->Branch("phi", &fActsParticlesRow.phi);
+  fActsParticlesTree->Branch("pt", &fActsParticlesRow.pt);
+  fActsParticlesTree->Branch("p", &fActsParticlesRow.p);
+  fActsParticlesTree->Branch("vertex_primary", &fActsParticlesRow.vertexPrimary);
+  fActsParticlesTree->Branch("vertex_secondary", &fActsParticlesRow.vertexSecondary);
+  fActsParticlesTree->Branch("particle", &fActsParticlesRow.particle);
+  fActsParticlesTree->Branch("generation", &fActsParticlesRow.generation);
+  fActsParticlesTree->Branch("sub_particle", &fActsParticlesRow.subParticle);
+
+  //* Simulated hits: one entry per hit [mm, ns, GeV]
+  fActsHitsTree = new TTree("hits", "hits_Tree");
+  fActsHitsTree->Branch("event_id", &fActsHitRow.eventID, "event_id/i");
+  fActsHitsTree->Branch("geometry_id", &fActsHitRow.geometryID, "geometry_id/l");
+  fActsHitsTree->Branch("particle_id", &fActsHitRow.particleID, "particle_id/l");
+  fActsHitsTree->Branch("tx", &fActsHitRow.tx, "tx/F");
+  fActsHitsTree->Branch("ty", &fActsHitRow.ty, "ty/F");
+  fActsHitsTree->Branch("tz", &fActsHitRow.tz, "tz/F");
+  fActsHitsTree->Branch("tt", &fActsHitRow.tt, "tt/F");
+  fActsHitsTree->Branch("tpx", &fActsHitRow.tpx, "tpx/F");
+  fActsHitsTree->Branch("tpy", &fActsHitRow.tpy, "tpy/F");
+  fActsHitsTree->Branch("tpz", &fActsHitRow.tpz, "tpz/F");
+  fActsHitsTree->Branch("te", &fActsHitRow.te, "te/F");
+  fActsHitsTree->Branch("deltapx", &fActsHitRow.deltapx, "deltapx/F");
+  fActsHitsTree->Branch("deltapy", &fActsHitRow.deltapy, "deltapy/F");
+  fActsHitsTree->Branch("deltapz", &fActsHitRow.deltapz, "deltapz/F");
+  fActsHitsTree->Branch("deltae", &fActsHitRow.deltae, "deltae/F");
+  fActsHitsTree->Branch("index", &fActsHitRow.index, "index/I");
+  fActsHitsTree->Branch("volume_id", &fActsHitRow.volumeID, "volume_id/i");
+  fActsHitsTree->Branch("boundary_id", &fActsHitRow.boundaryID, "boundary_id/i");
+  fActsHitsTree->Branch("layer_id", &fActsHitRow.layerID, "layer_id/i");
+  fActsHitsTree->Branch("approach_id", &fActsHitRow.approachID, "approach_id/i");
+  fActsHitsTree->Branch("sensitive_id", &fActsHitRow.sensitiveID, "sensitive_id/i");
+
+  //* Measurements: one entry per pixel hit [mm, ns]
+  fActsMeasurementsTree = new TTree("measurements", "measurements_Tree");
+  fActsMeasurementsTree->Branch("event_id", &fActsMeasurementRow.eventID, "event_id/i");
+  fActsMeasurementsTree->Branch("measurement_id", &fActsMeasurementRow.measurementID, "measurement_id/l");
+  fActsMeasurementsTree->Branch("geometry_id", &fActsMeasurementRow.geometryID, "geometry_id/l");
+  fActsMeasurementsTree->Branch("local_key", &fActsMeasurementRow.localKey, "local_key/i");
+  fActsMeasurementsTree->Branch("local0", &fActsMeasurementRow.local0, "local0/F");
+  fActsMeasurementsTree->Branch("local1", &fActsMeasurementRow.local1, "local1/F");
+  fActsMeasurementsTree->Branch("phi", &fActsMeasurementRow.phi, "phi/F");
+  fActsMeasurementsTree->Branch("theta", &fActsMeasurementRow.theta, "theta/F");
+  fActsMeasurementsTree->Branch("time", &fActsMeasurementRow.time, "time/F");
+  fActsMeasurementsTree->Branch("var_local0", &fActsMeasurementRow.varLocal0, "var_local0/F");
+  fActsMeasurementsTree->Branch("var_local1", &fActsMeasurementRow.varLocal1, "var_local1/F");
+  fActsMeasurementsTree->Branch("var_phi", &fActsMeasurementRow.varPhi, "var_phi/F");
+  fActsMeasurementsTree->Branch("var_theta", &fActsMeasurementRow.varTheta, "var_theta/F");
+  fActsMeasurementsTree->Branch("var_time", &fActsMeasurementRow.varTime, "var_time/F");
+  fActsMeasurementsTree->Branch("channel", &fActsMeasurementRow.channel, "channel/l");
+  fActsMeasurementsTree->Branch("channel_loc0", &fActsMeasurementRow.channelLoc0, "channel_loc0/i");
+  fActsMeasurementsTree->Branch("channel_loc1", &fActsMeasurementRow.channelLoc1, "channel_loc1/i");
+  fActsMeasurementsTree->Branch("hit_id", &fActsMeasurementRow.hitID, "hit_id/I");
+  fActsMeasurementsTree->Branch("particle_id", &fActsMeasurementRow.particleID, "particle_id/l");
+
+  fFile->cd();
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+std::string AnalysisManager::GetThreadFileName() const
+{
+  if (!G4Threading::IsWorkerThread()) return fFilename;
+
+  // insert the worker thread ID in front of the extension
+  std::string stem = fFilename;
+  std::string ext = "";
+  auto dot = fFilename.rfind('.');
+  if (dot != std::string::npos && fFilename.find('/', dot) == std::string::npos) {
+    stem = fFilename.substr(0, dot);
+    ext = fFilename.substr(dot);
+  }
+  return stem + "_t" + std::to_string(G4Threading::G4GetThreadId()) + ext;
 }
 
 //---------------------------------------------------------------------
@@ -231,23 +445,96 @@ void AnalysisManager::bookScintTrees()
 
 void AnalysisManager::BeginOfRun()
 {
-  G4cout << "Run has been started, preparing output" << G4endl;
+  fTrackTable.ResetProcesses();
+
+  // in MT mode the master runs no events: the workers own the output
+  // and the master only merges their files at the end of the run
+  if (G4Threading::IsMultithreadedApplication() && G4Threading::IsMasterThread()) {
+    G4AutoLock lock(&fWorkerFilesMutex);
+    fWorkerFiles.clear();
+    return;
+  }
+
+  LOG_INFO("Run has been started, preparing output");
 
   if (fFile)
     delete fFile;
 
+  // the trees of the previous run were owned by its file; the optional ones
+  // stay null unless they are booked again
+  fTrk = fPerf = fPixelDigiTree = fPixelClusterTree = nullptr;
+  fActsParticlesTree = fActsHitsTree = fActsMeasurementsTree = nullptr;
+
   // Preparing output file
-  fFile = new TFile(fFilename.c_str(), "RECREATE");
+  fFile = new TFile(GetThreadFileName().c_str(), "RECREATE");
+  if (fCompression >= 0) fFile->SetCompressionSettings(fCompression);
   
   // Booking common output trees
   bookEvtTree();
   bookPrimTree();
-  bookGeomTree();
+  // geometry is identical for all workers, the master adds it once after merging
+  if (!G4Threading::IsWorkerThread()) bookGeomTree();
   if (fSaveTrack) bookTrkTree();
+  fSavePerf = PerfMonitor::GetInstance()->IsEnabled();
+  if (fSavePerf) bookPerfTree();
 
   bookHitsTrees();
   bookScintTrees();
 
+  // the digitizer lives on the same thread, book its tree only if it runs
+  auto digitizer = static_cast<PixelDigitizer*>(G4DigiManager::GetDMpointer()->FindDigitizerModule("PixelDigitizer"));
+  fSaveDigis = digitizer && digitizer->IsEnabled();
+  if (fSaveDigis) bookDigiTree();
+  fSaveClusters = PixelClusterizer::GetInstance()->IsEnabled();
+  if (fSaveClusters) bookClusterTree();
+
+  // the production vertices of the tracks are only kept for the ACTS particles
+  fTrackTable.SetRecordProduction(fSaveActs);
+  fActsOutput.SetEnabled(fSaveActs);
+  fActsOutput.BeginOfRun();
+  if (fSaveActs) bookActsTrees();
+
+  for (TTree* tree : {fEvt, fPrim, fTrk, fPerf, fPixelHitsTree, fScintTree, fPixelDigiTree, fPixelClusterTree,
+                      fActsParticlesTree, fActsHitsTree, fActsMeasurementsTree})
+    ConfigureTree(tree);
+
+  // from here on the trees belong to the writer thread until EndOfRun
+  if (fAsyncQueueDepth > 0) {
+    ROOT::EnableThreadSafety();
+    fWriter = std::make_unique<OutputWriter>(fAsyncQueueDepth,
+                                             [this](OutputRecord& record) { WriteRecord(record); });
+  }
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void AnalysisManager::setCompression(const G4String& algorithm, G4int level)
+{
+  using Algorithm = ROOT::RCompressionSetting::EAlgorithm;
+
+  Algorithm::EValues alg;
+  if (algorithm == "zlib") alg = Algorithm::kZLIB;
+  else if (algorithm == "lzma") alg = Algorithm::kLZMA;
+  else if (algorithm == "lz4") alg = Algorithm::kLZ4;
+  else if (algorithm == "zstd") alg = Algorithm::kZSTD;
+  else if (algorithm == "default") { fCompression = -1; return; }
+  else {
+    G4String err = "Unknown compression algorithm : " + algorithm;
+    G4Exception("AnalysisManager", "CompressionError", JustWarning, err.c_str());
+    return;
+  }
+
+  fCompression = ROOT::CompressionSettings(alg, level);
+}
+
+void AnalysisManager::ConfigureTree(TTree* tree)
+{
+  if (!tree) return;
+
+  // must run after all branches are booked, SetBasketSize only acts on existing ones
+  if (fBasketSize > 0) tree->SetBasketSize("*", fBasketSize);
+  if (fAutoFlush != 0) tree->SetAutoFlush(fAutoFlush);
 }
 
 //---------------------------------------------------------------------
@@ -255,23 +542,108 @@ void AnalysisManager::BeginOfRun()
 
 void AnalysisManager::EndOfRun()
 {
-  G4cout << "Run has ended, closing output" << G4endl;
+  // the master's end of run is only reached once all workers have finished
+  if (G4Threading::IsMultithreadedApplication() && G4Threading::IsMasterThread()) {
+    MergeWorkerFiles();
+    return;
+  }
+
+  LOG_INFO("Run has ended, closing output");
+
+  // flush the events still queued before the trees are written
+  if (fWriter) {
+    fWriter->Stop();
+    G4cout << "AnalysisManager: output queue was full for " << fWriter->GetNumberOfFullQueue()
+           << " of " << fWriter->GetNumberOfRecords() << " events (queue depth " << fAsyncQueueDepth << ")" << G4endl;
+    fWriter.reset();
+  }
+  fRecord.reset();
+
   // save common trees at the top of the output file
   fFile->cd();
   fEvt->Write();
   fPrim->Write();
-  FillGeomTree();
-  fGeom->Write();
+  if (!G4Threading::IsWorkerThread()) {
+    FillGeomTree();
+    fGeom->Write();
+  }
   if (fSaveTrack) fTrk->Write();
+  if (fSavePerf) fPerf->Write();
 
   fFile->cd(fHits->GetName());
-  fPixelHitsTree->Write();
+  if (fSavePixelHits) fPixelHitsTree->Write();
   fScintTree->Write();
-
-  // fActsParticlesTree->Write();
+  if (fSaveDigis) fPixelDigiTree->Write();
+  if (fSaveClusters) fPixelClusterTree->Write();
+
+  if (fSaveActs) {
+    fFile->cd(fActsDir->GetName());
+    fActsParticlesTree->Write();
+    fActsHitsTree->Write();
+    fActsMeasurementsTree->Write();
+  }
   fFile->cd(); // go back to top
 
   fFile->Close();
+
+  if (G4Threading::IsWorkerThread()) {
+    G4AutoLock lock(&fWorkerFilesMutex);
+    fWorkerFiles.emplace_back(G4Threading::G4GetThreadId(), fFile->GetName());
+  }
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void AnalysisManager::MergeWorkerFiles()
+{
+  G4AutoLock lock(&fWorkerFilesMutex);
+  if (fWorkerFiles.empty()) {
+    G4cout << "AnalysisManager: no worker output to merge" << G4endl;
+    return;
+  }
+
+  // keep the merged entries ordered by thread ID so output is reproducible;
+  // on the numeric ID, the names would put _t10 before _t2
+  std::sort(fWorkerFiles.begin(), fWorkerFiles.end(),
+            [](const WorkerFile& a, const WorkerFile& b) { return a.first < b.first; });
+
+  G4cout << "Merging " << fWorkerFiles.size() << " worker files into " << fFilename << G4endl;
+  TFileMerger merger(kFALSE);
+  merger.SetPrintLevel(0);
+  // baskets are copied as they are when the compression settings match
+  const G4bool opened = (fCompression >= 0) ? merger.OutputFile(fFilename.c_str(), "RECREATE", fCompression)
+                                            : merger.OutputFile(fFilename.c_str(), "RECREATE");
+  if (!opened) {
+    G4String err = "Cannot open merged output file : " + fFilename;
+    G4Exception("AnalysisManager", "FileError", FatalErrorInArgument, err.c_str());
+    return;
+  }
+  for (const auto& file : fWorkerFiles) merger.AddFile(file.second.c_str(), kFALSE);
+
+  if (!merger.Merge()) {
+    // leave the worker files on disk so nothing is lost
+    G4Exception("AnalysisManager", "MergeError", JustWarning,
+                "Merging of worker output failed, per-thread files are kept");
+    return;
+  }
+
+  if (!fKeepWorkerFiles) {
+    for (const auto& file : fWorkerFiles) gSystem->Unlink(file.second.c_str());
+  }
+  fWorkerFiles.clear();
+
+  // the geometry tree is written once, by the master
+  fFile = new TFile(fFilename.c_str(), "UPDATE");
+  if (fCompression >= 0) fFile->SetCompressionSettings(fCompression);
+  bookGeomTree();
+  FillGeomTree();
+  fGeom->Write();
+  fFile->Close();
+  // the geometry tree went with the file
+  delete fFile;
+  fFile = nullptr;
+  fGeom = nullptr;
 }
 
 //---------------------------------------------------------------------
@@ -279,7 +651,7 @@ void AnalysisManager::EndOfRun()
 
 void AnalysisManager::BeginOfEvent()
 {
-  G4cout << "Starting new event, resetting variables" << G4endl;
+  LOG_DEBUG("Starting new event, resetting variables");
   // reset vectors that need to be cleared for a new event
   // only reset arrays or vectors, tipically no need for other defaults
 
@@ -287,40 +659,11 @@ void AnalysisManager::BeginOfEvent()
   primaryIDs.clear();
 
   // track ID to primary ancestor association
-  trackToPrimaryAncestor.clear();
-
-  trackPointX.clear();
-  trackPointY.clear();
-  trackPointZ.clear();
-
-  fPixelRowIDs.clear();
-  fPixelColIDs.clear();
-  fPixelLayerIDs.clear();
-  fPixelPDGCs.clear();
-  fPixelTrackIDs.clear();
-  fPixelTrackIDs.clear();
-  fPixelPxs.clear();
-  fPixelPys.clear();
-  fPixelPzs.clear();
-  fPixelEnergies.clear();
-  fPixelCharges.clear();
-  fPixelEDep.clear();
-  // fPixelFromPrimaryPizero.clear();
-  // fPixelFromFSLPizero.clear();
-  fPixelFromPrimaryLepton.clear();
-  fPixelTruthX.clear();
-  fPixelTruthY.clear();
-  fPixelTruthZ.clear();
-
-  //clean scintillator hits
-  //// --- NEW FOR SCINTILLATORS ---
-  fScintLayerID.clear();
-  fScintTrackID.clear();
-  fScintParentID.clear();
-  fScintPDG.clear();
-  fScintEdep.clear();
-  fScintFromMuon.clear();
-  fScintFromPrimaryLepton.clear();
+  fTrackTable.Clear();
+
+  // the previous record is either written already or owned by the writer
+  if (!fRecord) fRecord = fWriter ? fWriter->Acquire() : std::make_unique<OutputRecord>();
+  fRecord->clear();
 }
 
 //---------------------------------------------------------------------
@@ -328,9 +671,13 @@ void AnalysisManager::BeginOfEvent()
 
 void AnalysisManager::EndOfEvent(const G4Event *event)
 {
-  G4cout << "Ending event, filling output trees" << G4endl;
+  LOG_DEBUG("Ending event, filling output trees");
   /// evtID
   evtID = event->GetEventID();
+  fRecord->evtID = evtID;
+
+  // the counters of this event are complete once EventAction stopped the clocks
+  if (fSavePerf) fRecord->perf = PerfMonitor::GetInstance()->GetRow();
 
   // FILL EVENT TREE
   FillEventTree(event);
@@ -341,6 +688,9 @@ void AnalysisManager::EndOfEvent(const G4Event *event)
   FillPrimariesTree(event);
   if(fSaveTrack) FillTrajectoriesTree(event);
 
+  // before the hits, which carry the barcodes
+  if (fSaveActs) fActsOutput.AssignBarcodes(event, fTrackTable);
+
   //-----------------------------------------------------------
 
   // Get the hit collections
@@ -348,12 +698,82 @@ void AnalysisManager::EndOfEvent(const G4Event *event)
   fHCofEvent = event->GetHCofThisEvent();
   if (!fHCofEvent)
   {
-    G4cout << "No hits recorded in any sensitive volume --> nothing to save!" << G4endl;
-    return;
+    LOG_DEBUG("No hits recorded in any sensitive volume --> nothing to save!");
+  }
+  else
+  {
+    fRecord->hasHits = true;
+    if (fSavePixelHits) FillHitsOutput();
+    FillScintOutput();
+    if (fSaveDigis) FillDigiOutput(event);
+    if (fSaveClusters) FillClusterOutput();
   }
+  if (fSaveActs) FillActsOutput();
 
-  FillHitsOutput();
-  FillScintOutput();
+  // hand the record over: tracking of the next event does not wait for ROOT
+  if (fWriter) fWriter->Push(std::move(fRecord));
+  else WriteRecord(*fRecord);
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void AnalysisManager::WriteRecord(OutputRecord& record)
+{
+  // rows are swapped into the branch buffers, the record gets the old
+  // buffers back and reuses their capacity once it is recycled
+  fOutEvtID = record.evtID;
+
+  for (auto& row : record.events) {
+    std::swap(fEvtRow, row);
+    fEvt->Fill();
+  }
+  for (auto& row : record.primaries) {
+    std::swap(fPrimRow, row);
+    fPrim->Fill();
+  }
+  if (fSaveTrack) {
+    for (auto& row : record.trajectories) {
+      std::swap(fTrkRow, row);
+      fTrk->Fill();
+    }
+  }
+
+  if (fSavePerf) {
+    std::swap(fPerfRow, record.perf);
+    fPerf->Fill();
+  }
+
+  // every event has a particles entry, hits and measurements may be empty
+  if (fSaveActs) {
+    std::swap(fActsParticlesRow, record.actsParticles);
+    fActsParticlesTree->Fill();
+    for (const auto& row : record.actsHits) {
+      fActsHitRow = row;
+      fActsHitsTree->Fill();
+    }
+    for (const auto& row : record.actsMeasurements) {
+      fActsMeasurementRow = row;
+      fActsMeasurementsTree->Fill();
+    }
+  }
+
+  if (!record.hasHits) return;
+
+  if (fSavePixelHits) {
+    std::swap(fPixelHitsRow, record.pixelHits);
+    fPixelHitsTree->Fill();
+  }
+  std::swap(fScintRow, record.scintHits);
+  fScintTree->Fill();
+  if (fSaveDigis) {
+    std::swap(fDigiRow, record.pixelDigis);
+    fPixelDigiTree->Fill();
+  }
+  if (fSaveClusters) {
+    std::swap(fClusterRow, record.pixelClusters);
+    fPixelClusterTree->Fill();
+  }
 }
 
 //---------------------------------------------------------------------
@@ -361,41 +781,40 @@ void AnalysisManager::EndOfEvent(const G4Event *event)
 
 void AnalysisManager::FillEventTree(const G4Event *event)
 {
-  G4cout << "Filling event tree" << G4endl;
+  LOG_DEBUG("Filling event tree");
   EventInformation* eventInfo = static_cast<EventInformation*>(event->GetUserInformation());
-  eventInfo->Print();
+  if (Logging::IsEnabled(Logging::kDebug)) eventInfo->Print();
   auto metadata = eventInfo->GetEventMetadata();
   for(int i=0; i<metadata.size(); i++)
   {
-    vertexID = i;
-    weight = metadata[i].weight;
-    genType = metadata[i].generatorType;
-    processName = metadata[i].processName;
-    initPDG = metadata[i].pdg;
-    initX = metadata[i].x4.x();
-    initY = metadata[i].x4.y();
-    initZ = metadata[i].x4.z();
-    initT = metadata[i].x4.t();
-    initPx = metadata[i].p4.x();
-    initPy = metadata[i].p4.y();
-    initPz = metadata[i].p4.z();
-    initE = metadata[i].p4.e();
-    initM = metadata[i].mass;
-    initQ = metadata[i].charge;
-    intType = metadata[i].intType;     
-    scatteringType = metadata[i].scatteringType;   
-    fslPDG = metadata[i].fsl_pdg;           
-    tgtPDG = metadata[i].tgt_pdg;  
-    tgtZ = metadata[i].tgt_Z;     
-    tgtA = metadata[i].tgt_A;     
-    hitnucPDG = metadata[i].hitnuc_pdg;  
-    xs = metadata[i].xs;
-    Q2 = metadata[i].Q2;  
-    xBj = metadata[i].xBj;
-    y = metadata[i].y; 
-    W = metadata[i].W; 
-
-    fEvt->Fill();
+    EventRow& row = fRecord->events.emplace_back();
+    row.vertexID = i;
+    row.weight = metadata[i].weight;
+    row.genType = metadata[i].generatorType;
+    row.processName = metadata[i].processName;
+    row.initPDG = metadata[i].pdg;
+    row.initX = metadata[i].x4.x();
+    row.initY = metadata[i].x4.y();
+    row.initZ = metadata[i].x4.z();
+    row.initT = metadata[i].x4.t();
+    row.initPx = metadata[i].p4.x();
+    row.initPy = metadata[i].p4.y();
+    row.initPz = metadata[i].p4.z();
+    row.initE = metadata[i].p4.e();
+    row.initM = metadata[i].mass;
+    row.initQ = metadata[i].charge;
+    row.intType = metadata[i].intType;     
+    row.scatteringType = metadata[i].scatteringType;   
+    row.fslPDG = metadata[i].fsl_pdg;           
+    row.tgtPDG = metadata[i].tgt_pdg;  
+    row.tgtZ = metadata[i].tgt_Z;     
+    row.tgtA = metadata[i].tgt_A;     
+    row.hitnucPDG = metadata[i].hitnuc_pdg;  
+    row.xs = metadata[i].xs;
+    row.Q2 = metadata[i].Q2;  
+    row.xBj = metadata[i].xBj;
+    row.y = metadata[i].y; 
+    row.W = metadata[i].W; 
   }
 }
 
@@ -404,72 +823,67 @@ void AnalysisManager::FillEventTree(const G4Event *event)
 
 void AnalysisManager::FillPrimariesTree(const G4Event *event)
 {
-  G4cout << "Filling primaries tree" << G4endl;
+  LOG_DEBUG("Filling primaries tree");
   nPrimaryVertex = event->GetNumberOfPrimaryVertex();
-  G4cout << "\nNumber of primary vertices  : " << nPrimaryVertex << G4endl;
+  LOG_DEBUG("\nNumber of primary vertices  : " << nPrimaryVertex);
+
+  // Geant4 numbers the primary tracks from 1 over all vertices
+  G4int primaryTrackID = 0;
   
   /// loop over the vertices, and then over primary particles,
   /// neutrino truth info from event generator.
   for (G4int ivtx = 0; ivtx < event->GetNumberOfPrimaryVertex(); ++ivtx)
   {
-    G4cout << "=== Vertex " << ivtx+1 << " of " << nPrimaryVertex << " -> " 
-           << event->GetPrimaryVertex(ivtx)->GetNumberOfParticle() << " primaries ===" << G4endl;
+    LOG_DEBUG("=== Vertex " << ivtx+1 << " of " << nPrimaryVertex << " -> " 
+              << event->GetPrimaryVertex(ivtx)->GetNumberOfParticle() << " primaries ===");
     for (G4int ipp = 0; ipp < event->GetPrimaryVertex(ivtx)->GetNumberOfParticle(); ++ipp)
     {
       G4PrimaryParticle *primary_particle = event->GetPrimaryVertex(ivtx)->GetPrimary(ipp);
       if (primary_particle)
       {
- 
-        primVtxID = ivtx;
-        primTrackID = ipp + 1; // confirm matches track id?
-
-        auto particleId = ActsFatras::Barcode();
-        particleId.setVertexPrimary(ivtx);
-        particleId.setGeneration(0);
-        particleId.setSubParticle(0);
-        particleId.setParticle(primTrackID - 1);
-
-        primParticleID = particleId.value();
-        primPDG = primary_particle->GetPDGcode();
-        primVx = event->GetPrimaryVertex(ivtx)->GetPosition().x();
-        primVy = event->GetPrimaryVertex(ivtx)->GetPosition().y();
-        primVz = event->GetPrimaryVertex(ivtx)->GetPosition().z();
-        primVt = event->GetPrimaryVertex(ivtx)->GetT0();
-        primPx = primary_particle->GetMomentum().x();
-        primPy = primary_particle->GetMomentum().y();
-        primPz = primary_particle->GetMomentum().z();
-        primM = primary_particle->GetMass()/MeV;
-        primQ = primary_particle->GetCharge();
-
-        G4double energy = GetTotalEnergy(primPx, primPy, primPz, primM);
-        G4LorentzVector p4(primPx,primPy,primPz,energy);
-        primEta = p4.eta();
-        primPhi = p4.phi();
-        primPt = p4.perp();
-        primP = p4.vect().mag();
-        primE = energy;
-        primKE = energy - primM;
+        PrimaryRow& row = fRecord->primaries.emplace_back();
+
+        row.primVtxID = ivtx;
+        row.primTrackID = ++primaryTrackID;
+        // same barcode as in the ACTS particles
+        row.primParticleID = ActsOutput::PrimaryBarcode(ivtx, ipp).value();
+        row.primPDG = primary_particle->GetPDGcode();
+        row.primVx = event->GetPrimaryVertex(ivtx)->GetPosition().x();
+        row.primVy = event->GetPrimaryVertex(ivtx)->GetPosition().y();
+        row.primVz = event->GetPrimaryVertex(ivtx)->GetPosition().z();
+        row.primVt = event->GetPrimaryVertex(ivtx)->GetT0();
+        row.primPx = primary_particle->GetMomentum().x();
+        row.primPy = primary_particle->GetMomentum().y();
+        row.primPz = primary_particle->GetMomentum().z();
+        row.primM = primary_particle->GetMass()/MeV;
+        row.primQ = primary_particle->GetCharge();
+
+        G4double energy = GetTotalEnergy(row.primPx, row.primPy, row.primPz, row.primM);
+        G4LorentzVector p4(row.primPx,row.primPy,row.primPz,energy);
+        row.primEta = p4.eta();
+        row.primPhi = p4.phi();
+        row.primPt = p4.perp();
+        row.primP = p4.vect().mag();
+        row.primE = energy;
+        row.primKE = energy - row.primM;
 
         // store a copy as a FPFParticle for further processing
-        primaryIDs.push_back(primTrackID); //store to avoid duplicates
-        primaries.push_back(FPFParticle(primPDG, 0, 
-		                        primTrackID, primaryIDs.size()-1, 1,
-		                        primM,
-                            primVx, primVy, primVz, primVt,
-                            primPx, primPy, primPz,energy));
-
-        G4cout << G4endl;
-        G4cout << "PrimaryParticleInfo: PDG code " << primPDG << G4endl
-          << "Particle unique ID : " << primTrackID << G4endl
-          << "Momentum : (" << primPx << ", " << primPy << ", " << primPz << ") MeV" << G4endl
-          << "Vertex : (" << primVx << ", " << primVy << ", " << primVz << ") mm" << G4endl;
-
-        fPrim->Fill();
+        primaryIDs.push_back(row.primTrackID); //store to avoid duplicates
+        primaries.push_back(FPFParticle(row.primPDG, 0, 
+		                        row.primTrackID, primaryIDs.size()-1, 1,
+		                        row.primM,
+                            row.primVx, row.primVy, row.primVz, row.primVt,
+                            row.primPx, row.primPy, row.primPz,energy));
+
+        LOG_DEBUG("\nPrimaryParticleInfo: PDG code " << row.primPDG << G4endl
+          << "Particle unique ID : " << row.primTrackID << G4endl
+          << "Momentum : (" << row.primPx << ", " << row.primPy << ", " << row.primPz << ") MeV" << G4endl
+          << "Vertex : (" << row.primVx << ", " << row.primVy << ", " << row.primVz << ") mm");
       }
     }
   }
 
-  G4cout << "\nNumber of primaries  : " << primaryIDs.size() << G4endl;
+  LOG_DEBUG("\nNumber of primaries  : " << primaryIDs.size());
 }
 
 //---------------------------------------------------------------------
@@ -477,39 +891,36 @@ void AnalysisManager::FillPrimariesTree(const G4Event *event)
 
 void AnalysisManager::FillTrajectoriesTree(const G4Event* event)
 {
-  G4cout << "Filling trajectories tree" << G4endl;
+  LOG_DEBUG("Filling trajectories tree");
   int count_tracks = 0;
 
-  G4cout << "==== Saving track information to tree ====" << G4endl; 
+  LOG_DEBUG("==== Saving track information to tree ====");
   auto trajectoryContainer = event->GetTrajectoryContainer(); 
   if (!trajectoryContainer)
   {
-    G4cout << "No tracks found: did you enable their storage with '/tracking/storeTrajectory 1'?" << G4endl;
+    LOG_WARNING("No tracks found: did you enable their storage with '/tracking/storeTrajectory 1'?");
     return;
   }
 
   for (size_t i = 0; i < trajectoryContainer->entries(); ++i) 
   { 
     auto trajectory = static_cast<G4Trajectory*>((*trajectoryContainer)[i]); 
-    trackTID = trajectory->GetTrackID();
-    trackPID = trajectory->GetParentID();
-    trackPDG = trajectory->GetPDGEncoding(); 
-    trackKinE = trajectory->GetInitialKineticEnergy(); 
-    trackNPoints = trajectory->GetPointEntries(); 
+    TrajectoryRow& row = fRecord->trajectories.emplace_back();
+    row.trackTID = trajectory->GetTrackID();
+    row.trackPID = trajectory->GetParentID();
+    row.trackPDG = trajectory->GetPDGEncoding(); 
+    row.trackKinE = trajectory->GetInitialKineticEnergy(); 
+    row.trackNPoints = trajectory->GetPointEntries(); 
     count_tracks++; 
-    for (size_t j = 0; j < trackNPoints; ++j) 
+    for (size_t j = 0; j < row.trackNPoints; ++j) 
     { 
       G4ThreeVector pos = trajectory->GetPoint(j)->GetPosition(); 
-      trackPointX.push_back( pos.x() );
-      trackPointY.push_back( pos.y() );
-      trackPointZ.push_back( pos.z() );
+      row.trackPointX.push_back( pos.x() );
+      row.trackPointY.push_back( pos.y() );
+      row.trackPointZ.push_back( pos.z() );
     }
-    fTrk->Fill();
-    trackPointX.clear(); 
-    trackPointY.clear();
-    trackPointZ.clear();
   }
-  G4cout << "Total number of recorded track: " << count_tracks << std::endl;
+  LOG_DEBUG("Total number of recorded track: " << count_tracks);
 }
 
 //---------------------------------------------------------------------
@@ -529,6 +940,7 @@ void AnalysisManager::FillGeomTree()
   nLayers = det->GetNumberOfLayers();
   simFlag = det->GetSimFlag();
   scintBarFlag = det->GetScintBarFlag();
+  geometryFingerprint = det->GetGeometryFingerprint();
   
   // get pixel positions: Idea is that we can get the x,y,z of all hits by indexing into these arrays
   pixelsXPos = det->GetPixelXPositions();
@@ -543,7 +955,9 @@ void AnalysisManager::FillGeomTree()
 
 void AnalysisManager::FillHitsOutput()
 {
-  G4cout << "==== Filling Hits output trees ====" << G4endl;
+  LOG_DEBUG("==== Filling Hits output trees ====");
+  PixelHitsRow& hits = fRecord->pixelHits;
+  hits.eventID = evtID;
   int nHits = 0;
   G4int nHC = fHCofEvent->GetNumberOfCollections();
   for (G4int i = 0; i < nHC; ++i) {
@@ -551,34 +965,44 @@ void AnalysisManager::FillHitsOutput()
       auto* pixelHitCollection = dynamic_cast<PixelHitsCollection*>(hc);
       if (pixelHitCollection && pixelHitCollection->GetName() == "PixelHitsCollection") {
         
-        G4cout << "Found hit collection: " << pixelHitCollection->GetName() << G4endl;
-
-        G4cout << "Number of hits in collection: " << pixelHitCollection->GetSize() << G4endl;
+        LOG_DEBUG("Found hit collection: " << pixelHitCollection->GetName());
+        LOG_DEBUG("Number of hits in collection: " << pixelHitCollection->GetSize());
         for (auto hit : *pixelHitCollection->GetVector())
         {
           nHits++;
-          fPixelEventID = evtID;
-          fPixelRowIDs.push_back(hit->GetRowID());
-          fPixelColIDs.push_back(hit->GetColID());
-          fPixelLayerIDs.push_back(hit->GetLayerID());
-          fPixelPDGCs.push_back(hit->GetPDGCode());
-          fPixelTrackIDs.push_back(hit->GetTrackID());
-          fPixelParentIDs.push_back(hit->GetParentID());
-          fPixelPxs.push_back(hit->GetPx());
-          fPixelPys.push_back(hit->GetPy());
-          fPixelPzs.push_back(hit->GetPz());
-          fPixelEnergies.push_back(hit->GetEnergy());
-          fPixelCharges.push_back(hit->GetCharge());
-          fPixelEDep.push_back(hit->GetEnergyDeposit());
+          if (fSavePackedChannel)
+          {
+            hits.channels.push_back(PixelChannel()
+                                       .setLayer(hit->GetLayerID())
+                                       .setRow(hit->GetRowID())
+                                       .setCol(hit->GetColID())
+                                       .value());
+          }
+          else
+          {
+            hits.rowIDs.push_back(hit->GetRowID());
+            hits.colIDs.push_back(hit->GetColID());
+            hits.layerIDs.push_back(hit->GetLayerID());
+          }
+          hits.pdgCodes.push_back(hit->GetPDGCode());
+          hits.trackIDs.push_back(hit->GetTrackID());
+          hits.parentIDs.push_back(hit->GetParentID());
+          hits.pxs.push_back(hit->GetPx());
+          hits.pys.push_back(hit->GetPy());
+          hits.pzs.push_back(hit->GetPz());
+          hits.energies.push_back(hit->GetEnergy());
+          hits.charges.push_back(hit->GetCharge());
+          hits.edeps.push_back(hit->GetEnergyDeposit());
           // fPixelFromPrimaryPizero.push_back(hit->GetFromPrimaryPizero());
           // fPixelFromFSLPizero.push_back(hit->GetFromFSLPizero());
-          fPixelFromPrimaryLepton.push_back(hit->GetFromPrimaryLepton());
+          hits.fromPrimaryLepton.push_back(hit->GetFromPrimaryLepton());
+          if (fSaveActs) hits.barcodes.push_back(fActsOutput.GetBarcode(hit->GetTrackID()).value());
 
           if (fSaveTruthHits)
           {
-            fPixelTruthX.push_back(hit->GetTruthHitPos().x());
-            fPixelTruthY.push_back(hit->GetTruthHitPos().y());
-            fPixelTruthZ.push_back(hit->GetTruthHitPos().z());
+            hits.truthX.push_back(hit->GetTruthHitPos().x());
+            hits.truthY.push_back(hit->GetTruthHitPos().y());
+            hits.truthZ.push_back(hit->GetTruthHitPos().z());
           }
 
           // G4cout << "Filling hit: TrackID=" << hit->GetTrackID() 
@@ -590,17 +1014,19 @@ void AnalysisManager::FillHitsOutput()
           //        << G4endl;
 
       }
-  
-      fPixelHitsTree->Fill();
       
     } 
   } // Close loop over hit collections
+
+  hits.trackHitOffsets.assign(fTrackHitTable.GetOffsets().begin(), fTrackHitTable.GetOffsets().end());
+  hits.trackHitIndices.assign(fTrackHitTable.GetIndices().begin(), fTrackHitTable.GetIndices().end());
 }
 
 //// --- NEW FOR SCINTILLATORS ---
 void AnalysisManager::FillScintOutput()
 {
-    fScintEventID = evtID;
+    ScintHitsRow& scint = fRecord->scintHits;
+    scint.eventID = evtID;
 
     G4int nHC = fHCofEvent->GetNumberOfCollections();
 
@@ -615,17 +1041,142 @@ void AnalysisManager::FillScintOutput()
         {
             auto* hit = (*scintHC)[h];
 
-            fScintLayerID.push_back(hit->GetLayerID());
-            fScintTrackID.push_back(hit->GetTrackID());
-            fScintParentID.push_back(hit->GetParentID());
-            fScintPDG.push_back(hit->GetPDGCode());
-            fScintEdep.push_back(hit->GetEnergyDeposit());
-            fScintFromMuon.push_back(hit->GetFromMuon());
-            fScintFromPrimaryLepton.push_back(hit->GetFromPrimaryLepton());
+            scint.layerID.push_back(hit->GetLayerID());
+            scint.trackID.push_back(hit->GetTrackID());
+            scint.parentID.push_back(hit->GetParentID());
+            scint.pdg.push_back(hit->GetPDGCode());
+            scint.edep.push_back(hit->GetEnergyDeposit());
+            scint.fromMuon.push_back(hit->GetFromMuon());
+            scint.fromPrimaryLepton.push_back(hit->GetFromPrimaryLepton());
         }
     }
+}
+
+void AnalysisManager::FillDigiOutput(const G4Event* event)
+{
+  PixelDigisRow& digis = fRecord->pixelDigis;
+  digis.eventID = evtID;
+
+  G4DCofThisEvent* dce = event->GetDCofThisEvent();
+  if (dce) {
+    for (G4int i = 0; i < dce->GetNumberOfCollections(); ++i) {
+      auto* digiCollection = dynamic_cast<PixelDigiCollection*>(dce->GetDC(i));
+      if (!digiCollection) continue;
+
+      for (auto digi : *digiCollection->GetVector()) {
+        digis.layerIDs.push_back(digi->GetLayerID());
+        digis.rowIDs.push_back(digi->GetRowID());
+        digis.colIDs.push_back(digi->GetColID());
+        digis.charges.push_back(digi->GetCharge());
+        digis.tots.push_back(digi->GetToT());
+        digis.trackIDs.push_back(digi->GetTrackID());
+      }
+    }
+  }
+}
 
-    fScintTree->Fill();
+void AnalysisManager::FillClusterOutput()
+{
+  // the clusters were formed by PixelSD at the end of the event
+  PixelClustersRow& clusters = fRecord->pixelClusters;
+  clusters.eventID = evtID;
+
+  for (const auto& cluster : PixelClusterizer::GetInstance()->GetClusters()) {
+    clusters.layerIDs.push_back(cluster.layerID);
+    clusters.xs.push_back(cluster.x / mm);
+    clusters.ys.push_back(cluster.y / mm);
+    clusters.zs.push_back(cluster.z / mm);
+    clusters.sizes.push_back(cluster.size);
+    clusters.edeps.push_back(cluster.edep / MeV);
+    clusters.trackIDs.push_back(cluster.trackID);
+  }
+}
+
+void AnalysisManager::FillActsOutput()
+{
+  // the simulated hits were made by PixelSD, the barcodes assigned above
+  ActsParticlesRow& particles = fRecord->actsParticles;
+  particles.eventID = evtID;
+  for (G4int trackID : fActsOutput.GetParticles()) {
+    const TrackTable::Production* production = fTrackTable.GetProduction(trackID);
+    if (!production) continue;
+    const ActsFatras::Barcode barcode = fActsOutput.GetBarcode(trackID);
+    const G4ThreeVector& momentum = production->momentum;
+
+    particles.particleID.push_back(barcode.value());
+    particles.particleType.push_back(fTrackTable.Get(trackID).pdg);
+    particles.process.push_back(production->process);
+    particles.vx.push_back(production->position.x() / mm);
+    particles.vy.push_back(production->position.y() / mm);
+    particles.vz.push_back(production->position.z() / mm);
+    particles.vt.push_back(production->time / ns);
+    particles.px.push_back(momentum.x() / GeV);
+    particles.py.push_back(momentum.y() / GeV);
+    particles.pz.push_back(momentum.z() / GeV);
+    particles.m.push_back(production->mass / GeV);
+    particles.q.push_back(production->charge / eplus);
+    particles.eta.push_back(momentum.eta());
+    particles.phi.push_back(momentum.phi());
+    particles.pt.push_back(momentum.perp() / GeV);
+    particles.p.push_back(momentum.mag() / GeV);
+    particles.vertexPrimary.push_back(barcode.vertexPrimary());
+    particles.vertexSecondary.push_back(barcode.vertexSecondary());
+    particles.particle.push_back(barcode.particle());
+    particles.generation.push_back(barcode.generation());
+    particles.subParticle.push_back(barcode.subParticle());
+  }
+
+  for (const auto& hit : fActsOutput.GetSimHits()) {
+    const GeometryId geometryId = GeometryId::ForPlane(hit.layerID);
+    ActsHitRow& row = fRecord->actsHits.emplace_back();
+    row.eventID = evtID;
+    row.geometryID = geometryId.value();
+    row.particleID = fActsOutput.GetBarcode(hit.trackID).value();
+    row.tx = hit.position.x() / mm;
+    row.ty = hit.position.y() / mm;
+    row.tz = hit.position.z() / mm;
+    row.tt = hit.time / ns;
+    row.tpx = hit.p4.px() / GeV;
+    row.tpy = hit.p4.py() / GeV;
+    row.tpz = hit.p4.pz() / GeV;
+    row.te = hit.p4.e() / GeV;
+    // only the deposit in the silicon is known, not the full energy loss
+    row.deltapx = row.deltapy = row.deltapz = 0.;
+    row.deltae = -hit.edep / GeV;
+    row.index = hit.index;
+    row.volumeID = geometryId.volume();
+    row.boundaryID = geometryId.boundary();
+    row.layerID = geometryId.layer();
+    row.approachID = geometryId.approach();
+    row.sensitiveID = geometryId.sensitive();
+  }
+
+  // one measurement per pixel hit: the pixel centre in the plane
+  if (!fHCofEvent) return;
+  ULong64_t measurementID = 0;
+  for (G4int i = 0; i < fHCofEvent->GetNumberOfCollections(); ++i) {
+    auto* pixelHitCollection = dynamic_cast<PixelHitsCollection*>(fHCofEvent->GetHC(i));
+    if (!pixelHitCollection || pixelHitCollection->GetName() != "PixelHitsCollection") continue;
+
+    for (auto hit : *pixelHitCollection->GetVector()) {
+      ActsMeasurementRow& row = fRecord->actsMeasurements.emplace_back();
+      row.eventID = evtID;
+      row.measurementID = measurementID++;
+      row.geometryID = GeometryId::ForPlane(hit->GetLayerID()).value();
+      row.localKey = 0x3;  // local0 and local1
+      row.local0 = fActsOutput.GetPixelX(hit->GetRowID()) / mm;
+      row.local1 = fActsOutput.GetPixelY(hit->GetColID()) / mm;
+      row.phi = row.theta = row.time = 0.;
+      row.varLocal0 = fActsOutput.GetVarianceX() / (mm * mm);
+      row.varLocal1 = fActsOutput.GetVarianceY() / (mm * mm);
+      row.varPhi = row.varTheta = row.varTime = 0.;
+      row.channel = PixelChannel().setLayer(hit->GetLayerID()).setRow(hit->GetRowID()).setCol(hit->GetColID()).value();
+      row.channelLoc0 = hit->GetRowID();
+      row.channelLoc1 = hit->GetColID();
+      row.hitID = fActsOutput.FindSimHit(hit->GetTrackID(), hit->GetLayerID());
+      row.particleID = fActsOutput.GetBarcode(hit->GetTrackID()).value();
+    }
+  }
 }
 
 float_t AnalysisManager::GetTotalEnergy(float_t px, float_t py, float_t pz, float_t m)
@@ -27,7 +27,7 @@
 
 #include "AnalysisManagerMessenger.hh"
 
-//#include <sstream>
+#include <sstream>
 
 #include "AnalysisManager.hh"
 #include "G4UIdirectory.hh"
@@ -59,6 +59,64 @@
   fSaveTruthHitsCmd->SetParameterName("saveTruthHits", true);
   fSaveTruthHitsCmd->SetDefaultValue(false);
 
+  fKeepWorkerFilesCmd = new G4UIcmdWithABool("/out/keepWorkerFiles", this);
+  fKeepWorkerFilesCmd->SetGuidance("MT only: keep the per-thread files after they are merged");
+  fKeepWorkerFilesCmd->SetParameterName("keepWorkerFiles", true);
+  fKeepWorkerFilesCmd->SetDefaultValue(false);
+
+  fCompressionCmd = new G4UIcommand("/out/compression", this);
+  fCompressionCmd->SetGuidance("set the compression algorithm and level of the output file");
+  fCompressionCmd->SetGuidance("'default' keeps the ROOT default settings");
+  G4UIparameter* algParam = new G4UIparameter("algorithm", 's', false);
+  algParam->SetParameterCandidates("zlib lzma lz4 zstd default");
+  fCompressionCmd->SetParameter(algParam);
+  G4UIparameter* levelParam = new G4UIparameter("level", 'i', true);
+  levelParam->SetDefaultValue(5);
+  levelParam->SetParameterRange("level>=0 && level<=9");
+  fCompressionCmd->SetParameter(levelParam);
+  fCompressionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBasketSizeCmd = new G4UIcmdWithAnInteger("/out/basketSize", this);
+  fBasketSizeCmd->SetGuidance("set the basket size in bytes of all output branches, 0 keeps the ROOT default");
+  fBasketSizeCmd->SetParameterName("basketSize", false);
+  fBasketSizeCmd->SetRange("basketSize>=0");
+  fBasketSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fAutoFlushCmd = new G4UIcmdWithAnInteger("/out/autoFlush", this);
+  fAutoFlushCmd->SetGuidance("set TTree::SetAutoFlush of the output trees: > 0 flush every N entries,");
+  fAutoFlushCmd->SetGuidance("< 0 flush every -N bytes, 0 keeps the ROOT default");
+  fAutoFlushCmd->SetParameterName("autoFlush", false);
+  fAutoFlushCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPackedChannelCmd = new G4UIcmdWithABool("/out/savePackedChannel", this);
+  fPackedChannelCmd->SetGuidance("write one packed 64-bit hit_channel (layer, row, col) branch");
+  fPackedChannelCmd->SetGuidance("instead of the hit_layerID, hit_rowID and hit_colID branches");
+  fPackedChannelCmd->SetParameterName("savePackedChannel", true);
+  fPackedChannelCmd->SetDefaultValue(true);
+  fPackedChannelCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSavePixelHitsCmd = new G4UIcmdWithABool("/out/savePixelHits", this);
+  fSavePixelHitsCmd->SetGuidance("write the per-pixel Hits/pixelHits tree; can be turned off when the");
+  fSavePixelHitsCmd->SetGuidance("clusters (/cluster/enable) are all that is needed downstream");
+  fSavePixelHitsCmd->SetParameterName("savePixelHits", true);
+  fSavePixelHitsCmd->SetDefaultValue(true);
+  fSavePixelHitsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fAsyncQueueDepthCmd = new G4UIcmdWithAnInteger("/out/asyncQueueDepth", this);
+  fAsyncQueueDepthCmd->SetGuidance("fill the output trees on a separate writer thread (one per worker)");
+  fAsyncQueueDepthCmd->SetGuidance("with at most this many events queued, tracking waits when the queue is full");
+  fAsyncQueueDepthCmd->SetGuidance("0 fills the trees synchronously at the end of each event");
+  fAsyncQueueDepthCmd->SetParameterName("asyncQueueDepth", false);
+  fAsyncQueueDepthCmd->SetRange("asyncQueueDepth>=0");
+  fAsyncQueueDepthCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSaveActsCmd = new G4UIcmdWithABool("/out/saveActs", this);
+  fSaveActsCmd->SetGuidance("write the acts/particles, acts/hits and acts/measurements trees read by ACTS");
+  fSaveActsCmd->SetGuidance("and a barcode for every pixel hit (hit_barcode)");
+  fSaveActsCmd->SetParameterName("saveActs", true);
+  fSaveActsCmd->SetDefaultValue(true);
+  fSaveActsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -68,6 +126,14 @@ AnalysisManagerMessenger::~AnalysisManagerMessenger()
   delete fFileCmd;
   delete fSaveTrackCmd;
   delete fSaveTruthHitsCmd;
+  delete fKeepWorkerFilesCmd;
+  delete fCompressionCmd;
+  delete fBasketSizeCmd;
+  delete fAutoFlushCmd;
+  delete fPackedChannelCmd;
+  delete fSavePixelHitsCmd;
+  delete fAsyncQueueDepthCmd;
+  delete fSaveActsCmd;
   delete fOutDir;
 }
 
@@ -78,6 +144,20 @@ void AnalysisManagerMessenger::SetNewValue(G4UIcommand* command,G4String newValu
   if (command == fFileCmd) fAnalysisManager->setFileName(newValues);
   if (command == fSaveTrackCmd) fAnalysisManager->saveTrack(fSaveTrackCmd->GetNewBoolValue(newValues));
   if (command == fSaveTruthHitsCmd) fAnalysisManager->saveTruthHits(fSaveTruthHitsCmd->GetNewBoolValue(newValues));
+  if (command == fKeepWorkerFilesCmd) fAnalysisManager->keepWorkerFiles(fKeepWorkerFilesCmd->GetNewBoolValue(newValues));
+  if (command == fCompressionCmd) {
+    G4String algorithm;
+    G4int level = 5;
+    std::istringstream is(newValues);
+    is >> algorithm >> level;
+    fAnalysisManager->setCompression(algorithm, level);
+  }
+  if (command == fBasketSizeCmd) fAnalysisManager->setBasketSize(fBasketSizeCmd->GetNewIntValue(newValues));
+  if (command == fAutoFlushCmd) fAnalysisManager->setAutoFlush(fAutoFlushCmd->GetNewIntValue(newValues));
+  if (command == fPackedChannelCmd) fAnalysisManager->savePackedChannel(fPackedChannelCmd->GetNewBoolValue(newValues));
+  if (command == fSavePixelHitsCmd) fAnalysisManager->savePixelHits(fSavePixelHitsCmd->GetNewBoolValue(newValues));
+  if (command == fAsyncQueueDepthCmd) fAnalysisManager->setAsyncQueueDepth(fAsyncQueueDepthCmd->GetNewIntValue(newValues));
+  if (command == fSaveActsCmd) fAnalysisManager->saveActs(fSaveActsCmd->GetNewBoolValue(newValues));
 
 }
 
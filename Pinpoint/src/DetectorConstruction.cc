@@ -3,6 +3,8 @@
 #include "DetectorConstruction.hh"
 #include "PixelSD.hh"
 #include "ScintSD.hh"
+#include "FastShower.hh"
+#include "FastShowerModel.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
 #include "G4Box.hh"
@@ -14,8 +16,18 @@
 #include "G4VisAttributes.hh"
 #include "G4LogicalSkinSurface.hh"
 #include "G4PhysicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4UserLimits.hh"
+#include "G4UnitsTable.hh"
+#include "Logging.hh"
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iomanip>
+#include <sstream>
 
 
 DetectorConstruction::DetectorConstruction()
@@ -158,7 +170,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 {
   // Geometry parameters
   // https://iopscience.iop.org/article/10.1088/1748-0221/20/02/C02015
-  G4bool fCheckOverlaps = true;
+  const auto startTime = std::chrono::steady_clock::now();
 
   //cleaning scintillator logical volume container
   scintLVs.clear();
@@ -171,7 +183,8 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   G4cout << "Number of layers: " << fNLayers << G4endl;
   G4cout << "Tungsten thickness per layer: " << fTungstenThickness/mm << " mm" << G4endl;
   G4cout << "Silicon thickness per layer: " << fSiliconThickness/um << " um" << G4endl;
-  G4cout << "Creating " << nPixelsX << " x " << nPixelsY << " pixels per silicon layer" << G4endl;
+  G4cout << "Creating " << nPixelsX << " x " << nPixelsY << " pixels per silicon layer"
+         << (fAnalyticPixels ? " (analytic readout)" : "") << G4endl;
   G4cout << "Pixel size: " << fPixelWidth/micrometer << " x " << fPixelHeight/micrometer << " μm" << G4endl;
   fLayerThickness = fTungstenThickness + fBoxThickness + fSiliconThickness;
   if(sim_flag == -1) { fLayerThickness = fTungstenThickness + fBoxThickness + fSiliconThickness;}  //only pixel, TPTPTPTP...
@@ -230,6 +243,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   // Tungsten
   auto tungstenS = new G4Box("Tungsten", 0.5 * fDetectorWidth, 0.5 * fDetectorHeight, 0.5 * fTungstenThickness);
   auto tungstenLV = new G4LogicalVolume(tungstenS, tungstenMaterial, "Tungsten");
+  G4RegionStore::GetInstance()->FindOrCreateRegion("Absorber")->AddRootLogicalVolume(tungstenLV);
   zCursor += 0.5*fTungstenThickness;
   //fTarget_phys.push_back(new G4PVPlacement(0, G4ThreeVector(0., 0., -0.5 * fLayerThickness + 0.5 * fTungstenThickness), tungstenLV, "Tungsten", layerLV, false, 0, fCheckOverlaps));
   new G4PVPlacement(0, G4ThreeVector(0., 0., zCursor), tungstenLV, "Tungsten", layerLV, false, 0, fCheckOverlaps);
@@ -257,18 +271,30 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   auto siliconLayerLV = new G4LogicalVolume(silicofNLayers, siliconMaterial, "SiliconLayer");  // Changed to siliconMaterial
   new G4PVPlacement(nullptr, G4ThreeVector(0., 0.,zCursor), siliconLayerLV, "SiliconLayer", layerLV, false, 0, fCheckOverlaps);
   siliconLayerLV->SetVisAttributes(LayerAtrrib);
+  // the pixel rows and pixels inherit the region
+  G4RegionStore::GetInstance()->FindOrCreateRegion("PixelSilicon")->AddRootLogicalVolume(siliconLayerLV);
 
-  // Create pixel row (Y direction)
-  auto pixelRowS = new G4Box("SiliconPixelRow", 0.5 * fDetectorWidth, 0.5 * fPixelHeight, 0.5 * fSiliconThickness);
-  auto pixelRowLV = new G4LogicalVolume(pixelRowS, siliconMaterial, "SiliconPixelRow");  // Changed to siliconMaterial
-  new G4PVReplica("SiliconPixelRow", pixelRowLV, siliconLayerLV, kYAxis, nPixelsY, fPixelHeight);
-  pixelRowLV->SetVisAttributes(invisAtrrib);
+  fSiliconLayerLV = siliconLayerLV;
+  fPixelLV = nullptr;
 
-  // Create individual pixels (X direction)
-  auto pixelS = new G4Box("SiliconPixel", 0.5 * fPixelWidth, 0.5 * fPixelHeight, 0.5 * fSiliconThickness);
-  fPixelLV = new G4LogicalVolume(pixelS, siliconMaterial, "SiliconPixel");
-  new G4PVReplica("SiliconPixel", fPixelLV, pixelRowLV, kXAxis, nPixelsX, fPixelWidth);
-  fPixelLV->SetVisAttributes(invisAtrrib);
+  if (fAnalyticPixels) {
+    // The whole layer is the sensitive volume and PixelSD computes the pixel
+    // from the step position, no replica tree is built
+    G4cout << "Analytic pixel readout: pixels are not built as volumes" << G4endl;
+  }
+  else {
+    // Create pixel row (Y direction)
+    auto pixelRowS = new G4Box("SiliconPixelRow", 0.5 * fDetectorWidth, 0.5 * fPixelHeight, 0.5 * fSiliconThickness);
+    auto pixelRowLV = new G4LogicalVolume(pixelRowS, siliconMaterial, "SiliconPixelRow");  // Changed to siliconMaterial
+    new G4PVReplica("SiliconPixelRow", pixelRowLV, siliconLayerLV, kYAxis, nPixelsY, fPixelHeight);
+    pixelRowLV->SetVisAttributes(invisAtrrib);
+
+    // Create individual pixels (X direction)
+    auto pixelS = new G4Box("SiliconPixel", 0.5 * fPixelWidth, 0.5 * fPixelHeight, 0.5 * fSiliconThickness);
+    fPixelLV = new G4LogicalVolume(pixelS, siliconMaterial, "SiliconPixel");
+    new G4PVReplica("SiliconPixel", fPixelLV, pixelRowLV, kXAxis, nPixelsX, fPixelWidth);
+    fPixelLV->SetVisAttributes(invisAtrrib);
+  }
 
   zCursor += 0.5*fSiliconThickness;
 
@@ -296,6 +322,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
       auto scintContainerLV = new G4LogicalVolume(scintContainerS, scintillator, "ScintContainer1");
       auto scintContainerPV = new G4PVPlacement(0, G4ThreeVector(0.,0.,zCursor),scintContainerLV, "ScintContainer1",layerLV, false, 100, fCheckOverlaps);
       scintContainerLV->SetVisAttributes(ScintLayerAtrrib);
+      G4RegionStore::GetInstance()->FindOrCreateRegion("Scintillator")->AddRootLogicalVolume(scintContainerLV);
 
       if(scint_bar_flag == false)
       {
@@ -342,6 +369,7 @@ if(sim_flag == 1)
     auto scintContainer2LV = new G4LogicalVolume(scintContainer2S, scintillator, "ScintContainer2");
     auto scintContainer2PV = new G4PVPlacement(0, G4ThreeVector(0.,0.,zCursor),scintContainer2LV, "ScintContainer2",layerLV, false, 101, fCheckOverlaps);
     scintContainer2LV->SetVisAttributes(ScintLayerAtrrib);
+    G4RegionStore::GetInstance()->FindOrCreateRegion("Scintillator")->AddRootLogicalVolume(scintContainer2LV);
 
     if(scint_bar_flag == false)
     {
@@ -372,18 +400,198 @@ if(sim_flag == 1)
   // G4cout << "Detector consists of " << fNLayers << " layers of: [ " << fTungstenThickness / mm << "mm of " << tungstenMaterial->GetName() << " + " << fSiliconThickness / mm << "mm of "
   //        << siliconMaterial->GetName() <<  " + " << fBoxThickness / mm << "mm of " << worldMaterial->GetName() << " ] " << G4endl;
 
-  // Write GDML file if it doesn't exist
-  std::ifstream file(fWriteFile);
-  if (!file.good()) {
-    fParser.Write(fWriteFile, worldPV);
-  }
-  file.close();
+  // cuts and limits given before /run/initialize
+  ApplyRegionSettings();
+
+  const G4double buildTime = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - startTime).count();
+  G4cout << "Geometry built in " << buildTime << " s (overlap checks " << (fCheckOverlaps ? "on" : "off")
+         << "), fingerprint " << GetGeometryFingerprintString() << G4endl;
+
+  if (!fWriteFile.empty()) WriteGDML(worldPV);
+  if (fPrintVolumes) PrintLayerVolumePositions();
 
-  PrintLayerVolumePositions();
-  
   return worldPV;
 }
 
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+std::uint64_t DetectorConstruction::GetGeometryFingerprint() const
+{
+  // FNV-1a over the parameters, in internal units; bump the version when
+  // Construct changes the way they are used
+  const std::uint32_t version = 1;
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+  };
+  auto addDouble = [&add](G4double value) { add(&value, sizeof(value)); };
+  auto addInt = [&add](std::int32_t value) { add(&value, sizeof(value)); };
+
+  addInt(version);
+  addDouble(fTungstenThickness);
+  addDouble(fSiliconThickness);
+  addDouble(fBoxThickness);
+  addDouble(fScintThickness);
+  addInt(fNLayers);
+  addDouble(fPixelWidth);
+  addDouble(fPixelHeight);
+  addDouble(fDetectorWidth);
+  addDouble(fDetectorHeight);
+  addInt(sim_flag);
+  addInt(scint_bar_flag);
+  addInt(fAnalyticPixels);
+  return hash;
+}
+
+G4String DetectorConstruction::GetGeometryFingerprintString() const
+{
+  std::ostringstream os;
+  os << std::hex << std::setw(16) << std::setfill('0') << GetGeometryFingerprint();
+  return os.str();
+}
+
+void DetectorConstruction::WriteGDML(G4VPhysicalVolume* worldPV)
+{
+  // the fingerprint of the export is kept next to it
+  const G4String fingerprint = GetGeometryFingerprintString();
+  const G4String fingerprintFile = fWriteFile + ".fingerprint";
+  std::ifstream gdml(fWriteFile);
+  std::ifstream previous(fingerprintFile);
+  G4String previousFingerprint;
+  if (gdml.good() && previous >> previousFingerprint && previousFingerprint == fingerprint) {
+    G4cout << "GDML file " << fWriteFile << " is up to date (fingerprint " << fingerprint << ")" << G4endl;
+    return;
+  }
+  gdml.close();
+  previous.close();
+
+  // G4GDMLParser refuses to overwrite a file
+  std::remove(fWriteFile.c_str());
+  const auto startTime = std::chrono::steady_clock::now();
+  fParser.Write(fWriteFile, worldPV);
+  std::ofstream(fingerprintFile) << fingerprint << std::endl;
+  const G4double writeTime = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - startTime).count();
+  G4cout << "GDML file " << fWriteFile << " written in " << writeTime << " s" << G4endl;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+const std::vector<G4String>& DetectorConstruction::GetRegionNames()
+{
+  static const std::vector<G4String> names = {"Absorber", "PixelSilicon", "Scintillator"};
+  return names;
+}
+
+G4bool DetectorConstruction::CheckRegionName(const G4String& region) const
+{
+  const auto& names = GetRegionNames();
+  if (std::find(names.begin(), names.end(), region) != names.end()) return true;
+
+  G4ExceptionDescription ed;
+  ed << "Unknown region " << region << ", expected one of Absorber, PixelSilicon, Scintillator";
+  G4Exception("DetectorConstruction::CheckRegionName", "Region001", JustWarning, ed);
+  return false;
+}
+
+void DetectorConstruction::SetRegionCut(const G4String& region, const G4String& particle, G4double cut)
+{
+  if (!CheckRegionName(region)) return;
+
+  auto& cuts = fRegionSettings[region].cuts;
+  if (particle == "all") {
+    for (const char* name : {"gamma", "e-", "e+", "proton"}) cuts[name] = cut;
+  }
+  else {
+    cuts[particle] = cut;
+  }
+  ApplyRegionSettings();
+}
+
+void DetectorConstruction::SetRegionMaxStep(const G4String& region, G4double maxStep)
+{
+  if (!CheckRegionName(region)) return;
+  fRegionSettings[region].maxStep = maxStep;
+  ApplyRegionSettings();
+}
+
+void DetectorConstruction::SetRegionMinEkin(const G4String& region, G4double minEkin)
+{
+  if (!CheckRegionName(region)) return;
+  fRegionSettings[region].minEkin = minEkin;
+  ApplyRegionSettings();
+}
+
+void DetectorConstruction::SetRegionMaxTime(const G4String& region, G4double maxTime)
+{
+  if (!CheckRegionName(region)) return;
+  fRegionSettings[region].maxTime = maxTime;
+  ApplyRegionSettings();
+}
+
+void DetectorConstruction::ApplyRegionSettings()
+{
+  for (auto& [name, settings] : fRegionSettings) {
+    // not built yet, or no scintillator in this configuration
+    G4Region* region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (!region) continue;
+
+    if (!settings.cuts.empty()) {
+      // particles without a cut of their own keep the default cut
+      if (!settings.productionCuts) {
+        settings.productionCuts = new G4ProductionCuts(
+          *G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts());
+      }
+      for (const auto& [particle, cut] : settings.cuts) settings.productionCuts->SetProductionCut(cut, particle);
+      // picked up by the cuts table at the next /run/beamOn
+      region->SetProductionCuts(settings.productionCuts);
+    }
+
+    if (settings.maxStep >= 0. || settings.minEkin >= 0. || settings.maxTime >= 0.) {
+      if (!settings.userLimits) settings.userLimits = new G4UserLimits();
+      if (settings.maxStep >= 0.) settings.userLimits->SetMaxAllowedStep(settings.maxStep);
+      if (settings.minEkin >= 0.) settings.userLimits->SetUserMinEkine(settings.minEkin);
+      if (settings.maxTime >= 0.) settings.userLimits->SetUserMaxTime(settings.maxTime);
+      region->SetUserLimits(settings.userLimits);
+    }
+  }
+}
+
+void DetectorConstruction::PrintRegions() const
+{
+  for (const G4String& name : GetRegionNames()) {
+    const G4Region* region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (!region) {
+      G4cout << name << ": not built" << G4endl;
+      continue;
+    }
+
+    G4cout << name << ": " << region->GetNumberOfRootVolumes() << " root volumes, cuts";
+    const G4ProductionCuts* cuts = region->GetProductionCuts();
+    if (!cuts || cuts == G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts()) {
+      G4cout << " default";
+    }
+    else {
+      for (const char* particle : {"gamma", "e-", "e+", "proton"}) {
+        G4cout << " " << particle << " " << G4BestUnit(cuts->GetProductionCut(particle), "Length");
+      }
+    }
+    G4cout << G4endl;
+
+    auto it = fRegionSettings.find(name);
+    if (it == fRegionSettings.end()) continue;
+    const RegionSettings& settings = it->second;
+    if (settings.maxStep >= 0.) G4cout << "  max step " << G4BestUnit(settings.maxStep, "Length") << G4endl;
+    if (settings.minEkin >= 0.) G4cout << "  min kinetic energy " << G4BestUnit(settings.minEkin, "Energy") << G4endl;
+    if (settings.maxTime >= 0.) G4cout << "  max time " << G4BestUnit(settings.maxTime, "Time") << G4endl;
+  }
+}
+
 void DetectorConstruction::ConstructSDandField()
 {
     // Create Scintillator SD
@@ -408,11 +616,25 @@ void DetectorConstruction::ConstructSDandField()
     }
 
     // Pixel SD
-    if(fPixelLV) {
+    if(fAnalyticPixels && fSiliconLayerLV) {
+        auto pixelSD = new PixelSD("PixelDetector", "PixelHitsCollection");
+        pixelSD->SetAnalyticReadout(static_cast<G4int>(fDetectorWidth / fPixelWidth),
+                                    static_cast<G4int>(fDetectorHeight / fPixelHeight),
+                                    fPixelWidth, fPixelHeight);
+        G4SDManager::GetSDMpointer()->AddNewDetector(pixelSD);
+        fSiliconLayerLV->SetSensitiveDetector(pixelSD);
+    }
+    else if(fPixelLV) {
         auto pixelSD = new PixelSD("PixelDetector", "PixelHitsCollection");
         G4SDManager::GetSDMpointer()->AddNewDetector(pixelSD);
         fPixelLV->SetSensitiveDetector(pixelSD);
     }
+
+    // Fast shower model (--fastsim), idle until /fastsim/enable or /fastsim/validate
+    G4Region* absorber = G4RegionStore::GetInstance()->GetRegion("Absorber", false);
+    if (absorber && FastShower::IsAvailable()) {
+        new FastShowerModel("FastShowerModel", absorber);
+    }
 }
 
 
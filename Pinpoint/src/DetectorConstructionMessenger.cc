@@ -5,6 +5,8 @@
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIparameter.hh"
 #include "G4ThreeVector.hh"
 #include "G4GeometryManager.hh"
 #include "G4PhysicalVolumeStore.hh"
@@ -12,6 +14,9 @@
 #include "G4SolidStore.hh"
 #include "G4RunManager.hh"
 
+#include <initializer_list>
+#include <sstream>
+
 #include "DetectorConstructionMessenger.hh"
 #include "DetectorConstruction.hh"
 #include "DetectorConstruction.hh"
@@ -76,9 +81,26 @@ DetectorConstructionMessenger::DetectorConstructionMessenger(DetectorConstructio
     detectorHeightCmd->SetDefaultValue(19.6);
 
     detGdmlCmd = new G4UIcmdWithAString("/det/setGDMLFile", this);
+    detGdmlCmd->SetGuidance("Export the geometry to this GDML file when it is built (none: no export, the default).");
+    detGdmlCmd->SetGuidance("The export is skipped if the file was written for the same geometry fingerprint.");
     detGdmlCmd->SetParameterName("GDMLFile", false);
     detGdmlCmd->SetDefaultValue("pinpoint.gdml");
 
+    checkOverlapsCmd = new G4UIcmdWithABool("/det/checkOverlaps", this);
+    checkOverlapsCmd->SetGuidance("Check every placement for overlaps when the geometry is built (slow).");
+    checkOverlapsCmd->SetParameterName("CheckOverlaps", true);
+    checkOverlapsCmd->SetDefaultValue(true);
+    checkOverlapsCmd->AvailableForStates(G4State_PreInit);
+
+    printVolumesCmd = new G4UIcmdWithABool("/det/printVolumes", this);
+    printVolumesCmd->SetGuidance("Print the positions of the tungsten, silicon and scintillator volumes once built.");
+    printVolumesCmd->SetParameterName("PrintVolumes", true);
+    printVolumesCmd->SetDefaultValue(true);
+    printVolumesCmd->AvailableForStates(G4State_PreInit);
+
+    fingerprintCmd = new G4UIcmdWithoutParameter("/det/printFingerprint", this);
+    fingerprintCmd->SetGuidance("Print the hash of the current geometry parameters.");
+
     // --- sim_flag : -1 = no scint, 0 = single layer, 1 = double layer ---
     simFlagCmd = new G4UIcmdWithAnInteger("/det/setSimFlag", this);
     simFlagCmd->SetGuidance("Set simulation scintillator configuration.");
@@ -95,6 +117,52 @@ DetectorConstructionMessenger::DetectorConstructionMessenger(DetectorConstructio
     scintBarFlagCmd->SetParameterName("ScintBarFlag", false);
     scintBarFlagCmd->SetDefaultValue(false);
 
+    analyticPixelsCmd = new G4UIcmdWithABool("/det/analyticPixels", this);
+    analyticPixelsCmd->SetGuidance("Compute pixel row/column from the step position in a solid silicon layer");
+    analyticPixelsCmd->SetGuidance("instead of building the pixels as replica volumes (same pixel numbering).");
+    analyticPixelsCmd->SetParameterName("AnalyticPixels", true);
+    analyticPixelsCmd->SetDefaultValue(true);
+    analyticPixelsCmd->AvailableForStates(G4State_PreInit);
+
+    // --- regions: production cuts and user limits ---
+    regionDir = new G4UIdirectory("/det/region/");
+    regionDir->SetGuidance("production cuts and user limits of the Absorber, PixelSilicon and Scintillator regions");
+
+    regionCutCmd = new G4UIcommand("/det/region/setCut", this);
+    regionCutCmd->SetGuidance("Set the production cut of a particle ('all' for gamma, e-, e+ and proton) in a region.");
+    regionCutCmd->SetGuidance("Particles without a cut of their own keep the default cut.");
+    regionCutCmd->SetParameter(MakeRegionParameter());
+    G4UIparameter* cutParam = new G4UIparameter("cut", 'd', false);
+    cutParam->SetParameterRange("cut>=0.");
+    regionCutCmd->SetParameter(cutParam);
+    G4UIparameter* cutUnitParam = new G4UIparameter("unit", 's', true);
+    cutUnitParam->SetDefaultUnit("mm");
+    regionCutCmd->SetParameter(cutUnitParam);
+    G4UIparameter* cutParticleParam = new G4UIparameter("particle", 's', true);
+    cutParticleParam->SetParameterCandidates("all gamma e- e+ proton");
+    cutParticleParam->SetDefaultValue("all");
+    regionCutCmd->SetParameter(cutParticleParam);
+    regionCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    regionMaxStepCmd = MakeRegionLimitCommand("/det/region/setMaxStep", "maximum step length", "mm");
+    regionMinEkinCmd = MakeRegionLimitCommand("/det/region/setMinEkin", "kinetic energy below which tracks are killed", "MeV");
+    regionMaxTimeCmd = MakeRegionLimitCommand("/det/region/setMaxTime", "global time after which tracks are killed", "ns");
+
+    regionListCmd = new G4UIcmdWithoutParameter("/det/region/list", this);
+    regionListCmd->SetGuidance("Print the regions with their production cuts and user limits.");
+    regionListCmd->AvailableForStates(G4State_Idle);
+
+    // geometry lives on the master and is shared by all worker threads,
+    // so none of these commands must be replayed on the workers
+    for (G4UIcommand* cmd : std::initializer_list<G4UIcommand*>{
+           tungstenThicknessCmd, siliconThicknessCmd, boxThicknessCmd, nLayersCmd,
+           pixelHeightCmd, pixelWidthCmd, detectorWidthCmd, detectorHeightCmd,
+           detGdmlCmd, simFlagCmd, scintBarFlagCmd, analyticPixelsCmd,
+           checkOverlapsCmd, printVolumesCmd, fingerprintCmd,
+           regionCutCmd, regionMaxStepCmd, regionMinEkinCmd, regionMaxTimeCmd, regionListCmd}) {
+      cmd->SetToBeBroadcasted(false);
+    }
+
     // magnetFieldCmd = new G4UIcmdWithADoubleAndUnit("/det/magnetField", this);
     // magnetFieldCmd->SetUnitCategory("Magnetic flux density");
     // magnetFieldCmd->SetDefaultUnit("tesla");
@@ -104,6 +172,31 @@ DetectorConstructionMessenger::DetectorConstructionMessenger(DetectorConstructio
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4UIparameter* DetectorConstructionMessenger::MakeRegionParameter() const {
+  G4UIparameter* regionParam = new G4UIparameter("region", 's', false);
+  G4String candidates;
+  for (const G4String& name : DetectorConstruction::GetRegionNames()) candidates += name + " ";
+  regionParam->SetParameterCandidates(candidates);
+  return regionParam;
+}
+
+G4UIcommand* DetectorConstructionMessenger::MakeRegionLimitCommand(const G4String& path, const G4String& what,
+                                                                    const G4String& defaultUnit) {
+  G4UIcommand* cmd = new G4UIcommand(path, this);
+  cmd->SetGuidance("Set the " + what + " in a region (user limit, needs G4StepLimiterPhysics).");
+  cmd->SetParameter(MakeRegionParameter());
+  G4UIparameter* valueParam = new G4UIparameter("value", 'd', false);
+  valueParam->SetParameterRange("value>=0.");
+  cmd->SetParameter(valueParam);
+  G4UIparameter* unitParam = new G4UIparameter("unit", 's', true);
+  unitParam->SetDefaultUnit(defaultUnit);
+  cmd->SetParameter(unitParam);
+  cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  return cmd;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 DetectorConstructionMessenger::~DetectorConstructionMessenger() {
 //   delete detGdmlCmd;
   // delete magnetFieldCmd;
@@ -119,6 +212,16 @@ DetectorConstructionMessenger::~DetectorConstructionMessenger() {
   delete detGdmlCmd;
   delete simFlagCmd;
   delete scintBarFlagCmd;
+  delete analyticPixelsCmd;
+  delete checkOverlapsCmd;
+  delete printVolumesCmd;
+  delete fingerprintCmd;
+  delete regionCutCmd;
+  delete regionMaxStepCmd;
+  delete regionMinEkinCmd;
+  delete regionMaxTimeCmd;
+  delete regionListCmd;
+  delete regionDir;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -167,6 +270,38 @@ void DetectorConstructionMessenger::SetNewValue(G4UIcommand* command, G4String n
   if (command == scintBarFlagCmd) {
       det->SetScintBarFlag(scintBarFlagCmd->GetNewBoolValue(newValues));
   }
+  if (command == analyticPixelsCmd) {
+    det->SetAnalyticPixels(analyticPixelsCmd->GetNewBoolValue(newValues));
+  }
+  if (command == regionCutCmd) {
+    G4String region, unit = "mm", particle = "all";
+    G4double cut = 0.;
+    std::istringstream is(newValues);
+    is >> region >> cut >> unit >> particle;
+    det->SetRegionCut(region, particle, cut * G4UIcommand::ValueOf(unit));
+  }
+  if (command == regionMaxStepCmd || command == regionMinEkinCmd || command == regionMaxTimeCmd) {
+    G4String region, unit;
+    G4double value = 0.;
+    std::istringstream is(newValues);
+    is >> region >> value >> unit;
+    value *= G4UIcommand::ValueOf(unit);
+    if (command == regionMaxStepCmd) det->SetRegionMaxStep(region, value);
+    if (command == regionMinEkinCmd) det->SetRegionMinEkin(region, value);
+    if (command == regionMaxTimeCmd) det->SetRegionMaxTime(region, value);
+  }
+  if (command == checkOverlapsCmd) {
+    det->SetCheckOverlaps(checkOverlapsCmd->GetNewBoolValue(newValues));
+  }
+  if (command == printVolumesCmd) {
+    det->SetPrintVolumes(printVolumesCmd->GetNewBoolValue(newValues));
+  }
+  if (command == fingerprintCmd) {
+    G4cout << "Geometry fingerprint: " << det->GetGeometryFingerprintString() << G4endl;
+  }
+  if (command == regionListCmd) {
+    det->PrintRegions();
+  }
 
 
 //   if (command == detGdmlCmd) det->SaveGDML(detGdmlCmd->GetNewBoolValue(newValues));
@@ -5,7 +5,12 @@
 #include "G4VVisManager.hh"
 #include "G4Circle.hh"
 #include "G4VisAttributes.hh"
+#include "G4DigiManager.hh"
 #include "AnalysisManager.hh"
+#include "PixelDigitizer.hh"
+#include "PerfMonitor.hh"
+#include "ProgressReporter.hh"
+#include "Logging.hh"
 
 using namespace std;
 
@@ -20,6 +25,9 @@ EventAction::EventAction() :
   accumulableManager->Register(fNPrimaryTrack);
   accumulableManager->Register(fNSecondaryTrack);
   accumulableManager->Register(fNSecondaryTrackNotGamma);
+
+  // one digitizer per thread, owned by the (thread-local) digi manager
+  G4DigiManager::GetDMpointer()->AddNewModule(new PixelDigitizer("PixelDigitizer"));
 }
 
 EventAction::~EventAction() {;}
@@ -30,33 +38,31 @@ void EventAction::BeginOfEventAction(const G4Event* event)
   G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
   accumulableManager->Reset();
 
+  PerfMonitor::GetInstance()->BeginOfEvent();
+
   AnalysisManager* ana = AnalysisManager::GetInstance();
   ana->BeginOfEvent();
 }
 
 void EventAction::EndOfEventAction(const G4Event* event)
 {
-  G4cout << "This is the " << event->GetEventID() << "th event"<<G4endl;
-
-  if (fNPrimaryTrack.GetValue()) 
-    G4cout << " * Produced "<< fNPrimaryTrack.GetValue() << " primary tracks." << G4endl;
-  else 
-    G4cout << " * No primary tracks produced" << G4endl;
+  ProgressReporter::EventDone();
 
-  if (fNSecondaryTrack.GetValue()) 
-    G4cout << " * Produced "<< fNSecondaryTrack.GetValue() << " secondary tracks." << G4endl;
-  else
-    G4cout << " * No secondary tracks produced" << G4endl;
-
-  if (fNSecondaryTrackNotGamma.GetValue()) 
-    G4cout << " * Produced "<< fNSecondaryTrackNotGamma.GetValue() << " secondary tracks (excluding gamma)." << G4endl;
-  else
-    G4cout << " * No secondary tracks (excluding gamma) produced" << G4endl;
+  LOG_DEBUG("This is the " << event->GetEventID() << "th event");
+  LOG_DEBUG(" * Produced " << fNPrimaryTrack.GetValue() << " primary tracks.");
+  LOG_DEBUG(" * Produced " << fNSecondaryTrack.GetValue() << " secondary tracks.");
+  LOG_DEBUG(" * Produced " << fNSecondaryTrackNotGamma.GetValue() << " secondary tracks (excluding gamma).");
 
   // skip AnalysisManager if there are no tracks at all!
   if(!fNPrimaryTrack.GetValue() && !fNSecondaryTrack.GetValue() && !fNSecondaryTrackNotGamma.GetValue()) 
     return;
 
+  // digitize the pixel hits before they are written out
+  auto digitizer = static_cast<PixelDigitizer*>(G4DigiManager::GetDMpointer()->FindDigitizerModule("PixelDigitizer"));
+  if (digitizer && digitizer->IsEnabled()) digitizer->Digitize();
+
+  PerfMonitor::GetInstance()->EndOfEvent();
+
   AnalysisManager* ana = AnalysisManager::GetInstance();
   ana->EndOfEvent(event);
 
@@ -0,0 +1,37 @@
+#include "EventSeeder.hh"
+
+#include "Randomize.hh"
+
+#include <chrono>
+
+G4long EventSeeder::fRunSeed = 0;
+
+std::uint64_t EventSeeder::SplitMix64(std::uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+G4long EventSeeder::MakeRunSeed()
+{
+  const auto now = std::chrono::system_clock::now().time_since_epoch().count();
+  // positive and small enough to be typed back on the command line
+  return static_cast<G4long>(SplitMix64(static_cast<std::uint64_t>(now)) & 0x7fffffffULL);
+}
+
+void EventSeeder::SeedEvent(G4long globalEventIndex)
+{
+  const std::uint64_t state = SplitMix64(static_cast<std::uint64_t>(fRunSeed) ^
+                                         SplitMix64(static_cast<std::uint64_t>(globalEventIndex)));
+
+  // two 31-bit non-zero seeds (RanecuEngine takes a pair), zero terminated
+  G4long seeds[3];
+  for (G4int i = 0; i < 2; ++i) {
+    seeds[i] = static_cast<G4long>(SplitMix64(state + i) & 0x7fffffffULL);
+    if (seeds[i] == 0) seeds[i] = 1;
+  }
+  seeds[2] = 0;
+  G4Random::setTheSeeds(seeds);
+}
@@ -0,0 +1,108 @@
+#include "FastShower.hh"
+#include "FastShowerMessenger.hh"
+#include "reco/PixelChannel.hh"
+
+#include "G4Exception.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <iomanip>
+
+G4ThreadLocal FastShower* FastShower::fInstance = nullptr;
+G4bool FastShower::fAvailable = false;
+
+FastShower* FastShower::GetInstance()
+{
+  if (!fInstance) fInstance = new FastShower();
+  return fInstance;
+}
+
+FastShower::FastShower()
+{
+  fMessenger = new FastShowerMessenger(this);
+}
+
+FastShower::~FastShower()
+{
+  delete fMessenger;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void FastShower::AddValidationEvent(std::vector<std::uint64_t>& fullPixels, std::vector<std::uint64_t>& fastPixels)
+{
+  ++fNValidationEvents;
+
+  // a pixel fired by several steps or spots counts once
+  auto countPerLayer = [](std::vector<std::uint64_t>& pixels, std::vector<G4long>& perLayer) {
+    std::sort(pixels.begin(), pixels.end());
+    pixels.erase(std::unique(pixels.begin(), pixels.end()), pixels.end());
+    for (std::uint64_t value : pixels) {
+      const std::size_t layer = PixelChannel(value).layerNumber();
+      if (perLayer.size() <= layer) perLayer.resize(layer + 1, 0);
+      ++perLayer[layer];
+    }
+  };
+  countPerLayer(fullPixels, fFullPixelsPerLayer);
+  countPerLayer(fastPixels, fFastPixelsPerLayer);
+}
+
+void FastShower::LoadLibrary(const G4String& fileName)
+{
+  if (fileName == "none") fLibrary.Unload();
+  else fLibrary.Load(fileName);
+}
+
+void FastShower::BeginOfRun()
+{
+  if (IsEnabled() && !fAvailable) {
+    G4Exception("FastShower::BeginOfRun", "FastShowerUnavailable", JustWarning,
+                "The fast shower model is not built, start Pinpoint with --fastsim to use the /fastsim/ commands");
+  }
+  fNShowers = 0;
+  fShowerEnergy = 0.;
+  fNLibraryShowers = 0;
+  fLibrary.SetEnergyRange(fMinEnergy, fMaxEnergy);
+  fNValidationEvents = 0;
+  fFullPixelsPerLayer.clear();
+  fFastPixelsPerLayer.clear();
+}
+
+void FastShower::EndOfRun()
+{
+  // the master writes the patterns of all threads
+  if (IsRecording()) {
+    fLibrary.EndOfRun(fRecordFile);
+    if (!G4Threading::IsWorkerThread()) G4cout << "---- Shower library: " << fLibrary.GetNRecorded() << " showers recorded" << G4endl;
+  }
+  if (fNShowers == 0) return;
+
+  G4cout << "---- Fast shower summary"
+         << (fValidate ? " (validation: every track was simulated in full)" : "") << " ----" << G4endl
+         << " parameterised showers: " << fNShowers << ", " << fShowerEnergy / GeV << " GeV";
+  if (fLibrary.IsLoaded()) G4cout << ", " << fNLibraryShowers << " from the library";
+  G4cout << G4endl;
+  if (!fValidate || fNValidationEvents == 0) return;
+
+  // mean fired pixels per event and layer, only layers where either fired
+  G4cout << " layer   full/event   fast/event   fast/full" << G4endl;
+  const std::size_t nLayers = std::max(fFullPixelsPerLayer.size(), fFastPixelsPerLayer.size());
+  G4long totalFull = 0, totalFast = 0;
+  for (std::size_t layer = 0; layer < nLayers; ++layer) {
+    const G4long full = (layer < fFullPixelsPerLayer.size()) ? fFullPixelsPerLayer[layer] : 0;
+    const G4long fast = (layer < fFastPixelsPerLayer.size()) ? fFastPixelsPerLayer[layer] : 0;
+    if (full == 0 && fast == 0) continue;
+    totalFull += full;
+    totalFast += fast;
+    G4cout << " " << std::setw(5) << layer
+           << std::setw(13) << static_cast<G4double>(full) / fNValidationEvents
+           << std::setw(13) << static_cast<G4double>(fast) / fNValidationEvents;
+    if (full > 0) G4cout << std::setw(12) << static_cast<G4double>(fast) / full;
+    G4cout << G4endl;
+  }
+  G4cout << " total" << std::setw(13) << static_cast<G4double>(totalFull) / fNValidationEvents
+         << std::setw(13) << static_cast<G4double>(totalFast) / fNValidationEvents;
+  if (totalFull > 0) G4cout << std::setw(12) << static_cast<G4double>(totalFast) / totalFull;
+  G4cout << G4endl;
+}
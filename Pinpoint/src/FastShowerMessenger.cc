@@ -0,0 +1,118 @@
+#include "FastShowerMessenger.hh"
+#include "FastShower.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+FastShowerMessenger::FastShowerMessenger(FastShower* fastShower)
+  : fFastShower(fastShower)
+{
+  fFastSimDir = new G4UIdirectory("/fastsim/");
+  fFastSimDir->SetGuidance("fast shower parameterisation in the tungsten absorber");
+
+  fEnableCmd = new G4UIcmdWithABool("/fastsim/enable", this);
+  fEnableCmd->SetGuidance("replace the showers of electrons, positrons and photons deep inside a tungsten plate");
+  fEnableCmd->SetGuidance("by parameterised hits in the downstream silicon layers");
+  fEnableCmd->SetParameterName("enable", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fValidateCmd = new G4UIcmdWithABool("/fastsim/validate", this);
+  fValidateCmd->SetGuidance("simulate everything in full, and compare per layer the fired pixels of the tracks");
+  fValidateCmd->SetGuidance("the model would have taken with those of their parameterised showers");
+  fValidateCmd->SetParameterName("validate", true);
+  fValidateCmd->SetDefaultValue(true);
+  fValidateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMinEnergyCmd = new G4UIcmdWithADoubleAndUnit("/fastsim/minEnergy", this);
+  fMinEnergyCmd->SetGuidance("lowest kinetic energy parameterised");
+  fMinEnergyCmd->SetParameterName("energy", false);
+  fMinEnergyCmd->SetRange("energy>=0.");
+  fMinEnergyCmd->SetUnitCategory("Energy");
+  fMinEnergyCmd->SetDefaultUnit("MeV");
+  fMinEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxEnergyCmd = new G4UIcmdWithADoubleAndUnit("/fastsim/maxEnergy", this);
+  fMaxEnergyCmd->SetGuidance("highest kinetic energy parameterised");
+  fMaxEnergyCmd->SetParameterName("energy", false);
+  fMaxEnergyCmd->SetRange("energy>0.");
+  fMaxEnergyCmd->SetUnitCategory("Energy");
+  fMaxEnergyCmd->SetDefaultUnit("MeV");
+  fMaxEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMinSafetyCmd = new G4UIcmdWithADoubleAndUnit("/fastsim/minDepth", this);
+  fMinSafetyCmd->SetGuidance("minimum distance of the particle to the surface of the tungsten plate");
+  fMinSafetyCmd->SetParameterName("depth", false);
+  fMinSafetyCmd->SetRange("depth>=0.");
+  fMinSafetyCmd->SetUnitCategory("Length");
+  fMinSafetyCmd->SetDefaultUnit("mm");
+  fMinSafetyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSpotEnergyCmd = new G4UIcmdWithADoubleAndUnit("/fastsim/spotEnergy", this);
+  fSpotEnergyCmd->SetGuidance("energy of each parameterised deposit in the silicon, about a MIP in the layer");
+  fSpotEnergyCmd->SetParameterName("energy", false);
+  fSpotEnergyCmd->SetRange("energy>0.");
+  fSpotEnergyCmd->SetUnitCategory("Energy");
+  fSpotEnergyCmd->SetDefaultUnit("keV");
+  fSpotEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fLibraryDir = new G4UIdirectory("/fastsim/library/");
+  fLibraryDir->SetGuidance("shower library: recorded silicon deposit patterns replayed by the fast shower model");
+
+  fRecordCmd = new G4UIcmdWithAString("/fastsim/library/record", this);
+  fRecordCmd->SetGuidance("simulate the showers the model would take in full and write their deposit patterns");
+  fRecordCmd->SetGuidance("to this file at the end of the run (none: stop recording)");
+  fRecordCmd->SetParameterName("file", false);
+  fRecordCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fLoadCmd = new G4UIcmdWithAString("/fastsim/library/load", this);
+  fLoadCmd->SetGuidance("memory-map a shower library, its patterns replace the analytic profile where its bins");
+  fLoadCmd->SetGuidance("are filled (none: unload)");
+  fLoadCmd->SetParameterName("file", false);
+  fLoadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fEnergyBinsCmd = new G4UIcmdWithAnInteger("/fastsim/library/energyBins", this);
+  fEnergyBinsCmd->SetGuidance("number of log(energy) bins between minEnergy and maxEnergy when recording");
+  fEnergyBinsCmd->SetParameterName("n", false);
+  fEnergyBinsCmd->SetRange("n>0");
+  fEnergyBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fAngleBinsCmd = new G4UIcmdWithAnInteger("/fastsim/library/angleBins", this);
+  fAngleBinsCmd->SetGuidance("number of |cos(theta_z)| bins when recording");
+  fAngleBinsCmd->SetParameterName("n", false);
+  fAngleBinsCmd->SetRange("n>0");
+  fAngleBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+FastShowerMessenger::~FastShowerMessenger()
+{
+  delete fEnableCmd;
+  delete fValidateCmd;
+  delete fMinEnergyCmd;
+  delete fMaxEnergyCmd;
+  delete fMinSafetyCmd;
+  delete fSpotEnergyCmd;
+  delete fRecordCmd;
+  delete fLoadCmd;
+  delete fEnergyBinsCmd;
+  delete fAngleBinsCmd;
+  delete fLibraryDir;
+  delete fFastSimDir;
+}
+
+void FastShowerMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fEnableCmd) fFastShower->SetEnabled(fEnableCmd->GetNewBoolValue(newValues));
+  if (command == fValidateCmd) fFastShower->SetValidate(fValidateCmd->GetNewBoolValue(newValues));
+  if (command == fMinEnergyCmd) fFastShower->SetMinEnergy(fMinEnergyCmd->GetNewDoubleValue(newValues));
+  if (command == fMaxEnergyCmd) fFastShower->SetMaxEnergy(fMaxEnergyCmd->GetNewDoubleValue(newValues));
+  if (command == fMinSafetyCmd) fFastShower->SetMinSafety(fMinSafetyCmd->GetNewDoubleValue(newValues));
+  if (command == fSpotEnergyCmd) fFastShower->SetSpotEnergy(fSpotEnergyCmd->GetNewDoubleValue(newValues));
+  if (command == fRecordCmd) fFastShower->SetRecordFile(newValues);
+  if (command == fLoadCmd) fFastShower->LoadLibrary(newValues);
+  if (command == fEnergyBinsCmd) fFastShower->GetLibrary().SetEnergyBins(fEnergyBinsCmd->GetNewIntValue(newValues));
+  if (command == fAngleBinsCmd) fFastShower->GetLibrary().SetAngleBins(fAngleBinsCmd->GetNewIntValue(newValues));
+}
@@ -0,0 +1,243 @@
+#include "FastShowerModel.hh"
+#include "FastShower.hh"
+#include "AnalysisManager.hh"
+#include "TrackTable.hh"
+
+#include "G4FastSimHitMaker.hh"
+#include "G4FastHit.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4Gamma.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // longitudinal profile slope, and depth past the maximum the axis is followed
+  const G4double kProfileB = 0.5;
+  const G4double kTailDepth = 16.;  // X0
+  // radial profile: fraction of the spots in the core, core radius in Moliere radii
+  const G4double kCoreFraction = 0.8;
+  const G4double kCoreRadius = 0.15;
+  // guard against a navigation loop
+  const G4int kMaxNavigationSteps = 100000;
+}
+
+FastShowerModel::FastShowerModel(const G4String& name, G4Region* envelope)
+  : G4VFastSimulationModel(name, envelope),
+    fConfig(FastShower::GetInstance()),
+    fTrackTable(&AnalysisManager::GetInstance()->GetTrackTable()),
+    fHitMaker(new G4FastSimHitMaker()),
+    fNavigator(new G4Navigator())
+{}
+
+FastShowerModel::~FastShowerModel()
+{
+  delete fHitMaker;
+  delete fNavigator;
+}
+
+G4bool FastShowerModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4Electron::ElectronDefinition() || &particle == G4Positron::PositronDefinition()
+         || &particle == G4Gamma::GammaDefinition();
+}
+
+G4bool FastShowerModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  if (!fConfig->IsEnabled()) return false;
+
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  const G4double ekin = track->GetKineticEnergy();
+  if (ekin < fConfig->GetMinEnergy() || ekin > fConfig->GetMaxEnergy()) return false;
+
+  // deep inside the plate
+  const G4double safety = fastTrack.GetEnvelopeSolid()->DistanceToOut(fastTrack.GetPrimaryTrackLocalPosition());
+  if (safety < fConfig->GetMinSafety()) return false;
+  if (!fConfig->IsValidating() && !fConfig->IsRecording()) return true;
+
+  // validation and library recording: the full simulation goes on, once per
+  // track and not for the descendants of a track already taken. The
+  // parameterised hits of the track are computed on the side, or its
+  // deposits are recorded (PixelSD)
+  const G4int trackID = track->GetTrackID();
+  if (fTrackTable->Has(trackID, TrackTable::kFastShower)) return false;
+  fTrackTable->Tag(trackID, TrackTable::kFastShower);
+  if (fConfig->IsRecording()) {
+    G4double criticalEnergy;
+    FindCrossings(track, ShowerMaximum(track, criticalEnergy) + kTailDepth);
+    fConfig->GetLibrary().BeginShower(trackID, ekin, track->GetMomentumDirection(), fCrossings);
+  }
+  if (fConfig->IsValidating()) {
+    fConfig->CountShower(ekin);
+    // the parameterised hits draw from a copy of the engine state, so the
+    // full simulation of the event sees the same sequence as without
+    // validation
+    CLHEP::HepRandomEngine* engine = G4Random::getTheEngine();
+    const std::vector<unsigned long> engineState = engine->put();
+    Deposit(fastTrack);
+    engine->get(engineState);
+  }
+  return false;
+}
+
+void FastShowerModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  const G4double ekin = fastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  fConfig->CountShower(ekin);
+  Deposit(fastTrack);
+
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+  // the energy not read out in silicon is absorbed in the plate
+  fastStep.ProposeTotalEnergyDeposited(ekin);
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+G4double FastShowerModel::ShowerMaximum(const G4Track* track, G4double& criticalEnergy) const
+{
+  // critical energy of the plate (Rossi, solids)
+  const G4Material* material = track->GetMaterial();
+  criticalEnergy = 610. * MeV / (material->GetIonisation()->GetZeffective() + 1.24);
+  const G4bool isGamma = track->GetParticleDefinition() == G4Gamma::GammaDefinition();
+  return std::max(std::log(track->GetKineticEnergy() / criticalEnergy) + (isGamma ? 0.5 : -0.5), 0.);
+}
+
+void FastShowerModel::Deposit(const G4FastTrack& fastTrack)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  const G4double energy = track->GetKineticEnergy();
+
+  G4double criticalEnergy;
+  const G4double tMax = ShowerMaximum(track, criticalEnergy);
+  FindCrossings(track, tMax + kTailDepth);
+  if (DepositFromLibrary(fastTrack)) return;
+
+  // longitudinal profile in radiation lengths, normalised to 1
+  const G4double a = kProfileB * tMax + 1.;
+  const G4double logNorm = a * std::log(kProfileB) - std::lgamma(a);
+  auto profile = [&](G4double t) { return std::exp(logNorm + (a - 1.) * std::log(t) - kProfileB * t); };
+  const G4double moliereRadius = track->GetMaterial()->GetRadlen() * 21.2052 * MeV / criticalEnergy;
+
+  // silicon layers are thin, the profile is taken at the middle
+  const G4ThreeVector& axis = track->GetMomentumDirection();
+  for (const ShowerLibrary::Crossing& crossing : fCrossings) {
+    DepositInSilicon(fastTrack, crossing.centre, axis, energy * profile(crossing.depth) * crossing.thickness,
+                     moliereRadius);
+  }
+}
+
+G4bool FastShowerModel::DepositFromLibrary(const G4FastTrack& fastTrack)
+{
+  const ShowerLibrary& library = fConfig->GetLibrary();
+  if (!library.IsLoaded()) return false;
+
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  const G4double energy = track->GetKineticEnergy();
+  const G4ThreeVector& axis = track->GetMomentumDirection();
+  const ShowerLibrary::PatternRecord* pattern = nullptr;
+  const ShowerLibrary::Spot* spots = nullptr;
+  if (!library.Sample(energy, axis.cosTheta(), pattern, spots)) return false;
+  fConfig->CountLibraryShower();
+
+  // the pattern is turned to the azimuth of the axis and scaled to the
+  // energy inside its bin; deposits beyond the layers crossed are dropped
+  const G4double scale = (pattern->energy > 0.f) ? energy / (pattern->energy * MeV) : 1.;
+  const G4double c = std::cos(axis.phi()), s = std::sin(axis.phi());
+  for (std::uint32_t i = 0; i < pattern->nSpots; ++i) {
+    const ShowerLibrary::Spot& spot = spots[i];
+    if (spot.layer < 0 || static_cast<std::size_t>(spot.layer) >= fCrossings.size()) continue;
+    const G4ThreeVector& centre = fCrossings[spot.layer].centre;
+    const G4double u = spot.u * mm, v = spot.v * mm;
+    const G4ThreeVector position(centre.x() + c * u - s * v, centre.y() + s * u + c * v, centre.z());
+    fHitMaker->make(G4FastHit(position, spot.energy * MeV * scale), fastTrack);
+  }
+  return true;
+}
+
+void FastShowerModel::FindCrossings(const G4Track* track, G4double depth)
+{
+  fCrossings.clear();
+  if (!fSiliconRegion) {
+    fSiliconRegion = G4RegionStore::GetInstance()->GetRegion("PixelSilicon", false);
+    fNavigator->SetWorldVolume(
+      G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+  }
+
+  // follow the shower axis through the layers
+  G4ThreeVector position = track->GetPosition();
+  const G4ThreeVector axis = track->GetMomentumDirection();
+  G4VPhysicalVolume* volume = fNavigator->LocateGlobalPointAndSetup(position, &axis, false, false);
+  G4double t = 0.;
+  G4bool inSilicon = false;
+  for (G4int i = 0; volume && t < depth && i < kMaxNavigationSteps; ++i) {
+    G4double safety = 0.;
+    G4double step = fNavigator->ComputeStep(position, axis, kInfinity, safety);
+    if (step == kInfinity) break;
+    step = std::max(step, 1. * nanometer);
+
+    const G4LogicalVolume* logical = volume->GetLogicalVolume();
+    const G4double dt = step / logical->GetMaterial()->GetRadlen();
+    const G4bool silicon = logical->GetRegion() == fSiliconRegion;
+    if (silicon) {
+      const G4double zEnd = position.z() + step * axis.z();
+      if (!inSilicon) {
+        fCrossings.push_back({position + 0.5 * step * axis, t + 0.5 * dt, dt,
+                              std::min(position.z(), zEnd), std::max(position.z(), zEnd)});
+      }
+      else {
+        // next pixel replica of the same layer
+        ShowerLibrary::Crossing& crossing = fCrossings.back();
+        crossing.centre += 0.5 * step * axis;
+        crossing.depth += 0.5 * dt;
+        crossing.thickness += dt;
+        crossing.zMin = std::min(crossing.zMin, zEnd);
+        crossing.zMax = std::max(crossing.zMax, zEnd);
+      }
+    }
+    inSilicon = silicon;
+
+    t += dt;
+    position += step * axis;
+    fNavigator->SetGeometricallyLimitedStep();
+    volume = fNavigator->LocateGlobalPointAndSetup(position, &axis, true);
+  }
+}
+
+void FastShowerModel::DepositInSilicon(const G4FastTrack& fastTrack, const G4ThreeVector& centre,
+                                       const G4ThreeVector& axis, G4double energy, G4double moliereRadius)
+{
+  // spots of a fixed energy, rounded at random to keep the mean deposit
+  const G4double spotEnergy = fConfig->GetSpotEnergy();
+  const G4int nSpots = static_cast<G4int>(energy / spotEnergy + G4UniformRand());
+  if (nSpots <= 0) return;
+
+  const G4ThreeVector u = axis.orthogonal().unit();
+  const G4ThreeVector v = axis.cross(u);
+  for (G4int i = 0; i < nSpots; ++i) {
+    // f(r) = 2 r R^2 / (r^2 + R^2)^2, inverted
+    const G4double radius = ((G4UniformRand() < kCoreFraction) ? kCoreRadius : 1.) * moliereRadius;
+    const G4double x = std::min(G4UniformRand(), 1. - 1e-9);
+    const G4double r = radius * std::sqrt(x / (1. - x));
+    const G4double phi = twopi * G4UniformRand();
+
+    // the layers are normal to z, the spot stays at the depth of the axis
+    G4ThreeVector spot = centre + r * (std::cos(phi) * u + std::sin(phi) * v);
+    spot.setZ(centre.z());
+    fHitMaker->make(G4FastHit(spot, spotEnergy), fastTrack);
+  }
+}
@@ -0,0 +1,22 @@
+#include "Logging.hh"
+
+#include <cstdlib>
+
+namespace Logging {
+
+  std::atomic<int> gLevel{kInfo};
+
+  int ParseLevel(const G4String& name)
+  {
+    if (name == "error") return kError;
+    if (name == "warning") return kWarning;
+    if (name == "info") return kInfo;
+    if (name == "debug") return kDebug;
+
+    char* end = nullptr;
+    long level = std::strtol(name.c_str(), &end, 10);
+    if (end != name.c_str() && *end == '\0' && level >= kError) return static_cast<int>(level);
+    return -1;
+  }
+
+}  // namespace Logging
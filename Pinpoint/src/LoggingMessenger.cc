@@ -0,0 +1,49 @@
+#include "LoggingMessenger.hh"
+#include "Logging.hh"
+#include "ProgressReporter.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+LoggingMessenger::LoggingMessenger()
+{
+  fLogDir = new G4UIdirectory("/log/");
+  fLogDir->SetGuidance("logging and progress report control");
+
+  fLevelCmd = new G4UIcmdWithAString("/log/level", this);
+  fLevelCmd->SetGuidance("set the logging level: error, warning, info (default) or debug");
+  fLevelCmd->SetGuidance("debug restores the per-event printout; levels above the compile-time");
+  fLevelCmd->SetGuidance("maximum (PINPOINT_LOG_MAX_LEVEL) are not available");
+  fLevelCmd->SetParameterName("level", false);
+  fLevelCmd->SetCandidates("error warning info debug 0 1 2 3");
+  fLevelCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fLevelCmd->SetToBeBroadcasted(false);
+
+  fProgressCmd = new G4UIcmdWithAnInteger("/log/progressInterval", this);
+  fProgressCmd->SetGuidance("print the throughput and estimated time left every N events, 0 disables it");
+  fProgressCmd->SetParameterName("nEvents", false);
+  fProgressCmd->SetRange("nEvents>=0");
+  fProgressCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProgressCmd->SetToBeBroadcasted(false);
+}
+
+LoggingMessenger::~LoggingMessenger()
+{
+  delete fLevelCmd;
+  delete fProgressCmd;
+  delete fLogDir;
+}
+
+void LoggingMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fLevelCmd) {
+    const int level = Logging::ParseLevel(newValues);
+    if (level > PINPOINT_LOG_MAX_LEVEL) {
+      LOG_WARNING("log level " << newValues << " is above the compile-time maximum "
+                  << PINPOINT_LOG_MAX_LEVEL << ", those messages were not compiled in");
+    }
+    Logging::SetLevel(level);
+  }
+  if (command == fProgressCmd) ProgressReporter::SetInterval(fProgressCmd->GetNewIntValue(newValues));
+}
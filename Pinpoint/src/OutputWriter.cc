@@ -0,0 +1,77 @@
+#include "OutputWriter.hh"
+
+OutputWriter::OutputWriter(std::size_t queueDepth, WriteFunction write)
+  : fQueueDepth(queueDepth > 0 ? queueDepth : 1), fWrite(std::move(write))
+{
+  fThread = std::thread(&OutputWriter::Run, this);
+}
+
+OutputWriter::~OutputWriter()
+{
+  Stop();
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+std::unique_ptr<OutputRecord> OutputWriter::Acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fFree.empty()) {
+      auto record = std::move(fFree.front());
+      fFree.pop_front();
+      record->clear();
+      return record;
+    }
+  }
+  return std::make_unique<OutputRecord>();
+}
+
+void OutputWriter::Push(std::unique_ptr<OutputRecord> record)
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  ++fNRecords;
+  if (fQueue.size() >= fQueueDepth) {
+    // back-pressure: tracking waits for the writer
+    ++fNFullQueue;
+    fNotFull.wait(lock, [this] { return fQueue.size() < fQueueDepth; });
+  }
+  fQueue.push_back(std::move(record));
+  lock.unlock();
+  fNotEmpty.notify_one();
+}
+
+void OutputWriter::Stop()
+{
+  if (!fThread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = true;
+  }
+  fNotEmpty.notify_one();
+  fThread.join();
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void OutputWriter::Run()
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  while (true) {
+    fNotEmpty.wait(lock, [this] { return fStop || !fQueue.empty(); });
+    // on stop the queue is drained before the thread exits
+    if (fQueue.empty()) break;
+
+    auto record = std::move(fQueue.front());
+    fQueue.pop_front();
+    lock.unlock();
+    fNotFull.notify_one();
+
+    fWrite(*record);
+
+    lock.lock();
+    fFree.push_back(std::move(record));
+  }
+}
@@ -0,0 +1,180 @@
+#include "PerfMonitor.hh"
+#include "PerfMonitorMessenger.hh"
+
+#include "G4Step.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+
+G4ThreadLocal PerfMonitor* PerfMonitor::fInstance = nullptr;
+
+namespace {
+  const char* const kCategoryNames[PerfRow::kNVolumeCategories] = {"tungsten", "silicon", "scintillator", "other"};
+  const char* const kDetectorNames[PerfRow::kNDetectors] = {"pixel", "scintillator"};
+
+  G4double Seconds(PerfMonitor::Clock::duration d)
+  {
+    return std::chrono::duration<G4double>(d).count();
+  }
+}
+
+PerfMonitor* PerfMonitor::GetInstance()
+{
+  if (!fInstance) fInstance = new PerfMonitor();
+  return fInstance;
+}
+
+PerfMonitor::PerfMonitor()
+{
+  fMessenger = new PerfMonitorMessenger(this);
+}
+
+PerfMonitor::~PerfMonitor()
+{
+  delete fMessenger;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+G4double PerfMonitor::ThreadCPUTime()
+{
+  // per-thread clock: process CPU time would mix all workers in MT mode
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+PerfRow::VolumeCategory PerfMonitor::Categorize(const G4LogicalVolume* volume)
+{
+  const G4String& name = volume->GetName();
+  if (name == "Tungsten") return PerfRow::kTungsten;
+  if (name.rfind("Silicon", 0) == 0) return PerfRow::kSilicon;
+  if (name.rfind("Scint", 0) == 0) return PerfRow::kScintillator;
+  return PerfRow::kOther;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void PerfMonitor::BeginOfRun()
+{
+  // the geometry may have been rebuilt since the last run
+  fVolumeCategories.clear();
+  fLastVolume = nullptr;
+
+  fNEvents = 0;
+  fTotalWallTime = 0.;
+  fTotalCPUTime = 0.;
+  std::fill(std::begin(fTotalVolumeSteps), std::end(fTotalVolumeSteps), 0);
+  std::fill(std::begin(fTotalVolumeTime), std::end(fTotalVolumeTime), 0.);
+  std::fill(std::begin(fTotalSDHits), std::end(fTotalSDHits), 0);
+}
+
+void PerfMonitor::BeginOfEvent()
+{
+  if (!fEnabled) return;
+
+  fRow.nSteps = 0;
+  fRow.speciesPDG.clear();
+  fRow.speciesSteps.clear();
+  fSpeciesDefinitions.clear();
+  fLastDefinition = nullptr;
+  std::fill(std::begin(fRow.volumeSteps), std::end(fRow.volumeSteps), 0);
+  std::fill(std::begin(fRow.volumeTime), std::end(fRow.volumeTime), 0.);
+  std::fill(std::begin(fRow.sdProcessHits), std::end(fRow.sdProcessHits), 0);
+  std::fill(std::begin(fRow.sdEndOfEventTime), std::end(fRow.sdEndOfEventTime), 0.);
+  std::fill(std::begin(fRow.sdHits), std::end(fRow.sdHits), 0);
+
+  fEventCPUStart = ThreadCPUTime();
+  fEventStart = Clock::now();
+  fLastStep = fEventStart;
+}
+
+void PerfMonitor::EndOfEvent()
+{
+  if (!fEnabled) return;
+
+  fRow.wallTime = Seconds(Clock::now() - fEventStart);
+  fRow.cpuTime = ThreadCPUTime() - fEventCPUStart;
+
+  ++fNEvents;
+  fTotalWallTime += fRow.wallTime;
+  fTotalCPUTime += fRow.cpuTime;
+  for (int i = 0; i < PerfRow::kNVolumeCategories; ++i) {
+    fTotalVolumeSteps[i] += fRow.volumeSteps[i];
+    fTotalVolumeTime[i] += fRow.volumeTime[i];
+  }
+  for (int i = 0; i < PerfRow::kNDetectors; ++i) fTotalSDHits[i] += fRow.sdHits[i];
+}
+
+void PerfMonitor::EndOfRun()
+{
+  if (!fEnabled || fNEvents == 0) return;
+
+  G4cout << "---- Performance summary (" << fNEvents << " events) ----" << G4endl
+         << " wall time per event : " << fTotalWallTime / fNEvents << " s" << G4endl
+         << " CPU time per event  : " << fTotalCPUTime / fNEvents << " s" << G4endl;
+  for (int i = 0; i < PerfRow::kNVolumeCategories; ++i) {
+    G4cout << " " << std::setw(13) << std::left << kCategoryNames[i] << std::right
+           << ": " << fTotalVolumeSteps[i] << " steps, " << fTotalVolumeTime[i] << " s" << G4endl;
+  }
+  for (int i = 0; i < PerfRow::kNDetectors; ++i) {
+    G4cout << " " << std::setw(13) << std::left << kDetectorNames[i] << std::right
+           << ": " << static_cast<G4double>(fTotalSDHits[i]) / fNEvents << " hits per event" << G4endl;
+  }
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void PerfMonitor::RecordStep(const G4Step* step)
+{
+  if (!fEnabled) return;
+
+  const Clock::time_point now = Clock::now();
+  ++fRow.nSteps;
+
+  const G4ParticleDefinition* definition = step->GetTrack()->GetParticleDefinition();
+  if (definition != fLastDefinition) {
+    auto it = std::find(fSpeciesDefinitions.begin(), fSpeciesDefinitions.end(), definition);
+    fLastSpecies = it - fSpeciesDefinitions.begin();
+    if (it == fSpeciesDefinitions.end()) {
+      fSpeciesDefinitions.push_back(definition);
+      fRow.speciesPDG.push_back(definition->GetPDGEncoding());
+      fRow.speciesSteps.push_back(0);
+    }
+    fLastDefinition = definition;
+  }
+  ++fRow.speciesSteps[fLastSpecies];
+
+  const G4LogicalVolume* volume = step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume();
+  if (volume != fLastVolume) {
+    auto it = fVolumeCategories.find(volume);
+    if (it == fVolumeCategories.end()) it = fVolumeCategories.emplace(volume, Categorize(volume)).first;
+    fLastCategory = it->second;
+    fLastVolume = volume;
+  }
+  ++fRow.volumeSteps[fLastCategory];
+  fRow.volumeTime[fLastCategory] += Seconds(now - fLastStep);
+  fLastStep = now;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+PerfMonitor::SDTimer::SDTimer(PerfMonitor* monitor, PerfRow::Detector detector)
+  : fMonitor(monitor->IsEnabled() ? monitor : nullptr), fDetector(detector)
+{
+  if (fMonitor) fStart = Clock::now();
+}
+
+PerfMonitor::SDTimer::~SDTimer()
+{
+  if (fMonitor) fMonitor->fRow.sdEndOfEventTime[fDetector] += Seconds(Clock::now() - fStart);
+}
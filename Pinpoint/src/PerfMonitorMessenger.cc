@@ -0,0 +1,29 @@
+#include "PerfMonitorMessenger.hh"
+#include "PerfMonitor.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+
+PerfMonitorMessenger::PerfMonitorMessenger(PerfMonitor* monitor)
+  : fPerfMonitor(monitor)
+{
+  fPerfDir = new G4UIdirectory("/perf/");
+  fPerfDir->SetGuidance("event loop instrumentation");
+
+  fEnableCmd = new G4UIcmdWithABool("/perf/enable", this);
+  fEnableCmd->SetGuidance("record per-event timing and step counts and write them to the perf tree");
+  fEnableCmd->SetParameterName("enable", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+PerfMonitorMessenger::~PerfMonitorMessenger()
+{
+  delete fEnableCmd;
+  delete fPerfDir;
+}
+
+void PerfMonitorMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fEnableCmd) fPerfMonitor->SetEnabled(fEnableCmd->GetNewBoolValue(newValues));
+}
@@ -0,0 +1,175 @@
+#include "PixelAccumulator.hh"
+
+#include <algorithm>
+#include <numeric>
+
+PixelAccumulator::PixelAccumulator(std::size_t initialCapacity)
+{
+  // capacity must be a power of two for the mask/shift arithmetic
+  std::size_t capacity = 16;
+  while (capacity < initialCapacity) capacity <<= 1;
+  Rehash(capacity);
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void PixelAccumulator::Clear()
+{
+  fKeys.clear();
+  fTrackIDs.clear();
+  fEdeps.clear();
+  fSumX.clear();
+  fSumY.clear();
+  fFromMuon.clear();
+  fSegments.clear();
+  fPayloads.clear();
+  fPixels.clear();
+
+  // invalidate all slots at once; on wrap-around reset the tags explicitly
+  if (++fEpoch == 0) {
+    std::fill(fSlotEpochs.begin(), fSlotEpochs.end(), 0);
+    fEpoch = 1;
+  }
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+std::uint64_t PixelAccumulator::Hash(std::uint64_t key, G4int trackID)
+{
+  // Fibonacci hashing: spreads the densely packed indices over the table;
+  // the track ID is mixed in with a second odd multiplier
+  return (key ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(trackID)) * 0xC2B2AE3D27D4EB4Full))
+         * 0x9E3779B97F4A7C15ull;
+}
+
+void PixelAccumulator::Rehash(std::size_t capacity)
+{
+  fSlotKeys.assign(capacity, 0);
+  fSlotTrackIDs.assign(capacity, 0);
+  fSlotEntries.assign(capacity, 0);
+  fSlotEpochs.assign(capacity, 0);
+  fEpoch = 1;
+  fMask = capacity - 1;
+  fShift = 64;
+  for (std::size_t c = capacity; c > 1; c >>= 1) --fShift;
+
+  for (std::uint32_t entry = 0; entry < fKeys.size(); ++entry) {
+    std::size_t slot = Hash(fKeys[entry], fTrackIDs[entry]) >> fShift;
+    while (fSlotEpochs[slot] == fEpoch) slot = (slot + 1) & fMask;
+    fSlotKeys[slot] = fKeys[entry];
+    fSlotTrackIDs[slot] = fTrackIDs[entry];
+    fSlotEntries[slot] = entry;
+    fSlotEpochs[slot] = fEpoch;
+  }
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+std::uint32_t PixelAccumulator::Add(G4int layerID, G4int rowID, G4int colID, G4int trackID, G4double edep,
+                                    G4double startX, G4double startY, G4double endX, G4double endY,
+                                    G4bool fromMuon, G4bool& isNew)
+{
+  // the centroid is weighted by the step midpoints
+  const G4double localX = 0.5 * (startX + endX);
+  const G4double localY = 0.5 * (startY + endY);
+
+  // the pixel indices come from the geometry (PixelSD clamps them to the
+  // plane), which would need 2^24 pixels along a side to overflow
+  const std::uint64_t key = Key::Encode(static_cast<std::uint64_t>(layerID), static_cast<std::uint64_t>(rowID),
+                                        static_cast<std::uint64_t>(colID)).value();
+
+  std::size_t slot = Hash(key, trackID) >> fShift;
+  while (fSlotEpochs[slot] == fEpoch) {
+    if (fSlotKeys[slot] == key && fSlotTrackIDs[slot] == trackID) {
+      const std::uint32_t entry = fSlotEntries[slot];
+      fEdeps[entry] += edep;
+      fSumX[entry] += edep * localX;
+      fSumY[entry] += edep * localY;
+      if (fromMuon) fFromMuon[entry] = 1;
+      fSegments[entry].endX = endX;
+      fSegments[entry].endY = endY;
+      isNew = false;
+      return entry;
+    }
+    slot = (slot + 1) & fMask;
+  }
+
+  // first step of this track in this pixel
+  const std::uint32_t entry = fKeys.size();
+  fKeys.push_back(key);
+  fTrackIDs.push_back(trackID);
+  fEdeps.push_back(edep);
+  fSumX.push_back(edep * localX);
+  fSumY.push_back(edep * localY);
+  fFromMuon.push_back(fromMuon ? 1 : 0);
+  fSegments.push_back({startX, startY, endX, endY});
+  fPayloads.emplace_back();
+
+  fSlotKeys[slot] = key;
+  fSlotTrackIDs[slot] = trackID;
+  fSlotEntries[slot] = entry;
+  fSlotEpochs[slot] = fEpoch;
+
+  // keep the load factor below 1/2 so probe sequences stay short
+  if (2 * fKeys.size() > fSlotKeys.size()) Rehash(2 * fSlotKeys.size());
+
+  isNew = true;
+  return entry;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+const std::vector<PixelAccumulator::Pixel>& PixelAccumulator::Reduce()
+{
+  fPixels.clear();
+
+  // order by (layer, row, col, track): tracks of a pixel are adjacent and
+  // appear in increasing track ID
+  fOrder.resize(fKeys.size());
+  std::iota(fOrder.begin(), fOrder.end(), 0);
+  std::sort(fOrder.begin(), fOrder.end(), [this](std::uint32_t a, std::uint32_t b) {
+    return fKeys[a] < fKeys[b] || (fKeys[a] == fKeys[b] && fTrackIDs[a] < fTrackIDs[b]);
+  });
+
+  std::size_t i = 0;
+  while (i < fOrder.size()) {
+    const std::uint32_t firstContributor = static_cast<std::uint32_t>(i);
+    const std::uint32_t first = fOrder[i];
+    const std::uint64_t pixelKey = fKeys[first];
+
+    // the highest energy contributor represents the pixel (lowest track ID on ties)
+    std::uint32_t best = first;
+    G4double edep = 0.;
+    G4double sumX = 0., sumY = 0.;
+    G4bool fromMuon = false;
+    for (; i < fOrder.size() && fKeys[fOrder[i]] == pixelKey; ++i) {
+      const std::uint32_t entry = fOrder[i];
+      if (fPayloads[entry].p4.e() > fPayloads[best].p4.e()) best = entry;
+      edep += fEdeps[entry];
+      sumX += fSumX[entry];
+      sumY += fSumY[entry];
+      if (fFromMuon[entry]) fromMuon = true;
+    }
+    const G4double localX = (edep > 0.) ? sumX / edep : 0.;
+    const G4double localY = (edep > 0.) ? sumY / edep : 0.;
+
+    const Key key(fKeys[best]);
+    fPixels.push_back({static_cast<G4int>(key.level(0)), static_cast<G4int>(key.level(1)),
+                       static_cast<G4int>(key.level(2)), fTrackIDs[best],
+                       edep, localX, localY, fromMuon, best,
+                       firstContributor, static_cast<std::uint32_t>(i) - firstContributor});
+  }
+
+  std::sort(fPixels.begin(), fPixels.end(), [](const Pixel& a, const Pixel& b) {
+    if (a.layerID != b.layerID) return a.layerID < b.layerID;
+    if (a.rowID != b.rowID) return a.rowID < b.rowID;
+    if (a.trackID != b.trackID) return a.trackID < b.trackID;
+    return a.colID < b.colID;
+  });
+
+  return fPixels;
+}
@@ -0,0 +1,156 @@
+#include "PixelClusterizer.hh"
+#include "PixelClusterizerMessenger.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4RunManager.hh"
+
+#include <algorithm>
+
+G4ThreadLocal PixelClusterizer* PixelClusterizer::fInstance = nullptr;
+
+PixelClusterizer* PixelClusterizer::GetInstance()
+{
+  if (!fInstance) fInstance = new PixelClusterizer();
+  return fInstance;
+}
+
+PixelClusterizer::PixelClusterizer()
+{
+  fMessenger = new PixelClusterizerMessenger(this);
+}
+
+PixelClusterizer::~PixelClusterizer()
+{
+  delete fMessenger;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void PixelClusterizer::BeginOfRun()
+{
+  fClusters.clear();
+  if (!fEnabled) return;
+
+  // the geometry cannot change during a run
+  const auto det = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  fXPositions = det->GetPixelXPositions();
+  fYPositions = det->GetPixelYPositions();
+  fZPositions = det->GetPixelZPositions();
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+std::uint32_t PixelClusterizer::Find(std::uint32_t i)
+{
+  // path halving
+  while (fParent[i] != i) {
+    fParent[i] = fParent[fParent[i]];
+    i = fParent[i];
+  }
+  return i;
+}
+
+void PixelClusterizer::Join(std::uint32_t a, std::uint32_t b)
+{
+  // the root is the first pixel of the cluster in (layer, row, col) order
+  a = Find(a);
+  b = Find(b);
+  if (a < b) fParent[b] = a;
+  else if (b < a) fParent[a] = b;
+}
+
+void PixelClusterizer::Clusterize(const std::vector<PixelAccumulator::Pixel>& pixels,
+                                  const PixelAccumulator& accumulator)
+{
+  fClusters.clear();
+
+  // the pixels that make hits, in (layer, row, col) order
+  fSorted.clear();
+  for (const auto& pixel : pixels)
+    if (pixel.edep > 0.) fSorted.push_back(&pixel);
+  if (fSorted.empty()) return;
+  std::sort(fSorted.begin(), fSorted.end(), [](const PixelAccumulator::Pixel* a, const PixelAccumulator::Pixel* b) {
+    if (a->layerID != b->layerID) return a->layerID < b->layerID;
+    if (a->rowID != b->rowID) return a->rowID < b->rowID;
+    return a->colID < b->colID;
+  });
+
+  const std::uint32_t n = fSorted.size();
+  fParent.resize(n);
+  for (std::uint32_t i = 0; i < n; ++i) fParent[i] = i;
+
+  // columns reached in the previous row: the one above only (4) or also
+  // the diagonal ones (8)
+  const G4int reach = (fConnectivity == 8) ? 1 : 0;
+  std::uint32_t rowStart = 0;
+  std::uint32_t above = 0, aboveEnd = 0;  // unvisited part of the previous row
+  for (std::uint32_t i = 0; i < n; ++i) {
+    const PixelAccumulator::Pixel& pixel = *fSorted[i];
+    if (i == 0 || pixel.layerID != fSorted[i - 1]->layerID || pixel.rowID != fSorted[i - 1]->rowID) {
+      const G4bool adjacentRow = i > 0 && pixel.layerID == fSorted[i - 1]->layerID
+                                 && pixel.rowID == fSorted[i - 1]->rowID + 1;
+      above = adjacentRow ? rowStart : i;
+      aboveEnd = i;
+      rowStart = i;
+    }
+    else if (fSorted[i - 1]->colID == pixel.colID - 1) {
+      Join(i, i - 1);
+    }
+
+    // the columns increase along the row, so the walk never goes back
+    while (above < aboveEnd && fSorted[above]->colID < pixel.colID - reach) ++above;
+    for (std::uint32_t j = above; j < aboveEnd && fSorted[j]->colID <= pixel.colID + reach; ++j) Join(i, j);
+  }
+
+  // one cluster per root, in the order of their first pixel
+  fClusterOf.resize(n);
+  fTrackDeposits.clear();
+  for (std::uint32_t i = 0; i < n; ++i) {
+    const PixelAccumulator::Pixel& pixel = *fSorted[i];
+    const std::uint32_t root = Find(i);
+    if (root == i) {
+      fClusterOf[i] = fClusters.size();
+      fClusters.push_back({pixel.layerID, 0., 0., fZPositions[pixel.layerID], 0, 0., -1});
+    }
+    else {
+      fClusterOf[i] = fClusterOf[root];
+    }
+
+    Cluster& cluster = fClusters[fClusterOf[i]];
+    cluster.x += pixel.edep * fXPositions[pixel.rowID];
+    cluster.y += pixel.edep * fYPositions[pixel.colID];
+    cluster.edep += pixel.edep;
+    ++cluster.size;
+
+    const std::uint64_t clusterBits = static_cast<std::uint64_t>(fClusterOf[i]) << 32;
+    for (std::uint32_t k = pixel.firstContributor; k < pixel.firstContributor + pixel.nContributors; ++k) {
+      fTrackDeposits.emplace_back(clusterBits | static_cast<std::uint32_t>(accumulator.GetContributorTrackID(k)),
+                                  accumulator.GetContributorEdep(k));
+    }
+  }
+
+  for (Cluster& cluster : fClusters) {
+    cluster.x /= cluster.edep;
+    cluster.y /= cluster.edep;
+  }
+
+  // dominant track: sum the deposits per (cluster, track), lowest track ID on ties
+  std::sort(fTrackDeposits.begin(), fTrackDeposits.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  fBestEdep.assign(fClusters.size(), -1.);
+  std::size_t i = 0;
+  while (i < fTrackDeposits.size()) {
+    const std::uint64_t key = fTrackDeposits[i].first;
+    G4double edep = 0.;
+    for (; i < fTrackDeposits.size() && fTrackDeposits[i].first == key; ++i) edep += fTrackDeposits[i].second;
+
+    const std::size_t index = key >> 32;
+    if (edep > fBestEdep[index]) {
+      fBestEdep[index] = edep;
+      fClusters[index].trackID = static_cast<G4int>(key & 0xFFFFFFFFu);
+    }
+  }
+}
@@ -0,0 +1,44 @@
+#include "PixelClusterizerMessenger.hh"
+#include "PixelClusterizer.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+
+PixelClusterizerMessenger::PixelClusterizerMessenger(PixelClusterizer* clusterizer)
+  : fClusterizer(clusterizer)
+{
+  fClusterDir = new G4UIdirectory("/cluster/");
+  fClusterDir->SetGuidance("pixel clustering control");
+
+  fEnableCmd = new G4UIcmdWithABool("/cluster/enable", this);
+  fEnableCmd->SetGuidance("group adjacent fired pixels of each layer and save the clusters in Hits/pixelClusters");
+  fEnableCmd->SetParameterName("enable", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fConnectivityCmd = new G4UIcmdWithAnInteger("/cluster/connectivity", this);
+  fConnectivityCmd->SetGuidance("4: pixels sharing an edge are adjacent, 8: also pixels sharing a corner");
+  fConnectivityCmd->SetParameterName("connectivity", false);
+  fConnectivityCmd->SetCandidates("4 8");
+  fConnectivityCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+PixelClusterizerMessenger::~PixelClusterizerMessenger()
+{
+  delete fEnableCmd;
+  delete fConnectivityCmd;
+  delete fClusterDir;
+}
+
+
+void PixelClusterizerMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fEnableCmd)
+    fClusterizer->SetEnabled(fEnableCmd->GetNewBoolValue(newValues));
+  else if (command == fConnectivityCmd)
+    fClusterizer->SetConnectivity(fConnectivityCmd->GetNewIntValue(newValues));
+}
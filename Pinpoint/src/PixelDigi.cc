@@ -0,0 +1,20 @@
+#include "PixelDigi.hh"
+
+#include <iomanip>
+
+G4ThreadLocal G4Allocator<PixelDigi>* PixelDigiAllocator = nullptr;
+
+G4bool PixelDigi::operator==(const PixelDigi& right) const
+{
+  return ( this == &right ) ? true : false;
+}
+
+void PixelDigi::Print()
+{
+  G4cout
+     << "  layer: " << fLayerID
+     << "  pixel(" << fRowID << "," << fColID << ")"
+     << "  Charge: " << std::setw(7) << fCharge << " e"
+     << "  ToT: " << fToT
+     << G4endl;
+}
@@ -0,0 +1,184 @@
+#include "PixelDigitizer.hh"
+#include "PixelDigitizerMessenger.hh"
+#include "PixelDigi.hh"
+#include "PixelHit.hh"
+#include "PixelAccumulator.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4DigiManager.hh"
+#include "G4RunManager.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+  // bound on the clouds a long path in a pixel is split into
+  const G4int kMaxCloudsPerSegment = 64;
+}
+
+PixelDigitizer::PixelDigitizer(const G4String& name)
+  : G4VDigitizerModule(name)
+{
+  collectionName.push_back("PixelDigiCollection");
+  fMessenger = new PixelDigitizerMessenger(this);
+}
+
+PixelDigitizer::~PixelDigitizer()
+{
+  delete fMessenger;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void PixelDigitizer::Digitize()
+{
+  if (!fEnabled) return;
+
+  G4DigiManager* digiManager = G4DigiManager::GetDMpointer();
+  G4int hcID = digiManager->GetHitsCollectionID("PixelHitsCollection");
+  if (hcID < 0) return;
+  auto hitsCollection = static_cast<const PixelHitsCollection*>(digiManager->GetHitsCollection(hcID));
+
+  auto digiCollection = new PixelDigiCollection(moduleName, collectionName[0]);
+  if (!hitsCollection || hitsCollection->entries() == 0) {
+    StoreDigiCollection(digiCollection);
+    return;
+  }
+
+  const auto det = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  const G4double pitchX = det->GetPixelWidth();
+  const G4double pitchY = det->GetPixelHeight();
+  const G4int nPixelsX = static_cast<G4int>(det->GetDetectorWidth() / pitchX);
+  const G4int nPixelsY = static_cast<G4int>(det->GetDetectorHeight() / pitchY);
+
+  // split the path of every contributing track into charge clouds at most
+  // one diffusion width apart, in flat arrays. Without diffusion, or for a
+  // hit without paths, the charge sits at the deposit centroid
+  fCloudLayer.clear(); fCloudRow.clear(); fCloudCol.clear(); fCloudTrack.clear();
+  fCloudCharge.clear(); fCloudX.clear(); fCloudY.clear();
+  auto addCloud = [this](const PixelHit* hit, G4int trackID, G4double charge, G4double x, G4double y) {
+    fCloudLayer.push_back(hit->GetLayerID());
+    fCloudRow.push_back(hit->GetRowID());
+    fCloudCol.push_back(hit->GetColID());
+    fCloudTrack.push_back(trackID);
+    fCloudCharge.push_back(charge);
+    fCloudX.push_back(x);
+    fCloudY.push_back(y);
+  };
+  for (std::size_t i = 0; i < hitsCollection->entries(); ++i) {
+    const PixelHit* hit = (*hitsCollection)[i];
+    if (fDiffusionSigma <= 0. || hit->GetSegments().empty()) {
+      addCloud(hit, hit->GetTrackID(), hit->GetEnergyDeposit() / fPairEnergy, hit->GetLocalX(), hit->GetLocalY());
+      continue;
+    }
+    for (const PixelHit::Segment& segment : hit->GetSegments()) {
+      const G4double dx = segment.endX - segment.startX;
+      const G4double dy = segment.endY - segment.startY;
+      const G4int n = std::min(kMaxCloudsPerSegment,
+                               std::max(1, static_cast<G4int>(std::ceil(std::hypot(dx, dy) / fDiffusionSigma))));
+      const G4double charge = segment.edep / fPairEnergy / n;
+      for (G4int k = 0; k < n; ++k) {
+        const G4double t = (k + 0.5) / n;
+        addCloud(hit, segment.trackID, charge, segment.startX + t * dx, segment.startY + t * dy);
+      }
+    }
+  }
+  const std::size_t nClouds = fCloudCharge.size();
+
+  // fraction of a Gaussian cloud at u collected in the pixels at offsets -1, 0, +1
+  fFracX.resize(3 * nClouds);
+  fFracY.resize(3 * nClouds);
+  if (fDiffusionSigma > 0.) {
+    const G4double invSigma = 1. / (std::sqrt(2.) * fDiffusionSigma);
+    for (std::size_t i = 0; i < nClouds; ++i) {
+      const G4double lo = std::erf((-0.5 * pitchX - fCloudX[i]) * invSigma);
+      const G4double hi = std::erf(( 0.5 * pitchX - fCloudX[i]) * invSigma);
+      fFracX[3*i]     = 0.5 * (lo + 1.);
+      fFracX[3*i + 1] = 0.5 * (hi - lo);
+      fFracX[3*i + 2] = 0.5 * (1. - hi);
+    }
+    for (std::size_t i = 0; i < nClouds; ++i) {
+      const G4double lo = std::erf((-0.5 * pitchY - fCloudY[i]) * invSigma);
+      const G4double hi = std::erf(( 0.5 * pitchY - fCloudY[i]) * invSigma);
+      fFracY[3*i]     = 0.5 * (lo + 1.);
+      fFracY[3*i + 1] = 0.5 * (hi - lo);
+      fFracY[3*i + 2] = 0.5 * (1. - hi);
+    }
+  }
+  else {
+    for (std::size_t i = 0; i < nClouds; ++i) {
+      fFracX[3*i] = 0.; fFracX[3*i + 1] = 1.; fFracX[3*i + 2] = 0.;
+      fFracY[3*i] = 0.; fFracY[3*i + 1] = 1.; fFracY[3*i + 2] = 0.;
+    }
+  }
+
+  // expand every cloud into its (at most 9) neighbour contributions; charge
+  // below a fraction of the noise is dropped right away
+  const G4double minCharge = 1e-3 * std::max(fNoise, 1.);
+  fKeys.clear(); fCharges.clear(); fTracks.clear();
+  for (std::size_t i = 0; i < nClouds; ++i) {
+    for (G4int dx = -1; dx <= 1; ++dx) {
+      const G4int row = fCloudRow[i] + dx;
+      if (row < 0 || row >= nPixelsX) continue;
+      for (G4int dy = -1; dy <= 1; ++dy) {
+        const G4int col = fCloudCol[i] + dy;
+        if (col < 0 || col >= nPixelsY) continue;
+        const G4double q = fCloudCharge[i] * fFracX[3*i + dx + 1] * fFracY[3*i + dy + 1];
+        if (q < minCharge) continue;
+        fKeys.push_back(PixelAccumulator::Key::Encode(static_cast<std::uint64_t>(fCloudLayer[i]),
+                                                      static_cast<std::uint64_t>(row),
+                                                      static_cast<std::uint64_t>(col)).value());
+        fCharges.push_back(q);
+        fTracks.push_back(fCloudTrack[i]);
+      }
+    }
+  }
+
+  // sum the contributions per pixel (sorted, so output is ordered by layer, row, col;
+  // the clouds of a track are adjacent within a pixel)
+  fOrder.resize(fKeys.size());
+  std::iota(fOrder.begin(), fOrder.end(), 0);
+  std::sort(fOrder.begin(), fOrder.end(), [this](std::uint32_t a, std::uint32_t b) {
+    if (fKeys[a] != fKeys[b]) return fKeys[a] < fKeys[b];
+    if (fTracks[a] != fTracks[b]) return fTracks[a] < fTracks[b];
+    return a < b;
+  });
+
+  std::size_t i = 0;
+  while (i < fOrder.size()) {
+    const std::uint64_t key = fKeys[fOrder[i]];
+    G4double charge = 0.;
+    G4double bestCharge = -1.;
+    G4int bestTrack = -1;
+    while (i < fOrder.size() && fKeys[fOrder[i]] == key) {
+      // the track with the largest charge in the pixel (lowest track ID on ties)
+      const G4int track = fTracks[fOrder[i]];
+      G4double trackCharge = 0.;
+      for (; i < fOrder.size() && fKeys[fOrder[i]] == key && fTracks[fOrder[i]] == track; ++i)
+        trackCharge += fCharges[fOrder[i]];
+      charge += trackCharge;
+      if (trackCharge > bestCharge) { bestCharge = trackCharge; bestTrack = track; }
+    }
+
+    if (fNoise > 0.) charge += G4RandGauss::shoot(0., fNoise);
+    if (charge < fThreshold) continue;
+
+    const G4int tot = std::min(fToTMax, 1 + static_cast<G4int>((charge - fThreshold) / fToTChargePerCount));
+
+    const PixelAccumulator::Key pixel(key);
+    auto digi = new PixelDigi();
+    digi->SetLayerID(static_cast<G4int>(pixel.level(0)));
+    digi->SetRowID(static_cast<G4int>(pixel.level(1)));
+    digi->SetColID(static_cast<G4int>(pixel.level(2)));
+    digi->SetCharge(charge);
+    digi->SetToT(tot);
+    digi->SetTrackID(bestTrack);
+    digiCollection->insert(digi);
+  }
+
+  StoreDigiCollection(digiCollection);
+}
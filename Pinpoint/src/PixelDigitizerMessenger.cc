@@ -0,0 +1,84 @@
+#include "PixelDigitizerMessenger.hh"
+#include "PixelDigitizer.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+
+PixelDigitizerMessenger::PixelDigitizerMessenger(PixelDigitizer* digitizer)
+  : fDigitizer(digitizer)
+{
+  fDigiDir = new G4UIdirectory("/digi/");
+  fDigiDir->SetGuidance("pixel digitization control");
+
+  fEnableCmd = new G4UIcmdWithABool("/digi/enable", this);
+  fEnableCmd->SetGuidance("run the pixel digitization and save the fired pixels in Hits/pixelDigis");
+  fEnableCmd->SetParameterName("enable", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fThresholdCmd = new G4UIcmdWithADouble("/digi/threshold", this);
+  fThresholdCmd->SetGuidance("pixel threshold in electrons");
+  fThresholdCmd->SetParameterName("threshold", false);
+  fThresholdCmd->SetRange("threshold>=0.");
+  fThresholdCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fNoiseCmd = new G4UIcmdWithADouble("/digi/noise", this);
+  fNoiseCmd->SetGuidance("Gaussian noise per pixel in electrons");
+  fNoiseCmd->SetParameterName("noise", false);
+  fNoiseCmd->SetRange("noise>=0.");
+  fNoiseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fDiffusionSigmaCmd = new G4UIcmdWithADoubleAndUnit("/digi/diffusionSigma", this);
+  fDiffusionSigmaCmd->SetGuidance("lateral width of the charge cloud, 0 disables charge sharing");
+  fDiffusionSigmaCmd->SetParameterName("diffusionSigma", false);
+  fDiffusionSigmaCmd->SetUnitCategory("Length");
+  fDiffusionSigmaCmd->SetDefaultUnit("um");
+  fDiffusionSigmaCmd->SetRange("diffusionSigma>=0.");
+  fDiffusionSigmaCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fToTChargePerCountCmd = new G4UIcmdWithADouble("/digi/totChargePerCount", this);
+  fToTChargePerCountCmd->SetGuidance("charge above threshold (electrons) per time-over-threshold count");
+  fToTChargePerCountCmd->SetParameterName("totChargePerCount", false);
+  fToTChargePerCountCmd->SetRange("totChargePerCount>0.");
+  fToTChargePerCountCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fToTMaxCmd = new G4UIcmdWithAnInteger("/digi/totMax", this);
+  fToTMaxCmd->SetGuidance("saturation value of the time-over-threshold counter");
+  fToTMaxCmd->SetParameterName("totMax", false);
+  fToTMaxCmd->SetRange("totMax>0");
+  fToTMaxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+PixelDigitizerMessenger::~PixelDigitizerMessenger()
+{
+  delete fEnableCmd;
+  delete fThresholdCmd;
+  delete fNoiseCmd;
+  delete fDiffusionSigmaCmd;
+  delete fToTChargePerCountCmd;
+  delete fToTMaxCmd;
+  delete fDigiDir;
+}
+
+
+void PixelDigitizerMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fEnableCmd)
+    fDigitizer->SetEnabled(fEnableCmd->GetNewBoolValue(newValues));
+  else if (command == fThresholdCmd)
+    fDigitizer->SetThreshold(fThresholdCmd->GetNewDoubleValue(newValues));
+  else if (command == fNoiseCmd)
+    fDigitizer->SetNoise(fNoiseCmd->GetNewDoubleValue(newValues));
+  else if (command == fDiffusionSigmaCmd)
+    fDigitizer->SetDiffusionSigma(fDiffusionSigmaCmd->GetNewDoubleValue(newValues));
+  else if (command == fToTChargePerCountCmd)
+    fDigitizer->SetToTChargePerCount(fToTChargePerCountCmd->GetNewDoubleValue(newValues));
+  else if (command == fToTMaxCmd)
+    fDigitizer->SetToTMax(fToTMaxCmd->GetNewIntValue(newValues));
+}
@@ -2,6 +2,8 @@
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
+#include "G4AffineTransform.hh"
+#include "G4NavigationHistory.hh"
 #include "G4SDManager.hh"
 #include "G4Track.hh"
 #include "G4VTouchable.hh"
@@ -9,81 +11,35 @@
 #include "G4ParticleDefinition.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4ios.hh"
-#include <map>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include "G4LorentzVector.hh"
 #include "G4RunManager.hh"
 #include "G4Event.hh"
-#include "TrackInformation.hh"
-
-
-// std::set<G4int> PixelSD::sPrimaryDescendants;
-std::set<std::pair<G4int, G4int>> PixelSD::sHitParticles;
-std::set<G4int> PixelSD::sMuonDescendants;
-
-// Structure to uniquely identify a pixel
-struct PixelID {
-  G4int layerID;
-  G4int rowID;
-  G4int colID;
-  G4LorentzVector p4;
-  G4ThreeVector truthPos;
-  G4int pdgCode;
-  G4int charge;
-  G4int trackID;
-  G4int parentID;
-  G4bool fromPrimaryPi0;
-  G4bool fromFSLPi0;
-  G4bool fromPrimaryLepton;
-  
-  bool operator<(const PixelID& other) const {
-    if (layerID != other.layerID) return layerID < other.layerID;
-    if (rowID != other.rowID) return rowID < other.rowID;
-    if (trackID != other.trackID) return trackID < other.trackID;
-    return colID < other.colID;
-  }
-
-  bool operator==(const PixelID& other) const {
-    return layerID == other.layerID &&
-           rowID == other.rowID &&
-           colID == other.colID;
-  }
-
-};
-
-struct PixelKey {
-  G4int layerID;
-  G4int rowID;
-  G4int colID;
-
-  bool operator==(const PixelKey& other) const {
-    return layerID == other.layerID &&
-           rowID == other.rowID &&
-           colID == other.colID;
-  }
-};
-
-// Hash function for PixelKey
-namespace std {
-  template <>
-  struct hash<PixelKey> {
-    std::size_t operator()(const PixelKey& k) const {
-      return ((std::hash<G4int>()(k.layerID) ^ (std::hash<G4int>()(k.rowID) << 1)) >> 1)
-             ^ (std::hash<G4int>()(k.colID) << 1);
-    }
-  };
-}
-
-static std::unordered_map<PixelKey, PixelID> bestPixels;
-static std::unordered_map<PixelKey, double>  totalCharge;
+#include "G4FastHit.hh"
+#include "G4FastTrack.hh"
+#include "AnalysisManager.hh"
+#include "TrackTable.hh"
+#include "TrackHitTable.hh"
+#include "PerfMonitor.hh"
+#include "StackingPolicy.hh"
+#include "FastShower.hh"
+#include "PixelClusterizer.hh"
+#include "PixelDigitizer.hh"
+#include "G4DigiManager.hh"
+#include "ActsOutput.hh"
+#include "reco/PixelChannel.hh"
 
 
-// Map to accumulate charge in each pixel during an event
-static std::map<PixelID, G4double> pixelChargeMap;
-// Map to track if pixel received energy from muon descendants
-static std::map<PixelID, G4bool> pixelFromMuonMap;
-
 PixelSD::PixelSD(const G4String& name, const G4String& hitsCollectionName)
-  : G4VSensitiveDetector(name)
+  : G4VSensitiveDetector(name), fPerfMonitor(PerfMonitor::GetInstance()),
+    fStackingPolicy(StackingPolicy::GetInstance()),
+    fTrackTable(&AnalysisManager::GetInstance()->GetTrackTable()),
+    fTrackHits(&AnalysisManager::GetInstance()->GetTrackHitTable()),
+    fFastShower(FastShower::GetInstance()),
+    fClusterizer(PixelClusterizer::GetInstance()),
+    fActsOutput(&AnalysisManager::GetInstance()->GetActsOutput())
 {
   collectionName.insert(hitsCollectionName);
 }
@@ -96,17 +52,19 @@ void PixelSD::Initialize(G4HCofThisEvent* hce)
   G4int hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
   hce->AddHitsCollection(hcID, fHitsCollection);
   
-  // Clear the pixel charge map for this event
-  pixelChargeMap.clear();
-  pixelFromMuonMap.clear();
-  bestPixels.clear();
-  totalCharge.clear();
-  fCurrentHitId = 0;
+  // Reset the event buffers, keeping their capacity
+  fAccumulator.Clear();
+  fFullShowerPixels.clear();
+  fFastShowerPixels.clear();
+  fTrackHits->Clear();
+  fActsOutput->Clear();
 }
 
 
 G4bool PixelSD::ProcessHits(G4Step* step, G4TouchableHistory* /*history*/)
 {
+  fPerfMonitor->CountProcessHits(PerfRow::kPixelSD);
+
   G4Track* track = step->GetTrack();
   
   if (track->GetDefinition()->GetPDGCharge() == 0) {
@@ -120,73 +78,193 @@ G4bool PixelSD::ProcessHits(G4Step* step, G4TouchableHistory* /*history*/)
 
 
 
-  G4StepPoint* preStepPoint = step->GetPreStepPoint();
-  G4TouchableHandle touchable = preStepPoint->GetTouchableHandle();
-  
-  G4int rowIDVolume = 0, colIDVolume = 1, layerVolume = 3;
-  G4int rowID = touchable->GetCopyNumber(rowIDVolume);
-  G4int colID = touchable->GetCopyNumber(colIDVolume);
-  G4int layerID = touchable->GetCopyNumber(layerVolume);
-  G4int trackID = track->GetTrackID();
-  G4int parentID = track->GetParentID();
-  G4ThreeVector truthPos = preStepPoint->GetPosition();
-  G4int pdgid = track->GetParticleDefinition()->GetPDGEncoding();
   G4LorentzVector p4 = track->GetDynamicParticle()->Get4Momentum();
-  G4int charge = track->GetDefinition()->GetPDGCharge();
-  
+
   // TODO: Min hit energy of 360 eV
   if (p4.e() <= 360*1E-6) {
     return false;
   }
 
+  // for the stacking policy validation
+  fStackingPolicy->CountPixelStep(track->GetTrackID());
+
+  G4StepPoint* preStepPoint = step->GetPreStepPoint();
+  G4TouchableHandle touchable = preStepPoint->GetTouchableHandle();
+
+  if (!fAnalyticReadout) {
+    // pixel replicas: the touchable already knows the pixel
+    G4int rowIDVolume = 0, colIDVolume = 1, layerVolume = 3;
+    G4int rowID = touchable->GetCopyNumber(rowIDVolume);
+    G4int colID = touchable->GetCopyNumber(colIDVolume);
+    G4int layerID = touchable->GetCopyNumber(layerVolume);
+    // step end points in the pixel frame (the pixel is centred on its origin)
+    const G4AffineTransform& toLocal = touchable->GetHistory()->GetTopTransform();
+    G4ThreeVector start = toLocal.TransformPoint(preStepPoint->GetPosition());
+    G4ThreeVector end = toLocal.TransformPoint(step->GetPostStepPoint()->GetPosition());
+    AddDeposit(track, layerID, rowID, colID, edep, start.x(), start.y(), end.x(), end.y(),
+               preStepPoint->GetPosition(), preStepPoint->GetGlobalTime(), p4);
+  }
+  else {
+    // solid silicon layer: the pixel is computed from the local position.
+    // A step may cross several pixels, its deposit is shared among them in
+    // proportion to the path length in each (as replica boundaries would do)
+    G4int layerID = touchable->GetCopyNumber(1);
+    const G4AffineTransform& toLocal = touchable->GetHistory()->GetTopTransform();
+    const G4ThreeVector& globalStart = preStepPoint->GetPosition();
+    const G4ThreeVector& globalEnd = step->GetPostStepPoint()->GetPosition();
+    const G4double timeStart = preStepPoint->GetGlobalTime();
+    const G4double timeEnd = step->GetPostStepPoint()->GetGlobalTime();
+    G4ThreeVector start = toLocal.TransformPoint(globalStart);
+    G4ThreeVector end = toLocal.TransformPoint(globalEnd);
+
+    const G4double xMin = -0.5 * fNPixelsX * fPixelPitchX;
+    const G4double yMin = -0.5 * fNPixelsY * fPixelPitchY;
+    G4int ix = static_cast<G4int>(std::floor((start.x() - xMin) / fPixelPitchX));
+    G4int iy = static_cast<G4int>(std::floor((start.y() - yMin) / fPixelPitchY));
+    const G4int ixEnd = static_cast<G4int>(std::floor((end.x() - xMin) / fPixelPitchX));
+    const G4int iyEnd = static_cast<G4int>(std::floor((end.y() - yMin) / fPixelPitchY));
+
+    // offset of a local point from the centre of the pixel it is assigned to
+    auto offsetX = [&](G4double x, G4int i) { return x - (xMin + (ClampPixel(i, fNPixelsX) + 0.5) * fPixelPitchX); };
+    auto offsetY = [&](G4double y, G4int i) { return y - (yMin + (ClampPixel(i, fNPixelsY) + 0.5) * fPixelPitchY); };
+
+    if (ix == ixEnd && iy == iyEnd) {
+      AddDeposit(track, layerID, ClampPixel(ix, fNPixelsX), ClampPixel(iy, fNPixelsY), edep,
+                 offsetX(start.x(), ix), offsetY(start.y(), iy), offsetX(end.x(), ix), offsetY(end.y(), iy),
+                 globalStart, timeStart, p4);
+    }
+    else {
+      // walk the pixel grid along the segment (parameter t in [0,1])
+      const G4double dx = end.x() - start.x();
+      const G4double dy = end.y() - start.y();
+      const G4int stepX = (dx > 0) ? 1 : -1;
+      const G4int stepY = (dy > 0) ? 1 : -1;
+      const G4double tDeltaX = (dx != 0) ? fPixelPitchX / std::abs(dx) : DBL_MAX;
+      const G4double tDeltaY = (dy != 0) ? fPixelPitchY / std::abs(dy) : DBL_MAX;
+      G4double tMaxX = (dx != 0) ? (xMin + (ix + (stepX > 0 ? 1 : 0)) * fPixelPitchX - start.x()) / dx : DBL_MAX;
+      G4double tMaxY = (dy != 0) ? (yMin + (iy + (stepY > 0 ? 1 : 0)) * fPixelPitchY - start.y()) / dy : DBL_MAX;
+
+      G4double t0 = 0.;
+      G4int nCells = std::abs(ixEnd - ix) + std::abs(iyEnd - iy) + 1;
+      for (G4int cell = 0; cell < nCells; ++cell) {
+        G4double t1 = (cell == nCells - 1) ? 1. : std::min(std::min(tMaxX, tMaxY), 1.);
+        if (t1 > t0) {
+          G4ThreeVector p0 = start + t0 * (end - start);
+          G4ThreeVector p1 = start + t1 * (end - start);
+          AddDeposit(track, layerID, ClampPixel(ix, fNPixelsX), ClampPixel(iy, fNPixelsY), edep * (t1 - t0),
+                     offsetX(p0.x(), ix), offsetY(p0.y(), iy), offsetX(p1.x(), ix), offsetY(p1.y(), iy),
+                     globalStart + t0 * (globalEnd - globalStart), timeStart + t0 * (timeEnd - timeStart), p4);
+        }
+        t0 = t1;
+        if (tMaxX < tMaxY) { ix += stepX; tMaxX += tDeltaX; }
+        else               { iy += stepY; tMaxY += tDeltaY; }
+      }
+    }
+  }
+
+  return true;
+}
+
+
+G4bool PixelSD::ProcessHits(const G4FastHit* hit, const G4FastTrack* fastTrack, G4TouchableHistory* touchable)
+{
+  fPerfMonitor->CountProcessHits(PerfRow::kPixelSD);
+
+  const G4ThreeVector& position = hit->GetPosition();
+  const G4ThreeVector local = touchable->GetHistory()->GetTopTransform().TransformPoint(position);
+
+  G4int layerID, rowID, colID;
+  G4double localX = local.x(), localY = local.y();
+  if (!fAnalyticReadout) {
+    // same copy numbers as for steps, the local point is relative to the pixel centre
+    rowID = touchable->GetCopyNumber(0);
+    colID = touchable->GetCopyNumber(1);
+    layerID = touchable->GetCopyNumber(3);
+  }
+  else {
+    layerID = touchable->GetCopyNumber(1);
+    const G4double xMin = -0.5 * fNPixelsX * fPixelPitchX;
+    const G4double yMin = -0.5 * fNPixelsY * fPixelPitchY;
+    rowID = ClampPixel(static_cast<G4int>(std::floor((local.x() - xMin) / fPixelPitchX)), fNPixelsX);
+    colID = ClampPixel(static_cast<G4int>(std::floor((local.y() - yMin) / fPixelPitchY)), fNPixelsY);
+    localX -= xMin + (rowID + 0.5) * fPixelPitchX;
+    localY -= yMin + (colID + 0.5) * fPixelPitchY;
+  }
+
+  // validation: the full simulation of the same track provides the hits
+  if (fFastShower->IsValidating()) {
+    fFastShowerPixels.push_back(PixelChannel().setLayer(layerID).setRow(rowID).setCol(colID).value());
+    return true;
+  }
+
+  // the spots are attributed to the track taken over by the model
+  const G4Track* track = fastTrack->GetPrimaryTrack();
+  AddDeposit(track, layerID, rowID, colID, hit->GetEnergy(), localX, localY, localX, localY, position,
+             track->GetGlobalTime(), track->GetDynamicParticle()->Get4Momentum());
+
+  return true;
+}
+
+
+void PixelSD::AddDeposit(const G4Track* track, G4int layerID, G4int rowID, G4int colID, G4double edep,
+                         G4double startX, G4double startY, G4double endX, G4double endY,
+                         const G4ThreeVector& truthPos, G4double truthTime, const G4LorentzVector& p4)
+{
+  G4int trackID = track->GetTrackID();
+
   // G4cout << "Processing hit: TrackID=" << trackID 
-  //        << " PDG=" << pdgid 
   //        << " Layer=" << layerID 
   //        << " Row=" << rowID 
   //        << " Col=" << colID 
   //        << " Edep=" << edep/keV << " keV" 
   //        << G4endl;
 
-  // Get information from TrackInformation if available
-  TrackInformation* trackInfo = dynamic_cast<TrackInformation*>(track->GetUserInformation());
-  G4bool fromPrimaryPi0 = trackInfo ? (trackInfo->IsTrackFromPrimaryPizero() != 0) : false;
-  G4bool fromFSLPi0 = trackInfo ? (trackInfo->IsTrackFromFSLPizero() != 0) : false;
-  G4bool fromPrimaryLepton = trackInfo ? (trackInfo->IsTrackFromPrimaryLepton() != 0) : false;
-
-  // if (trackInfo) {
-  //   G4cout << "TrackID=" << trackID 
-  //          << " fromPrimaryPi0=" << fromPrimaryPi0
-  //          << " fromFSLPi0=" << fromFSLPi0
-  //          << " fromPrimaryLepton=" << fromPrimaryLepton
-  //          << G4endl;
-  // }
-
-  // Create pixel identifier
-  PixelID pixelId = {layerID, rowID, colID, p4, truthPos, pdgid, charge, trackID, parentID, fromPrimaryPi0, fromFSLPi0, fromPrimaryLepton};
-  pixelChargeMap[pixelId] += edep;
-
+  const TrackTable::Entry& origin = fTrackTable->Get(trackID);
 
+  // fast shower validation: pixels fired by the tracks the model would take
+  if ((origin.flags & TrackTable::kFastShower) && fFastShower->IsValidating()) {
+    fFullShowerPixels.push_back(PixelChannel().setLayer(layerID).setRow(rowID).setCol(colID).value());
+  }
+  // shower library recording: the deposit goes to the pattern of the tagged ancestor
+  if ((origin.flags & TrackTable::kFastShower) && fFastShower->IsRecording()) {
+    fFastShower->GetLibrary().AddDeposit(fTrackTable->GetFlagOrigin(trackID, TrackTable::kFastShower), truthPos, edep);
+  }
 
- 
-  // if (!trackInfo) {
-  //     trackInfo = new TrackInformation(track); // or just new TrackInformation();
-  //     track->SetUserInformation(trackInfo);
-  // }
-  // trackInfo->InsertHit(fCurrentHitId);
-  fCurrentHitId++;
+  G4bool isNew = false;
+  std::uint32_t entry = fAccumulator.Add(layerID, rowID, colID, trackID, edep, startX, startY, endX, endY,
+                                         (origin.flags & TrackTable::kFromMuon) != 0, isNew);
+
+  // The truth payload is the one of the first step of this track in this pixel,
+  // later steps only add their energy
+  if (isNew) {
+    PixelAccumulator::Payload& payload = fAccumulator.GetPayload(entry);
+    payload.p4 = p4;
+    payload.truthPos = truthPos;
+    payload.time = truthTime;
+    payload.pdgCode = track->GetParticleDefinition()->GetPDGEncoding();
+    payload.charge = track->GetDefinition()->GetPDGCharge();
+    payload.parentID = track->GetParentID();
+    payload.fromPrimaryPi0 = (origin.flags & TrackTable::kFromPrimaryPizero) != 0;
+    payload.fromFSLPi0 = (origin.flags & TrackTable::kFromFSLPizero) != 0;
+    payload.fromPrimaryLepton = (origin.flags & TrackTable::kFromPrimaryLepton) != 0;
+  }
+}
 
 
-  // Track if this pixel received energy from a muon descendant
-  if (IsFromMuon(trackID)) {
-    pixelFromMuonMap[pixelId] = true;
-  }
-  
-  return true;
+void PixelSD::SetAnalyticReadout(G4int nPixelsX, G4int nPixelsY, G4double pitchX, G4double pitchY)
+{
+  fAnalyticReadout = true;
+  fNPixelsX = nPixelsX;
+  fNPixelsY = nPixelsY;
+  fPixelPitchX = pitchX;
+  fPixelPitchY = pitchY;
 }
 
 
 void PixelSD::EndOfEvent(G4HCofThisEvent* /*hce*/)
 {
+  PerfMonitor::SDTimer timer(fPerfMonitor, PerfRow::kPixelSD);
+
   // Get detector geometry parameters from DetectorConstruction
   // G4double tungstenThickness = DetectorConstruction::GetTungstenThickness();
   // G4double siliconThickness = DetectorConstruction::GetSiliconThickness();
@@ -196,51 +274,44 @@ void PixelSD::EndOfEvent(G4HCofThisEvent* /*hce*/)
   // G4double pixelSizeY = DetectorConstruction::GetPixelSizeY();
   // G4double layerThickness = DetectorConstruction::GetLayerThickness();
 
-  for (const auto& [pixel, charge] : pixelChargeMap) {
-    PixelKey key{pixel.layerID, pixel.rowID, pixel.colID};
-  
-    auto it = bestPixels.find(key);
-    if (it == bestPixels.end()) {
-      bestPixels[key] = pixel;
-      totalCharge[key] = charge;
-    } else {
-      const auto& existing = it->second;
-      if (pixel.trackID != existing.trackID) {
-        if (pixel.p4.e() > existing.p4.e()) {
-          bestPixels[key] = pixel;
-        }
-        totalCharge[key] += charge;
-      }
-    }
-  }
-  pixelChargeMap.clear();
-  for (const auto& [key, pixel] : bestPixels) {
-    pixelChargeMap[pixel] = totalCharge[key];
-  }
-  
+  // One entry per pixel with the deposit summed over all tracks, the
+  // highest energy track being the representative
+  const auto& pixels = fAccumulator.Reduce();
+
+  // the digitizer spreads the charge along the path of every track
+  auto digitizer = static_cast<PixelDigitizer*>(G4DigiManager::GetDMpointer()->FindDigitizerModule("PixelDigitizer"));
+  const G4bool storeSegments = digitizer && digitizer->IsEnabled();
 
   // Create hits from accumulated charge in each pixel
-  for (const auto& pixel : pixelChargeMap) {
-    const PixelID& pixelId = pixel.first;
-    G4double totalCharge = pixel.second;
-    
+  for (const auto& pixelId : pixels) {
+    G4double totalCharge = pixelId.edep;
+    const auto& payload = fAccumulator.GetPayload(pixelId.entry);
+
     // Only create a hit if there's significant charge deposit
     if (totalCharge > 0.0) {
       auto newHit = new PixelHit();
       newHit->SetLayerID(pixelId.layerID);
       newHit->SetRowID(pixelId.rowID);
       newHit->SetColID(pixelId.colID);
-      newHit->SetP4(pixelId.p4);
-      newHit->SetCharge(pixelId.charge);
+      newHit->SetP4(payload.p4);
+      newHit->SetCharge(payload.charge);
       newHit->SetTrackID(pixelId.trackID);
-      newHit->SetParentID(pixelId.parentID);
-      newHit->SetPDGCode(pixelId.pdgCode);
+      newHit->SetParentID(payload.parentID);
+      newHit->SetPDGCode(payload.pdgCode);
       newHit->SetEnergyDeposit(totalCharge);
-      newHit->SetFromMuon(pixelFromMuonMap[pixelId]);  // Set if any track from muon hit this pixel
-      newHit->SetFromPrimaryPizero(pixelId.fromPrimaryPi0);
-      newHit->SetFromFSLPizero(pixelId.fromFSLPi0);
-      newHit->SetFromPrimaryLepton(pixelId.fromPrimaryLepton);
-      newHit->SetTruthHitPos(pixelId.truthPos);
+      newHit->SetFromMuon(pixelId.fromMuon);  // Set if any track from muon hit this pixel
+      newHit->SetFromPrimaryPizero(payload.fromPrimaryPi0);
+      newHit->SetFromFSLPizero(payload.fromFSLPi0);
+      newHit->SetFromPrimaryLepton(payload.fromPrimaryLepton);
+      newHit->SetTruthHitPos(payload.truthPos);
+      newHit->SetLocalPos(pixelId.localX, pixelId.localY);
+      if (storeSegments) {
+        for (std::uint32_t i = pixelId.firstContributor; i < pixelId.firstContributor + pixelId.nContributors; ++i) {
+          const PixelAccumulator::Segment& segment = fAccumulator.GetContributorSegment(i);
+          newHit->AddSegment({fAccumulator.GetContributorTrackID(i), fAccumulator.GetContributorEdep(i),
+                              segment.startX, segment.startY, segment.endX, segment.endY});
+        }
+      }
       
       // Calculate pixel center position in global coordinates
       // X position: pixel index to world coordinates
@@ -262,10 +333,21 @@ void PixelSD::EndOfEvent(G4HCofThisEvent* /*hce*/)
       // newHit->SetTrackID(-1); // Multiple tracks may contribute
       // newHit->SetPDGCode(0);   // Multiple particle types may contribute
       // newHit->SetIsFromPrimary(false); // Could be mix of primary/secondary
-      
+
+      // the hit index is its position in the collection and in the output
+      const auto hitIndex = static_cast<std::uint32_t>(fHitsCollection->entries());
+      for (std::uint32_t i = pixelId.firstContributor; i < pixelId.firstContributor + pixelId.nContributors; ++i)
+        fTrackHits->Link(fAccumulator.GetContributorTrackID(i), hitIndex);
+
       fHitsCollection->insert(newHit);
     }
   }
+  fTrackHits->Build();
+  if (fClusterizer->IsEnabled()) fClusterizer->Clusterize(pixels, fAccumulator);
+  if (fActsOutput->IsEnabled()) fActsOutput->AddSimHits(pixels, fAccumulator);
+  fPerfMonitor->CountHits(PerfRow::kPixelSD, fHitsCollection->entries());
+  if (fFastShower->IsValidating()) fFastShower->AddValidationEvent(fFullShowerPixels, fFastShowerPixels);
+  if (fFastShower->IsRecording()) fFastShower->GetLibrary().EndOfEvent();
 
   if (verboseLevel > 1) {
     std::size_t nofHits = fHitsCollection->entries();
@@ -275,54 +357,3 @@ void PixelSD::EndOfEvent(G4HCofThisEvent* /*hce*/)
       (*fHitsCollection)[i]->Print();
   }
 }
-
-
-// void PixelSD::ClearTrackHistory()
-// {
-//   // sPrimaryDescendants.clear();
-//   sHitParticles.clear();
-//   // Track 1 will be added when RecordTrackParent is called for it
-// }
-
-// void PixelSD::RecordTrackParent(G4int trackID, G4int parentID)
-// {
-//   if (trackID == 1) {
-//     sPrimaryDescendants.insert(trackID);
-//     return;
-//   }
-
-//   // For other tracks, check if parent is from primary
-//   // Special case: if parent is 1, then this track is from primary
-//   if (parentID == 1) {
-//     sPrimaryDescendants.insert(trackID);
-//     return;
-//   }
-
-//   // If parent is already known to be from primary, add this track too
-//   if (sPrimaryDescendants.find(parentID) != sPrimaryDescendants.end()) {
-//     sPrimaryDescendants.insert(trackID);
-//   }
-// }
-
-// G4bool PixelSD::IsFromPrimaryTrack(G4int trackID)
-// {
-//   // Simple O(1) lookup in the set
-//   return sPrimaryDescendants.find(trackID) != sPrimaryDescendants.end();
-// }
-
-void PixelSD::RecordMuonDescendant(G4int trackID, G4bool fromMuon)
-{
-  if (fromMuon) {
-    sMuonDescendants.insert(trackID);
-  }
-}
-
-G4bool PixelSD::IsFromMuon(G4int trackID)
-{
-  return sMuonDescendants.find(trackID) != sMuonDescendants.end();
-}
-
-void PixelSD::ClearMuonHistory()
-{
-  sMuonDescendants.clear();
-}
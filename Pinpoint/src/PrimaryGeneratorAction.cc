@@ -8,9 +8,13 @@
 #include "generators/GPSGenerator.hh"
 
 #include "EventInformation.hh"
+#include "EventSeeder.hh"
 
 #include "G4Event.hh"
 #include "G4Exception.hh"
+#include "Logging.hh"
+
+#include <algorithm>
 
 G4long PrimaryGeneratorAction::fFirstEvent = -1;
 
@@ -22,6 +26,8 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
   // start with default generator
   fGenerator = new GPSGenerator();
   fInitialized = false;
+  fIOCacheSize = 30*1024*1024;
+  fPrintIOStats = false;
 
 }
 
@@ -35,8 +41,13 @@ void PrimaryGeneratorAction::SetGenerator(G4String name)
 {
   G4StrUtil::to_lower(name);
 
-  if( name == "genie" )
-    fGenerator = new GENIEGenerator();
+  if( name == "genie" ) {
+    GENIEGenerator* genieGen = new GENIEGenerator();
+    if (fFirstEvent >= 0) {
+      genieGen->SetEvtStartIdx(fFirstEvent);
+    }
+    fGenerator = genieGen;
+  }
   else if ( name == "gfaser" ) {
     GFaserGenerator* gfaserGen = new GFaserGenerator();
     if (fFirstEvent >= 0) {
@@ -44,8 +55,13 @@ void PrimaryGeneratorAction::SetGenerator(G4String name)
     }
     fGenerator = gfaserGen;
   }
-  else if( name == "hepmc" )
-    fGenerator = new HepMCGenerator();
+  else if( name == "hepmc" ) {
+    HepMCGenerator* hepmcGen = new HepMCGenerator();
+    if (fFirstEvent >= 0) {
+      hepmcGen->SetFirstEvent(fFirstEvent);
+    }
+    fGenerator = hepmcGen;
+  }
   else if ( name == "gun" )
     fGenerator = new GPSGenerator();
   else{
@@ -63,12 +79,17 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   // load generator data at first event
   // this function opens files, reads trees, etc (if required)
   if(!fInitialized){
+    fGenerator->SetIOCacheSize(fIOCacheSize);
     fGenerator->LoadData();
     fInitialized = true;
   }
 
-  G4cout << G4endl;
-  G4cout << "===oooOOOooo=== Event Generator (# " << anEvent->GetEventID();
+  // the random sequence of the event depends only on the run seed and its
+  // index in the full sample, not on the thread or the shard it runs in
+  EventSeeder::SeedEvent(std::max<G4long>(fFirstEvent, 0) + anEvent->GetEventID());
+
+  LOG_DEBUG("\n===oooOOOooo=== Event Generator (# " << anEvent->GetEventID()
+            << ") : " << fGenerator->GetGeneratorName() << " ===oooOOOooo===");
 
   // reset event metadata
   fGenerator->ResetEventMetadata();
@@ -80,3 +101,8 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   anEvent->SetUserInformation(new EventInformation(fGenerator->GetEventMetadata()));
 
 }
+
+void PrimaryGeneratorAction::EndOfRun() const
+{
+  if (fPrintIOStats && fInitialized) fGenerator->PrintIOStats();
+}
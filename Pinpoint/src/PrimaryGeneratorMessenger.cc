@@ -4,6 +4,8 @@
 #include "G4UIdirectory.hh"
 #include "G4UIcommand.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -20,6 +22,19 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* act
   fGeneratorOption->SetDefaultValue("gun");
   fGeneratorOption->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
 
+  fIOCacheSizeCmd = new G4UIcmdWithAnInteger("/gen/ioCacheSize", this);
+  fIOCacheSizeCmd->SetGuidance("size in MB of the read-ahead cache (TTreeCache) of the GENIE and GFaser input trees");
+  fIOCacheSizeCmd->SetGuidance("the cache covers the entries of the run, 0 disables it");
+  fIOCacheSizeCmd->SetParameterName("ioCacheSize", false);
+  fIOCacheSizeCmd->SetRange("ioCacheSize>=0");
+  fIOCacheSizeCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
+  fPrintIOStatsCmd = new G4UIcmdWithABool("/gen/printIOStats", this);
+  fPrintIOStatsCmd->SetGuidance("print the bytes read, read calls and cache efficiency of the generator input at the end of each run");
+  fPrintIOStatsCmd->SetParameterName("printIOStats", true);
+  fPrintIOStatsCmd->SetDefaultValue(true);
+  fPrintIOStatsCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -27,6 +42,8 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* act
 PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
 {
   delete fGeneratorOption;
+  delete fIOCacheSizeCmd;
+  delete fPrintIOStatsCmd;
   delete fGeneratorDir;
 }
 
@@ -36,6 +53,10 @@ void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newVa
 {
   if (command == fGeneratorOption) 
     fPrimGenAction->SetGenerator(newValues);
+  else if (command == fIOCacheSizeCmd)
+    fPrimGenAction->SetIOCacheSize(static_cast<G4long>(fIOCacheSizeCmd->GetNewIntValue(newValues))*1024*1024);
+  else if (command == fPrintIOStatsCmd)
+    fPrimGenAction->SetPrintIOStats(fPrintIOStatsCmd->GetNewBoolValue(newValues));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
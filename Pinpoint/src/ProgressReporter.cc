@@ -0,0 +1,46 @@
+#include "ProgressReporter.hh"
+#include "Logging.hh"
+
+#include <iomanip>
+#include <sstream>
+
+std::atomic<G4int> ProgressReporter::fInterval{1000};
+std::atomic<G4long> ProgressReporter::fNDone{0};
+G4int ProgressReporter::fNTotal = 0;
+ProgressReporter::Clock::time_point ProgressReporter::fStart;
+
+void ProgressReporter::BeginOfRun(G4int nEventsToProcess)
+{
+  fNTotal = nEventsToProcess;
+  fNDone.store(0);
+  fStart = Clock::now();
+}
+
+void ProgressReporter::EventDone()
+{
+  const G4long done = fNDone.fetch_add(1, std::memory_order_relaxed) + 1;
+  const G4int interval = fInterval.load(std::memory_order_relaxed);
+  if (interval <= 0 || done % interval != 0) return;
+
+  const G4double elapsed = std::chrono::duration<G4double>(Clock::now() - fStart).count();
+  const G4double rate = (elapsed > 0.) ? done / elapsed : 0.;
+  const G4double eta = (rate > 0. && fNTotal > done) ? (fNTotal - done) / rate : 0.;
+
+  // formatted apart so the precision of G4cout is left alone
+  std::ostringstream os;
+  os << "Progress: " << done << " / " << fNTotal << " events, " << std::fixed
+     << std::setprecision(2) << rate << " events/s, ETA " << std::setprecision(0) << eta << " s";
+  LOG_INFO(os.str());
+}
+
+void ProgressReporter::EndOfRun()
+{
+  const G4long done = fNDone.load();
+  if (done == 0) return;
+
+  const G4double elapsed = std::chrono::duration<G4double>(Clock::now() - fStart).count();
+  std::ostringstream os;
+  os << "Processed " << done << " events in " << std::fixed << std::setprecision(1) << elapsed << " s ("
+     << std::setprecision(2) << ((elapsed > 0.) ? done / elapsed : 0.) << " events/s)";
+  LOG_INFO(os.str());
+}
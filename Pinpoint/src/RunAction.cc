@@ -1,6 +1,15 @@
 #include "RunAction.hh"
 
 #include "AnalysisManager.hh"
+#include "PerfMonitor.hh"
+#include "StackingPolicy.hh"
+#include "FastShower.hh"
+#include "PixelClusterizer.hh"
+#include "SteppingHooks.hh"
+#include "ProgressReporter.hh"
+#include "PrimaryGeneratorAction.hh"
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
 
 RunAction::RunAction() :
   G4UserRunAction() 
@@ -8,9 +17,22 @@ RunAction::RunAction() :
   //* This will ensure that the AnalysisManager singleton is created at the start of the run action
   //* We need to do this so that we can pass macro commands to it before the run starts
   AnalysisManager* analysis = AnalysisManager::GetInstance();
+  PerfMonitor::GetInstance();
+  StackingPolicy::GetInstance();
+  FastShower::GetInstance();
+  PixelClusterizer::GetInstance();
+  SteppingHooks::GetInstance();
 }
 
-void RunAction::BeginOfRunAction(const G4Run*) {
+void RunAction::BeginOfRunAction(const G4Run* run) {
+  // the master starts the run before any worker processes an event
+  if (!G4Threading::IsWorkerThread()) ProgressReporter::BeginOfRun(run->GetNumberOfEventToBeProcessed());
+
+  PerfMonitor::GetInstance()->BeginOfRun();
+  StackingPolicy::GetInstance()->BeginOfRun();
+  FastShower::GetInstance()->BeginOfRun();
+  PixelClusterizer::GetInstance()->BeginOfRun();
+  SteppingHooks::GetInstance()->BeginOfRun();
   AnalysisManager* analysis = AnalysisManager::GetInstance();
   analysis->BeginOfRun();
 }
@@ -18,6 +40,16 @@ void RunAction::BeginOfRunAction(const G4Run*) {
 void RunAction::EndOfRunAction(const G4Run* run) {
   AnalysisManager* analysis = AnalysisManager::GetInstance();
   analysis->EndOfRun();
+  PerfMonitor::GetInstance()->EndOfRun();
+  StackingPolicy::GetInstance()->EndOfRun();
+  FastShower::GetInstance()->EndOfRun();
+  SteppingHooks::GetInstance()->EndOfRun();
+  if (!G4Threading::IsWorkerThread()) ProgressReporter::EndOfRun();
+
+  // the master has no generator in multi-threaded mode
+  auto generatorAction = static_cast<const PrimaryGeneratorAction*>(
+    G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+  if (generatorAction) generatorAction->EndOfRun();
 
   // retrieve the number of events produced in the run
   G4int nofEvents = run->GetNumberOfEvent();
@@ -9,33 +9,15 @@
 #include "G4SystemOfUnits.hh"
 #include "G4SDManager.hh"
 #include "G4LorentzVector.hh"
-#include "TrackInformation.hh"
+#include "AnalysisManager.hh"
+#include "TrackTable.hh"
+#include "PerfMonitor.hh"
 #include "G4ios.hh"
-#include <map>
-#include <set>
-
-std::set<G4int> ScintillatorSD::sScintMuonDescendants;
-std::set<std::pair<G4int,G4int>> ScintillatorSD::sScintHitParticles;
-
-struct ScintLayerHitID {
-    G4int layerID;
-    G4int trackID;
-    G4int pdgCode;
-    G4int parentID;
-    G4bool fromPrimaryLepton;
-
-    bool operator<(const ScintLayerHitID& other) const {
-        if(layerID != other.layerID) return layerID < other.layerID;
-        return trackID < other.trackID;
-    }
-};
-
-// Energy and muon flags per layer hit
-static std::map<ScintLayerHitID, G4double> layerEnergyMap;
-static std::map<ScintLayerHitID, G4bool> layerFromMuonMap;
+#include <algorithm>
 
 ScintillatorSD::ScintillatorSD(const G4String& name, const G4String& hitsCollectionName)
-    : G4VSensitiveDetector(name)
+    : G4VSensitiveDetector(name), fPerfMonitor(PerfMonitor::GetInstance()),
+      fTrackTable(&AnalysisManager::GetInstance()->GetTrackTable())
 {
     collectionName.insert(hitsCollectionName);
 }
@@ -47,13 +29,13 @@ void ScintillatorSD::Initialize(G4HCofThisEvent* hce)
     hce->AddHitsCollection(hcID, fHitsCollection);
 
     fScintCurrentHitId = 0;
-    layerEnergyMap.clear();
-    layerFromMuonMap.clear();
-    sScintHitParticles.clear();
+    fSteps.clear();
 }
 
 G4bool ScintillatorSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 {
+    fPerfMonitor->CountProcessHits(PerfRow::kScintSD);
+
     G4Track* track = step->GetTrack();
     if(track->GetDefinition()->GetPDGCharge() == 0) return false;
 
@@ -71,17 +53,11 @@ G4bool ScintillatorSD::ProcessHits(G4Step* step, G4TouchableHistory*)
     //G4LorentzVector p4 = track->GetDynamicParticle()->Get4Momentum();
     G4ThreeVector truthPos = preStep->GetPosition();
 
-    TrackInformation* trackInfo = dynamic_cast<TrackInformation*>(track->GetUserInformation());
-    G4bool fromPrimaryLepton  = trackInfo ? trackInfo->IsTrackFromPrimaryLepton() : false;
-    G4bool fromPrimaryPizero  = trackInfo ? trackInfo->IsTrackFromPrimaryPizero() : false;
-    G4bool fromFSLPizero      = trackInfo ? trackInfo->IsTrackFromFSLPizero() : false;
-
-    ScintLayerHitID hitID {layerID, trackID, pdgCode, parentID, fromPrimaryLepton};
+    const TrackTable::Entry& origin = fTrackTable->Get(trackID);
+    G4bool fromPrimaryLepton  = (origin.flags & TrackTable::kFromPrimaryLepton) != 0;
+    G4bool fromMuon           = (origin.flags & TrackTable::kFromMuon) != 0;
 
-    layerEnergyMap[hitID] += edep;
-
-    if(IsFromMuon(trackID))
-        layerFromMuonMap[hitID] = true;
+    fSteps.push_back({layerID, trackID, pdgCode, parentID, fromPrimaryLepton, fromMuon, edep});
 
     fScintCurrentHitId++;
     return true;
@@ -89,24 +65,42 @@ G4bool ScintillatorSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
 void ScintillatorSD::EndOfEvent(G4HCofThisEvent*)
 {
-    for(const auto& [hitID, edep] : layerEnergyMap)
+    PerfMonitor::SDTimer timer(fPerfMonitor, PerfRow::kScintSD);
+
+    // Group by (layer, track); stable so the first step of each group
+    // provides the payload and energies are summed in step order
+    std::stable_sort(fSteps.begin(), fSteps.end(),
+        [](const ScintStep& a, const ScintStep& b) {
+            if(a.layerID != b.layerID) return a.layerID < b.layerID;
+            return a.trackID < b.trackID;
+        });
+
+    const std::size_t nSteps = fSteps.size();
+    std::size_t i = 0;
+    while(i < nSteps)
     {
+        const ScintStep& first = fSteps[i];
+        G4double edep = 0.;
+        G4bool fromMuon = false;
+        for(; i < nSteps && fSteps[i].layerID == first.layerID && fSteps[i].trackID == first.trackID; ++i) {
+            edep += fSteps[i].edep;
+            if(fSteps[i].fromMuon) fromMuon = true;
+        }
+
         if(edep <= 0.) continue;
 
         auto hit = new ScintHit();
-        hit->SetLayerID(hitID.layerID);
-        hit->SetTrackID(hitID.trackID);
-        hit->SetParentID(hitID.parentID);
-        hit->SetPDGCode(hitID.pdgCode);
+        hit->SetLayerID(first.layerID);
+        hit->SetTrackID(first.trackID);
+        hit->SetParentID(first.parentID);
+        hit->SetPDGCode(first.pdgCode);
         hit->SetEnergyDeposit(edep);
-        hit->SetFromMuon(layerFromMuonMap[hitID]);
-        hit->SetFromPrimaryLepton(hitID.fromPrimaryLepton);
+        hit->SetFromMuon(fromMuon);
+        hit->SetFromPrimaryLepton(first.fromPrimaryLepton);
 
         fHitsCollection->insert(hit);
     }
-
-    layerEnergyMap.clear();
-    layerFromMuonMap.clear();
+    fPerfMonitor->CountHits(PerfRow::kScintSD, fHitsCollection->entries());
 
     if(verboseLevel > 1) {
         std::size_t nofHits = fHitsCollection->entries();
@@ -116,18 +110,3 @@ void ScintillatorSD::EndOfEvent(G4HCofThisEvent*)
             (*fHitsCollection)[i]->Print();
     }
 }
-
-void ScintillatorSD::RecordMuonDescendant(G4int trackID, G4bool fromMuon)
-{
-    if(fromMuon) sScintMuonDescendants.insert(trackID);
-}
-
-G4bool ScintillatorSD::IsFromMuon(G4int trackID)
-{
-    return sScintMuonDescendants.find(trackID) != sScintMuonDescendants.end();
-}
-
-void ScintillatorSD::ClearMuonHistory()
-{
-    sScintMuonDescendants.clear();
-}
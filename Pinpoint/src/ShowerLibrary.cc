@@ -0,0 +1,254 @@
+#include "ShowerLibrary.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  const char kMagic[8] = {'P', 'P', 'S', 'H', 'L', 'I', 'B', '\0'};
+  const std::uint32_t kVersion = 1;
+  // a deposit belongs to a crossed layer within this distance of its faces
+  const G4double kLayerTolerance = 1 * um;
+}
+
+std::vector<ShowerLibrary::Recorded> ShowerLibrary::sMerged;
+G4Mutex ShowerLibrary::sMergeMutex = G4MUTEX_INITIALIZER;
+
+ShowerLibrary::~ShowerLibrary()
+{
+  Unload();
+}
+
+std::size_t ShowerLibrary::FindBin(G4double energy, G4double cosTheta, std::uint32_t nEnergyBins,
+                                   std::uint32_t nAngleBins, G4double minEnergy, G4double maxEnergy)
+{
+  G4int energyBin = 0;
+  if (minEnergy > 0. && maxEnergy > minEnergy && energy > 0.) {
+    energyBin = static_cast<G4int>(std::floor(std::log(energy / minEnergy) / std::log(maxEnergy / minEnergy) * nEnergyBins));
+    energyBin = std::min(std::max(energyBin, 0), static_cast<G4int>(nEnergyBins) - 1);
+  }
+  G4int angleBin = static_cast<G4int>(std::abs(cosTheta) * nAngleBins);
+  angleBin = std::min(std::max(angleBin, 0), static_cast<G4int>(nAngleBins) - 1);
+  return static_cast<std::size_t>(energyBin) * nAngleBins + angleBin;
+}
+
+std::size_t ShowerLibrary::BinTableSize(std::size_t nBins)
+{
+  return ((nBins + 1) * sizeof(std::uint32_t) + 7) & ~static_cast<std::size_t>(7);
+}
+
+//---------------------------------------------------------------------
+// replay
+//---------------------------------------------------------------------
+
+G4bool ShowerLibrary::Load(const G4String& fileName)
+{
+  Unload();
+
+  auto fail = [&](const G4String& reason) {
+    G4ExceptionDescription ed;
+    ed << "Cannot load the shower library " << fileName << ": " << reason;
+    G4Exception("ShowerLibrary::Load", "ShowerLib001", JustWarning, ed);
+    Unload();
+    return false;
+  };
+
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) return fail(std::strerror(errno));
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return fail(std::strerror(errno));
+  }
+  const std::size_t size = static_cast<std::size_t>(st.st_size);
+  if (size < sizeof(FileHeader)) {
+    close(fd);
+    return fail("file too short");
+  }
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) return fail(std::strerror(errno));
+  fMapping = mapping;
+  fMappingSize = size;
+
+  const char* base = static_cast<const char*>(mapping);
+  const auto* header = reinterpret_cast<const FileHeader*>(base);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) return fail("not a shower library");
+  if (header->version != kVersion) return fail("unsupported version " + std::to_string(header->version));
+  const std::size_t nBins = static_cast<std::size_t>(header->nEnergyBins) * header->nAngleBins;
+  if (nBins == 0) return fail("no bins");
+  const std::size_t patternsOffset = sizeof(FileHeader) + BinTableSize(nBins);
+  const std::size_t spotsOffset = patternsOffset + header->nPatterns * sizeof(PatternRecord);
+  if (size != spotsOffset + header->nSpots * sizeof(Spot)) return fail("size does not match the header");
+
+  fBinStart = reinterpret_cast<const std::uint32_t*>(base + sizeof(FileHeader));
+  fPatterns = reinterpret_cast<const PatternRecord*>(base + patternsOffset);
+  fSpots = reinterpret_cast<const Spot*>(base + spotsOffset);
+  if (fBinStart[nBins] != header->nPatterns) return fail("corrupted bin table");
+  fHeader = header;
+
+  G4cout << "Shower library " << fileName << ": " << header->nPatterns << " patterns, " << header->nSpots
+         << " deposits, " << header->nEnergyBins << " x " << header->nAngleBins << " bins in "
+         << header->minEnergy << " - " << header->maxEnergy << " MeV" << G4endl;
+  return true;
+}
+
+void ShowerLibrary::Unload()
+{
+  if (fMapping) munmap(fMapping, fMappingSize);
+  fMapping = nullptr;
+  fMappingSize = 0;
+  fHeader = nullptr;
+  fBinStart = nullptr;
+  fPatterns = nullptr;
+  fSpots = nullptr;
+}
+
+G4bool ShowerLibrary::Sample(G4double energy, G4double cosTheta, const PatternRecord*& pattern,
+                             const Spot*& spots) const
+{
+  if (!fHeader) return false;
+  const std::size_t bin = FindBin(energy / MeV, cosTheta, fHeader->nEnergyBins, fHeader->nAngleBins,
+                                  fHeader->minEnergy, fHeader->maxEnergy);
+  const std::uint32_t first = fBinStart[bin];
+  const std::uint32_t count = fBinStart[bin + 1] - first;
+  if (count == 0) return false;
+
+  const std::uint32_t index = first + std::min(static_cast<std::uint32_t>(G4UniformRand() * count), count - 1);
+  pattern = &fPatterns[index];
+  spots = fSpots + pattern->firstSpot;
+  return true;
+}
+
+//---------------------------------------------------------------------
+// recording
+//---------------------------------------------------------------------
+
+void ShowerLibrary::SetEnergyRange(G4double minEnergy, G4double maxEnergy)
+{
+  fMinEnergy = minEnergy;
+  fMaxEnergy = maxEnergy;
+}
+
+void ShowerLibrary::BeginShower(G4int trackID, G4double energy, const G4ThreeVector& axis,
+                                std::vector<Crossing> crossings)
+{
+  Pending& shower = fPending[trackID];
+  shower.energy = energy;
+  shower.cosTheta = std::abs(axis.cosTheta());
+  shower.axis = axis;
+  shower.crossings = std::move(crossings);
+  shower.spots.clear();
+}
+
+void ShowerLibrary::AddDeposit(G4int trackID, const G4ThreeVector& position, G4double edep)
+{
+  auto it = fPending.find(trackID);
+  if (it == fPending.end()) return;
+  Pending& shower = it->second;
+  if (shower.axis.z() == 0.) return;
+
+  // the layer of the deposit, among those crossed by the axis (deposits in
+  // other layers cannot be placed on replay and are dropped)
+  const G4double z = position.z();
+  for (std::size_t layer = 0; layer < shower.crossings.size(); ++layer) {
+    const Crossing& crossing = shower.crossings[layer];
+    if (z < crossing.zMin - kLayerTolerance || z > crossing.zMax + kLayerTolerance) continue;
+
+    // offset from the axis at the depth of the deposit, in the frame of the axis azimuth
+    const G4ThreeVector onAxis = crossing.centre + shower.axis * ((z - crossing.centre.z()) / shower.axis.z());
+    const G4double dx = position.x() - onAxis.x();
+    const G4double dy = position.y() - onAxis.y();
+    const G4double phi = shower.axis.phi();
+    const G4double c = std::cos(phi), s = std::sin(phi);
+    shower.spots.push_back({static_cast<std::int32_t>(layer), static_cast<float>((c * dx + s * dy) / mm),
+                            static_cast<float>((c * dy - s * dx) / mm), static_cast<float>(edep / MeV)});
+    return;
+  }
+}
+
+void ShowerLibrary::EndOfEvent()
+{
+  // showers without any silicon deposit are kept, they carry the probability
+  // of an empty pattern
+  for (auto& [trackID, shower] : fPending) {
+    fRecorded.push_back({FindBin(shower.energy / MeV, shower.cosTheta, fNEnergyBins, fNAngleBins, fMinEnergy / MeV,
+                                 fMaxEnergy / MeV),
+                         shower.energy, std::move(shower.spots)});
+  }
+  fNRecorded += fPending.size();
+  fPending.clear();
+}
+
+void ShowerLibrary::EndOfRun(const G4String& fileName)
+{
+  G4AutoLock lock(&sMergeMutex);
+  std::move(fRecorded.begin(), fRecorded.end(), std::back_inserter(sMerged));
+  fRecorded.clear();
+  if (G4Threading::IsWorkerThread() || fileName.empty() || sMerged.empty()) return;
+
+  fNRecorded = sMerged.size();
+  Write(fileName, sMerged, fNEnergyBins, fNAngleBins, fMinEnergy / MeV, fMaxEnergy / MeV);
+  sMerged.clear();
+}
+
+G4bool ShowerLibrary::Write(const G4String& fileName, std::vector<Recorded>& showers, std::uint32_t nEnergyBins,
+                            std::uint32_t nAngleBins, G4double minEnergy, G4double maxEnergy)
+{
+  std::stable_sort(showers.begin(), showers.end(),
+                   [](const Recorded& a, const Recorded& b) { return a.bin < b.bin; });
+
+  const std::size_t nBins = static_cast<std::size_t>(nEnergyBins) * nAngleBins;
+  std::vector<std::uint32_t> binStart(BinTableSize(nBins) / sizeof(std::uint32_t), 0);
+  std::vector<PatternRecord> patterns;
+  patterns.reserve(showers.size());
+  std::uint64_t nSpots = 0;
+  for (const Recorded& shower : showers) {
+    ++binStart[shower.bin + 1];
+    patterns.push_back({nSpots, static_cast<std::uint32_t>(shower.spots.size()), static_cast<float>(shower.energy / MeV)});
+    nSpots += shower.spots.size();
+  }
+  for (std::size_t bin = 0; bin < nBins; ++bin) binStart[bin + 1] += binStart[bin];
+
+  FileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.nEnergyBins = nEnergyBins;
+  header.nAngleBins = nAngleBins;
+  header.nPatterns = static_cast<std::uint32_t>(patterns.size());
+  header.nSpots = nSpots;
+  header.minEnergy = minEnergy;
+  header.maxEnergy = maxEnergy;
+
+  std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(binStart.data()), binStart.size() * sizeof(std::uint32_t));
+  out.write(reinterpret_cast<const char*>(patterns.data()), patterns.size() * sizeof(PatternRecord));
+  for (const Recorded& shower : showers) {
+    out.write(reinterpret_cast<const char*>(shower.spots.data()), shower.spots.size() * sizeof(Spot));
+  }
+  if (!out) {
+    G4ExceptionDescription ed;
+    ed << "Cannot write the shower library " << fileName;
+    G4Exception("ShowerLibrary::Write", "ShowerLib002", JustWarning, ed);
+    return false;
+  }
+
+  G4cout << "Shower library " << fileName << ": wrote " << patterns.size() << " patterns, " << nSpots
+         << " deposits" << G4endl;
+  return true;
+}
@@ -4,26 +4,28 @@
 #include "RunAction.hh"
 #include "EventAction.hh"
 #include "AnalysisManager.hh"
+#include "StackingPolicy.hh"
 #include "G4TrackingManager.hh"
+#include "G4StackManager.hh"
 
 StackingAction::StackingAction(RunAction* aRunAction, EventAction* aEventAction) :
-  G4UserStackingAction(), fRunAction(aRunAction), fEventAction(aEventAction)
+  G4UserStackingAction(), fRunAction(aRunAction), fEventAction(aEventAction),
+  fPolicy(StackingPolicy::GetInstance()),
+  fTrackTable(&AnalysisManager::GetInstance()->GetTrackTable())
 {;}
 
 G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack (const G4Track* aTrack)
 {
-  // for each track, build track ID to primary ancestor
+  // for each track, store the primary ancestor and the origin flags
   // primaries have themselves as ancestor
-  // go up the tree until original primary for everything else
-  G4int trackID = aTrack->GetTrackID();
+  // everything else takes the ancestor of its parent
   G4int parentID = aTrack->GetParentID();
-  G4int ancestorID = -1;
+  const TrackTable::Entry& entry = fTrackTable->Register(aTrack);
 
   // Register primary tracks
   if (parentID==0) 
   {
     fEventAction->AddPrimaryTrack();
-    ancestorID = trackID; // primary is its own ancestor
   }
 
   // Register only secondaries, i.e. tracks having ParentID > 0
@@ -35,14 +37,26 @@ G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack (const G4Track* aTra
       fEventAction->AddSecondaryTrackNotGamma();
     }
 
-    // if you are a secondary, ancestor is your parent's ancestor
-    ancestorID = AnalysisManager::GetInstance()->GetTrackPrimaryAncestor(parentID);
+    // decay products of primary pi0s and leptons count as primary particles
+    if (entry.flags & (TrackTable::kFromPrimaryLepton | TrackTable::kFromPrimaryPizero | TrackTable::kFromFSLPizero))
+    {
+      AnalysisManager::GetInstance()->AddOnePrimaryTrack();
+    }
   }
 
-  // add track with its ancestor!!!
-  AnalysisManager::GetInstance()->SetTrackPrimaryAncestor(trackID,ancestorID);
+  // kill or postpone according to the /stack/ rules, by default every
+  // track is urgent as in the base class
+  return fPolicy->Classify(aTrack);
+}
 
-  // Do not affect track classification. Just return what would have
-  // been returned by the base class
-  return G4UserStackingAction::ClassifyNewTrack(aTrack);
+void StackingAction::NewStage()
+{
+  // Geant4 moves the waiting stack into the empty urgent stack before calling
+  // this, so the urgent stack holds exactly the postponed tracks
+  if (fPolicy->DropWaitingStack(stackManager->GetNUrgentTrack())) stackManager->clear();
+}
+
+void StackingAction::PrepareNewEvent()
+{
+  fPolicy->BeginOfEvent();
 }
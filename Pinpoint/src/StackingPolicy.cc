@@ -0,0 +1,218 @@
+#include "StackingPolicy.hh"
+#include "StackingPolicyMessenger.hh"
+#include "PerfMonitor.hh"
+
+#include "G4Track.hh"
+#include "G4Region.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+G4ThreadLocal StackingPolicy* StackingPolicy::fInstance = nullptr;
+
+namespace {
+  const char* const kRuleNames[StackingPolicy::kNRules] = {"species threshold", "region threshold",
+                                                           "neutron time cut", "waiting drop"};
+}
+
+StackingPolicy* StackingPolicy::GetInstance()
+{
+  if (!fInstance) fInstance = new StackingPolicy();
+  return fInstance;
+}
+
+StackingPolicy::StackingPolicy()
+{
+  fMessenger = new StackingPolicyMessenger(this);
+}
+
+StackingPolicy::~StackingPolicy()
+{
+  delete fMessenger;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void StackingPolicy::SetRegionThreshold(const G4String& region, G4int pdg, G4double ekin)
+{
+  fRegionRules.push_back({region, pdg, ekin});
+  fRegionCache.clear();
+}
+
+void StackingPolicy::ClearRules()
+{
+  fSpeciesThresholds.clear();
+  fRegionRules.clear();
+  fRegionCache.clear();
+  fNeutronTimeCut = -1.;
+  fPostpone = false;
+  fDropWaiting = false;
+}
+
+G4bool StackingPolicy::IsActive() const
+{
+  return !fSpeciesThresholds.empty() || !fRegionRules.empty() || fNeutronTimeCut >= 0. || fPostpone;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+StackingPolicy::Rule StackingPolicy::Match(const G4Track* track)
+{
+  const G4int pdg = track->GetParticleDefinition()->GetPDGEncoding();
+  const G4double ekin = track->GetKineticEnergy();
+
+  if (!fSpeciesThresholds.empty()) {
+    auto it = fSpeciesThresholds.find(pdg);
+    if (it != fSpeciesThresholds.end() && ekin < it->second) return kSpeciesThreshold;
+  }
+
+  if (fNeutronTimeCut >= 0. && pdg == 2112 && track->GetGlobalTime() > fNeutronTimeCut) return kNeutronTime;
+
+  // secondaries carry the touchable of the step that created them
+  const G4VPhysicalVolume* volume = track->GetVolume();
+  if (!fRegionRules.empty() && volume) {
+    const G4Region* region = volume->GetLogicalVolume()->GetRegion();
+    auto it = fRegionCache.find(region);
+    if (it == fRegionCache.end()) {
+      std::vector<const RegionRule*> rules;
+      for (const auto& rule : fRegionRules) {
+        if (region && rule.region == region->GetName()) rules.push_back(&rule);
+      }
+      it = fRegionCache.emplace(region, rules).first;
+    }
+    for (const RegionRule* rule : it->second) {
+      if ((rule->pdg == 0 || rule->pdg == pdg) && ekin < rule->ekin) return kRegionThreshold;
+    }
+  }
+
+  return kNRules;
+}
+
+G4ClassificationOfNewTrack StackingPolicy::Classify(const G4Track* track)
+{
+  if (!IsActive() || track->GetParentID() == 0) return fUrgent;
+
+  // descendants of a tagged track would not exist without the rule
+  G4int rule = kNRules;
+  if (fValidate) {
+    auto parent = fTrackRule.find(track->GetParentID());
+    if (parent != fTrackRule.end()) rule = parent->second;
+  }
+  if (rule == kNRules) {
+    rule = Match(track);
+    if (rule != kNRules) {
+      ++fNTracks[rule];
+      fEnergy[rule] += track->GetKineticEnergy();
+      if (!fValidate) return fKill;
+    }
+  }
+
+  G4ClassificationOfNewTrack classification = fUrgent;
+  if (fPostpone && track->GetVolume()) {
+    const G4LogicalVolume* volume = track->GetVolume()->GetLogicalVolume();
+    auto it = fTungstenCache.find(volume);
+    if (it == fTungstenCache.end()) it = fTungstenCache.emplace(volume, volume->GetName() == "Tungsten").first;
+
+    // nearly parallel to the layers: far from reaching the next silicon plane
+    if (it->second && std::abs(track->GetMomentumDirection().z()) < fPostponeMinCosZ) {
+      classification = fWaiting;
+      ++fNPostponed;
+      if (fDropWaiting && rule == kNRules) {
+        rule = kWaitingDrop;
+        ++fNTracks[rule];
+        fEnergy[rule] += track->GetKineticEnergy();
+      }
+    }
+  }
+
+  if (fValidate && rule != kNRules) fTrackRule[track->GetTrackID()] = rule;
+  return classification;
+}
+
+G4bool StackingPolicy::DropWaitingStack(G4int nPromoted)
+{
+  // the drop is only counted at classification, validation keeps the tracks
+  return fDropWaiting && !fValidate && nPromoted > 0;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void StackingPolicy::BeginOfRun()
+{
+  fNEvents = 0;
+  fNPostponed = 0;
+  std::fill(std::begin(fNTracks), std::end(fNTracks), 0);
+  std::fill(std::begin(fEnergy), std::end(fEnergy), 0.);
+  std::fill(std::begin(fCPUTime), std::end(fCPUTime), 0.);
+  std::fill(std::begin(fPixelSteps), std::end(fPixelSteps), 0);
+  fTotalPixelSteps = 0;
+  fTotalCPUTime = 0.;
+  fRegionCache.clear();
+  fTungstenCache.clear();
+}
+
+void StackingPolicy::BeginOfEvent()
+{
+  ++fNEvents;
+  fTrackRule.clear();
+}
+
+void StackingPolicy::BeginOfTrack(const G4Track* track)
+{
+  if (!fValidate) return;
+
+  auto it = fTrackRule.find(track->GetTrackID());
+  fCurrentRule = (it != fTrackRule.end()) ? it->second : kNRules;
+  fTrackCPUStart = PerfMonitor::ThreadCPUTime();
+}
+
+void StackingPolicy::EndOfTrack(const G4Track*)
+{
+  if (!fValidate) return;
+
+  const G4double time = PerfMonitor::ThreadCPUTime() - fTrackCPUStart;
+  fTotalCPUTime += time;
+  if (fCurrentRule != kNRules) fCPUTime[fCurrentRule] += time;
+}
+
+void StackingPolicy::CountPixelStep(G4int trackID)
+{
+  ++fTotalPixelSteps;
+  if (!fValidate || fTrackRule.empty()) return;
+
+  auto it = fTrackRule.find(trackID);
+  if (it != fTrackRule.end()) ++fPixelSteps[it->second];
+}
+
+void StackingPolicy::EndOfRun()
+{
+  if (!IsActive() || fNEvents == 0) return;
+
+  G4cout << "---- Stacking policy summary (" << fNEvents << " events"
+         << (fValidate ? ", validation: no track was killed" : "") << ") ----" << G4endl;
+  G4cout << " pixel SD steps : " << fTotalPixelSteps << G4endl;
+  if (fPostpone) G4cout << " postponed      : " << fNPostponed << " tracks" << G4endl;
+  for (int i = 0; i < kNRules; ++i) {
+    if (fNTracks[i] == 0) continue;
+    G4cout << " " << std::setw(17) << std::left << kRuleNames[i] << std::right << ": "
+           << fNTracks[i] << " tracks, " << fEnergy[i] / MeV << " MeV";
+    if (fValidate) {
+      // what enforcing the rule would save, and the charged steps with a
+      // deposit in the pixels it would remove
+      G4cout << ", CPU " << fCPUTime[i] << " s";
+      if (fTotalCPUTime > 0.) G4cout << " (" << 100. * fCPUTime[i] / fTotalCPUTime << "% of tracking)";
+      G4cout << ", pixel SD steps " << -fPixelSteps[i];
+      if (fTotalPixelSteps > 0) G4cout << " (" << -100. * fPixelSteps[i] / fTotalPixelSteps << "%)";
+    }
+    G4cout << G4endl;
+  }
+}
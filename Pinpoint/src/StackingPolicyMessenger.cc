@@ -0,0 +1,135 @@
+#include "StackingPolicyMessenger.hh"
+#include "StackingPolicy.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+
+#include <sstream>
+
+StackingPolicyMessenger::StackingPolicyMessenger(StackingPolicy* policy)
+  : fPolicy(policy)
+{
+  fStackDir = new G4UIdirectory("/stack/");
+  fStackDir->SetGuidance("track killing and prioritisation in the stacking action");
+
+  fKillBelowCmd = new G4UIcommand("/stack/killBelow", this);
+  fKillBelowCmd->SetGuidance("kill secondaries of a species created below a kinetic energy");
+  G4UIparameter* particleParam = new G4UIparameter("particle", 's', false);
+  fKillBelowCmd->SetParameter(particleParam);
+  G4UIparameter* energyParam = new G4UIparameter("energy", 'd', false);
+  energyParam->SetParameterRange("energy>=0.");
+  fKillBelowCmd->SetParameter(energyParam);
+  G4UIparameter* unitParam = new G4UIparameter("unit", 's', true);
+  unitParam->SetDefaultUnit("MeV");
+  fKillBelowCmd->SetParameter(unitParam);
+  fKillBelowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRegionKillBelowCmd = new G4UIcommand("/stack/regionKillBelow", this);
+  fRegionKillBelowCmd->SetGuidance("kill secondaries of a species ('all' for any) created in a region below a kinetic energy");
+  G4UIparameter* regionParam = new G4UIparameter("region", 's', false);
+  fRegionKillBelowCmd->SetParameter(regionParam);
+  G4UIparameter* regionParticleParam = new G4UIparameter("particle", 's', false);
+  fRegionKillBelowCmd->SetParameter(regionParticleParam);
+  G4UIparameter* regionEnergyParam = new G4UIparameter("energy", 'd', false);
+  regionEnergyParam->SetParameterRange("energy>=0.");
+  fRegionKillBelowCmd->SetParameter(regionEnergyParam);
+  G4UIparameter* regionUnitParam = new G4UIparameter("unit", 's', true);
+  regionUnitParam->SetDefaultUnit("MeV");
+  fRegionKillBelowCmd->SetParameter(regionUnitParam);
+  fRegionKillBelowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fNeutronTimeCutCmd = new G4UIcmdWithADoubleAndUnit("/stack/neutronTimeCut", this);
+  fNeutronTimeCutCmd->SetGuidance("kill neutrons created later than this global time, a negative value disables the cut");
+  fNeutronTimeCutCmd->SetParameterName("time", false);
+  fNeutronTimeCutCmd->SetUnitCategory("Time");
+  fNeutronTimeCutCmd->SetDefaultUnit("ns");
+  fNeutronTimeCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPostponeCmd = new G4UIcmdWithABool("/stack/postponeAwayFromSilicon", this);
+  fPostponeCmd->SetGuidance("postpone to the waiting stack the secondaries created in tungsten travelling nearly");
+  fPostponeCmd->SetGuidance("parallel to the layers (see /stack/postponeMinCosZ)");
+  fPostponeCmd->SetParameterName("postpone", true);
+  fPostponeCmd->SetDefaultValue(true);
+  fPostponeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPostponeMinCosZCmd = new G4UIcmdWithADouble("/stack/postponeMinCosZ", this);
+  fPostponeMinCosZCmd->SetGuidance("secondaries with |cos(theta_z)| below this value are postponed");
+  fPostponeMinCosZCmd->SetParameterName("cosZ", false);
+  fPostponeMinCosZCmd->SetRange("cosZ>=0. && cosZ<=1.");
+  fPostponeMinCosZCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fDropWaitingCmd = new G4UIcmdWithABool("/stack/dropWaiting", this);
+  fDropWaitingCmd->SetGuidance("discard the postponed tracks once the urgent stack is empty");
+  fDropWaitingCmd->SetParameterName("drop", true);
+  fDropWaitingCmd->SetDefaultValue(true);
+  fDropWaitingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fValidateCmd = new G4UIcmdWithABool("/stack/validate", this);
+  fValidateCmd->SetGuidance("track everything, but report per rule the CPU time and pixel deposits of the");
+  fValidateCmd->SetGuidance("tracks (and descendants) the rule would have killed");
+  fValidateCmd->SetParameterName("validate", true);
+  fValidateCmd->SetDefaultValue(true);
+  fValidateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/stack/clear", this);
+  fClearCmd->SetGuidance("remove all stacking rules");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+StackingPolicyMessenger::~StackingPolicyMessenger()
+{
+  delete fKillBelowCmd;
+  delete fRegionKillBelowCmd;
+  delete fNeutronTimeCutCmd;
+  delete fPostponeCmd;
+  delete fPostponeMinCosZCmd;
+  delete fDropWaitingCmd;
+  delete fValidateCmd;
+  delete fClearCmd;
+  delete fStackDir;
+}
+
+G4int StackingPolicyMessenger::ParticleCode(const G4String& name) const
+{
+  if (name == "all") return 0;
+  const G4ParticleDefinition* particle = G4ParticleTable::GetParticleTable()->FindParticle(name);
+  if (!particle) {
+    G4String err = "Unknown particle " + name + ", stacking rule ignored";
+    G4Exception("StackingPolicyMessenger", "UnknownParticle", JustWarning, err.c_str());
+    return -1;
+  }
+  return particle->GetPDGEncoding();
+}
+
+void StackingPolicyMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fKillBelowCmd) {
+    G4String particle, unit = "MeV";
+    G4double energy = 0.;
+    std::istringstream is(newValues);
+    is >> particle >> energy >> unit;
+    const G4int pdg = ParticleCode(particle);
+    if (pdg != -1 && pdg != 0) fPolicy->SetSpeciesThreshold(pdg, energy * G4UIcommand::ValueOf(unit));
+  }
+  if (command == fRegionKillBelowCmd) {
+    G4String region, particle, unit = "MeV";
+    G4double energy = 0.;
+    std::istringstream is(newValues);
+    is >> region >> particle >> energy >> unit;
+    const G4int pdg = ParticleCode(particle);
+    if (pdg != -1) fPolicy->SetRegionThreshold(region, pdg, energy * G4UIcommand::ValueOf(unit));
+  }
+  if (command == fNeutronTimeCutCmd) fPolicy->SetNeutronTimeCut(fNeutronTimeCutCmd->GetNewDoubleValue(newValues));
+  if (command == fPostponeCmd) fPolicy->SetPostponeAwayFromSilicon(fPostponeCmd->GetNewBoolValue(newValues));
+  if (command == fPostponeMinCosZCmd) fPolicy->SetPostponeMinCosZ(fPostponeMinCosZCmd->GetNewDoubleValue(newValues));
+  if (command == fDropWaitingCmd) fPolicy->SetDropWaiting(fDropWaitingCmd->GetNewBoolValue(newValues));
+  if (command == fValidateCmd) fPolicy->SetValidate(fValidateCmd->GetNewBoolValue(newValues));
+  if (command == fClearCmd) fPolicy->ClearRules();
+}
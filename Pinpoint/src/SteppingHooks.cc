@@ -0,0 +1,288 @@
+#include "SteppingHooks.hh"
+#include "SteppingHooksMessenger.hh"
+#include "SteppingAction.hh"
+#include "PerfMonitor.hh"
+#include "Logging.hh"
+
+#include "G4AutoLock.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4RunManager.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <set>
+
+G4ThreadLocal SteppingHooks* SteppingHooks::fInstance = nullptr;
+
+namespace {
+  // run totals of all threads, printed by the master
+  G4Mutex sMergeMutex = G4MUTEX_INITIALIZER;
+}
+
+//---------------------------------------------------------------------
+// hooks
+//---------------------------------------------------------------------
+
+// PerfMonitor accounting, active with /perf/enable
+class PerfHook : public SteppingHook
+{
+  public:
+    PerfHook() : SteppingHook("perf"), fMonitor(PerfMonitor::GetInstance()) {}
+    G4bool IsActive() const override { return fMonitor->IsEnabled(); }
+    void Step(const G4Step* step) override { fMonitor->RecordStep(step); }
+
+  private:
+    PerfMonitor* fMonitor;
+};
+
+// every step of every live track
+class LiveDebugHook : public SteppingHook
+{
+  public:
+    LiveDebugHook() : SteppingHook("liveDebug") {}
+    void SetEnabled(G4bool val) { fEnabled = val; }
+    G4bool IsActive() const override { return fEnabled; }
+
+    void Step(const G4Step* step) override
+    {
+      G4Track* track = step->GetTrack();
+      if (track->GetTrackStatus() != fAlive && track->GetTrackStatus() != fStopButAlive) return;
+
+      const G4StepPoint* pre = step->GetPreStepPoint();
+      const G4StepPoint* post = step->GetPostStepPoint();
+      const G4ThreeVector& prePos = pre->GetPosition();
+      const G4ThreeVector& postPos = post->GetPosition();
+      const G4ThreeVector& preMom = pre->GetMomentum();
+      const G4ThreeVector& postMom = post->GetMomentum();
+
+      G4cout << "Track " << track->GetTrackID() << " - PDG " << track->GetParticleDefinition()->GetPDGEncoding()
+             << " " << track->GetParticleDefinition()->GetParticleName() << G4endl;
+      G4cout << "stepping... " << track->GetCurrentStepNumber() << " edep" << step->GetTotalEnergyDeposit() << G4endl;
+      G4cout << "(" << prePos.x() << "," << prePos.y() << "," << prePos.z() << ") in "
+             << pre->GetPhysicalVolume()->GetLogicalVolume()->GetName();
+      G4cout << " ---> (" << postPos.x() << "," << postPos.y() << "," << postPos.z() << ") in "
+             << (post->GetPhysicalVolume() ? post->GetPhysicalVolume()->GetLogicalVolume()->GetName() : "OutOfWorld")
+             << G4endl;
+      G4cout << "momentum: (" << preMom.x() << "," << preMom.y() << "," << preMom.z() << ") ---> ("
+             << postMom.x() << "," << postMom.y() << "," << postMom.z() << ")" << G4endl;
+    }
+
+  private:
+    G4bool fEnabled = false;
+};
+
+// kill the tracks entering the given logical volumes
+class VolumeKillHook : public SteppingHook
+{
+  public:
+    VolumeKillHook() : SteppingHook("volumeKill") {}
+    void AddVolume(const G4String& name) { fNames.insert(name); }
+    void Clear() { fNames.clear(); }
+    const std::set<G4String>& GetNames() const { return fNames; }
+    G4bool IsActive() const override { return !fNames.empty(); }
+
+    void BeginOfRun() override
+    {
+      // the names are resolved once, the step compares pointers
+      fVolumes.clear();
+      for (const G4String& name : fNames) {
+        std::size_t found = 0;
+        for (const G4LogicalVolume* volume : *G4LogicalVolumeStore::GetInstance()) {
+          if (volume->GetName() != name) continue;
+          fVolumes.push_back(volume);
+          ++found;
+        }
+        if (found == 0) {
+          G4ExceptionDescription ed;
+          ed << "No logical volume named " << name << ", /step/killInVolume ignored for it";
+          G4Exception("VolumeKillHook::BeginOfRun", "Stepping001", JustWarning, ed);
+        }
+      }
+      fNKilled = 0;
+    }
+
+    void Step(const G4Step* step) override
+    {
+      const G4VPhysicalVolume* next = step->GetPostStepPoint()->GetPhysicalVolume();
+      if (!next) return;
+      const G4LogicalVolume* volume = next->GetLogicalVolume();
+      if (std::find(fVolumes.begin(), fVolumes.end(), volume) == fVolumes.end()) return;
+      step->GetTrack()->SetTrackStatus(fStopAndKill);
+      ++fNKilled;
+    }
+
+    void EndOfRun() override
+    {
+      static G4long totalKilled = 0;
+      G4AutoLock lock(&sMergeMutex);
+      totalKilled += fNKilled;
+      if (G4Threading::IsWorkerThread()) return;
+      LOG_INFO("Stepping hook volumeKill: " << totalKilled << " tracks killed");
+      totalKilled = 0;
+    }
+
+  private:
+    std::set<G4String> fNames;
+    std::vector<const G4LogicalVolume*> fVolumes;
+    G4long fNKilled = 0;
+};
+
+// step length distribution, log binned, for charged and neutral particles
+class StepLengthHook : public SteppingHook
+{
+  public:
+    // 4 bins per decade from 1 nm to 1 m, plus underflow and overflow
+    static constexpr G4int kBinsPerDecade = 4;
+    static constexpr G4double kMinLog = -6.;  // log10(length / mm)
+    static constexpr G4int kNBins = 9 * kBinsPerDecade + 2;
+
+    StepLengthHook() : SteppingHook("stepLength") {}
+    void SetEnabled(G4bool val) { fEnabled = val; }
+    G4bool IsActive() const override { return fEnabled; }
+
+    void BeginOfRun() override
+    {
+      for (auto& histogram : fCounts) std::fill(std::begin(histogram), std::end(histogram), 0);
+    }
+
+    void Step(const G4Step* step) override
+    {
+      const G4double length = step->GetStepLength();
+      G4int bin = 0;
+      if (length > 0.) {
+        bin = static_cast<G4int>(std::floor((std::log10(length / mm) - kMinLog) * kBinsPerDecade)) + 1;
+        bin = std::min(std::max(bin, 0), kNBins - 1);
+      }
+      ++fCounts[step->GetTrack()->GetParticleDefinition()->GetPDGCharge() != 0. ? 0 : 1][bin];
+    }
+
+    void EndOfRun() override
+    {
+      static std::uint64_t total[2][kNBins] = {};
+      G4AutoLock lock(&sMergeMutex);
+      for (G4int type = 0; type < 2; ++type)
+        for (G4int bin = 0; bin < kNBins; ++bin) total[type][bin] += fCounts[type][bin];
+      if (G4Threading::IsWorkerThread()) return;
+
+      std::uint64_t sum[2] = {0, 0};
+      for (G4int type = 0; type < 2; ++type)
+        for (G4int bin = 0; bin < kNBins; ++bin) sum[type] += total[type][bin];
+
+      const std::streamsize precision = G4cout.precision();
+      G4cout << "---- Step length distribution ----" << G4endl
+             << "   from (mm)        charged   (%)        neutral   (%)" << G4endl;
+      for (G4int bin = 0; bin < kNBins; ++bin) {
+        if (total[0][bin] == 0 && total[1][bin] == 0) continue;
+        G4cout << std::setw(11);
+        if (bin == 0) G4cout << "0";
+        else G4cout << std::setprecision(3) << std::pow(10., kMinLog + static_cast<G4double>(bin - 1) / kBinsPerDecade);
+        for (G4int type = 0; type < 2; ++type) {
+          G4cout << std::setw(15) << total[type][bin] << std::setw(6) << std::fixed << std::setprecision(1)
+                 << (sum[type] ? 100. * total[type][bin] / sum[type] : 0.) << std::defaultfloat;
+        }
+        G4cout << G4endl;
+      }
+      G4cout.precision(precision);
+      for (auto& histogram : total) std::fill(std::begin(histogram), std::end(histogram), 0);
+    }
+
+  private:
+    G4bool fEnabled = false;
+    std::uint64_t fCounts[2][kNBins] = {};
+};
+
+//---------------------------------------------------------------------
+// registry
+//---------------------------------------------------------------------
+
+SteppingHooks* SteppingHooks::GetInstance()
+{
+  if (!fInstance) fInstance = new SteppingHooks();
+  return fInstance;
+}
+
+SteppingHooks::SteppingHooks()
+  : fLiveDebug(new LiveDebugHook()), fVolumeKill(new VolumeKillHook()), fStepLength(new StepLengthHook())
+{
+  Register(new PerfHook());
+  Register(fLiveDebug);
+  Register(fVolumeKill);
+  Register(fStepLength);
+  fMessenger = new SteppingHooksMessenger(this);
+}
+
+SteppingHooks::~SteppingHooks()
+{
+  delete fMessenger;
+  for (SteppingHook* hook : fHooks) delete hook;
+}
+
+void SteppingHooks::Register(SteppingHook* hook)
+{
+  fHooks.push_back(hook);
+}
+
+void SteppingHooks::SetLiveDebug(G4bool val) { fLiveDebug->SetEnabled(val); }
+void SteppingHooks::AddKillVolume(const G4String& name) { fVolumeKill->AddVolume(name); }
+void SteppingHooks::ClearKillVolumes() { fVolumeKill->Clear(); }
+void SteppingHooks::SetStepLengthHistogram(G4bool val) { fStepLength->SetEnabled(val); }
+
+void SteppingHooks::Print() const
+{
+  G4cout << "Stepping hooks:" << G4endl;
+  for (const SteppingHook* hook : fHooks) {
+    G4cout << "  " << std::setw(12) << std::left << hook->GetName() << std::right
+           << (hook->IsActive() ? "active" : "off");
+    if (hook == fVolumeKill && hook->IsActive()) {
+      G4cout << " (";
+      for (const G4String& name : fVolumeKill->GetNames()) G4cout << " " << name;
+      G4cout << " )";
+    }
+    G4cout << G4endl;
+  }
+  if (fKeepAction) G4cout << "  the action is kept installed without active hooks (/step/keepAction)" << G4endl;
+}
+
+void SteppingHooks::BeginOfRun()
+{
+  fActive.clear();
+  for (SteppingHook* hook : fHooks) {
+    if (!hook->IsActive()) continue;
+    hook->BeginOfRun();
+    fActive.push_back(hook);
+  }
+
+  // without any hook the stepping manager gets no user action at all
+  if (fSteppingAction && fActive.empty() && !fKeepAction) {
+    G4RunManager::GetRunManager()->SetUserAction(static_cast<G4UserSteppingAction*>(nullptr));
+    fInstalled = false;
+  }
+
+  if (!G4Threading::IsWorkerThread()) {
+    G4String names;
+    for (const SteppingHook* hook : fActive) names += " " + hook->GetName();
+    if (!fActive.empty()) LOG_INFO("Stepping action: hooks" << names);
+    else if (fKeepAction) LOG_INFO("Stepping action: installed, no hook active (/step/keepAction)");
+    else LOG_INFO("Stepping action: off, no hook active");
+  }
+}
+
+void SteppingHooks::EndOfRun()
+{
+  for (SteppingHook* hook : fActive) hook->EndOfRun();
+
+  // the run manager owns the action between runs
+  if (fSteppingAction && !fInstalled) {
+    G4RunManager::GetRunManager()->SetUserAction(fSteppingAction);
+    fInstalled = true;
+  }
+}
@@ -0,0 +1,68 @@
+#include "SteppingHooksMessenger.hh"
+#include "SteppingHooks.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+SteppingHooksMessenger::SteppingHooksMessenger(SteppingHooks* hooks)
+  : fHooks(hooks)
+{
+  fStepDir = new G4UIdirectory("/step/");
+  fStepDir->SetGuidance("per-step hooks; without any active hook no stepping action runs");
+
+  fLiveDebugCmd = new G4UIcmdWithABool("/step/liveDebug", this);
+  fLiveDebugCmd->SetGuidance("print every step of every track (positions, volumes, momenta)");
+  fLiveDebugCmd->SetParameterName("debug", true);
+  fLiveDebugCmd->SetDefaultValue(true);
+  fLiveDebugCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fKillInVolumeCmd = new G4UIcmdWithAString("/step/killInVolume", this);
+  fKillInVolumeCmd->SetGuidance("kill the tracks entering the logical volumes of this name");
+  fKillInVolumeCmd->SetParameterName("volume", false);
+  fKillInVolumeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearKillVolumesCmd = new G4UIcmdWithoutParameter("/step/clearKillVolumes", this);
+  fClearKillVolumesCmd->SetGuidance("remove all the volumes given with /step/killInVolume");
+  fClearKillVolumesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fLengthHistogramCmd = new G4UIcmdWithABool("/step/lengthHistogram", this);
+  fLengthHistogramCmd->SetGuidance("print the step length distribution of charged and neutral particles at the end of the run");
+  fLengthHistogramCmd->SetParameterName("histogram", true);
+  fLengthHistogramCmd->SetDefaultValue(true);
+  fLengthHistogramCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fKeepActionCmd = new G4UIcmdWithABool("/step/keepAction", this);
+  fKeepActionCmd->SetGuidance("keep the stepping action installed even without active hooks, where it does nothing");
+  fKeepActionCmd->SetGuidance("(to measure the per-step cost of an installed action)");
+  fKeepActionCmd->SetParameterName("keep", true);
+  fKeepActionCmd->SetDefaultValue(true);
+  fKeepActionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fListCmd = new G4UIcmdWithoutParameter("/step/list", this);
+  fListCmd->SetGuidance("print the stepping hooks and whether they are active");
+  fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fListCmd->SetToBeBroadcasted(false);
+}
+
+SteppingHooksMessenger::~SteppingHooksMessenger()
+{
+  delete fLiveDebugCmd;
+  delete fKillInVolumeCmd;
+  delete fClearKillVolumesCmd;
+  delete fLengthHistogramCmd;
+  delete fKeepActionCmd;
+  delete fListCmd;
+  delete fStepDir;
+}
+
+void SteppingHooksMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fLiveDebugCmd) fHooks->SetLiveDebug(fLiveDebugCmd->GetNewBoolValue(newValues));
+  if (command == fKillInVolumeCmd) fHooks->AddKillVolume(newValues);
+  if (command == fClearKillVolumesCmd) fHooks->ClearKillVolumes();
+  if (command == fLengthHistogramCmd) fHooks->SetStepLengthHistogram(fLengthHistogramCmd->GetNewBoolValue(newValues));
+  if (command == fKeepActionCmd) fHooks->SetKeepAction(fKeepActionCmd->GetNewBoolValue(newValues));
+  if (command == fListCmd) fHooks->Print();
+}
@@ -0,0 +1,30 @@
+#include "TrackHitTable.hh"
+
+#include <algorithm>
+
+TrackHitTable::TrackHitTable()
+{
+  fLinks.reserve(4096);
+}
+
+void TrackHitTable::Build()
+{
+  fOffsets.clear();
+  fIndices.clear();
+  if (fLinks.empty()) return;
+
+  G4int maxTrackID = 0;
+  for (const auto& link : fLinks) maxTrackID = std::max(maxTrackID, link.first);
+
+  // count the hits of each track, then turn the counts into start offsets
+  fOffsets.assign(static_cast<std::size_t>(maxTrackID) + 2, 0);
+  for (const auto& link : fLinks) ++fOffsets[link.first + 1];
+  for (std::size_t t = 1; t < fOffsets.size(); ++t) fOffsets[t] += fOffsets[t - 1];
+
+  // stable placement keeps the hits of a track in hit order; it moves each
+  // start to the start of the next track, so shift them back by one
+  fIndices.resize(fLinks.size());
+  for (const auto& link : fLinks) fIndices[fOffsets[link.first]++] = link.second;
+  for (std::size_t t = fOffsets.size() - 1; t > 0; --t) fOffsets[t] = fOffsets[t - 1];
+  fOffsets[0] = 0;
+}
@@ -9,7 +9,6 @@ TrackInformation::TrackInformation()
   fFromPrimaryPizero = 0;
   fFromFSLPizero = 0;
   fFromPrimaryLepton = 0;
-  fHitIndices = std::make_shared<std::vector<G4long>>();
 }
 
 TrackInformation::TrackInformation(const G4Track* aTrack) 
@@ -18,7 +17,6 @@ TrackInformation::TrackInformation(const G4Track* aTrack)
   fFromPrimaryPizero = 0;
   fFromFSLPizero = 0;
   fFromPrimaryLepton = 0;
-  fHitIndices = std::make_shared<std::vector<G4long>>();
 }
 
 TrackInformation::~TrackInformation()
@@ -0,0 +1,99 @@
+#include "TrackTable.hh"
+
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4EmProcessSubType.hh"
+#include "G4ParticleDefinition.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+TrackTable::TrackTable()
+{
+  // enough for typical neutrino events, grows to the largest event seen
+  fEntries.reserve(4096);
+}
+
+const TrackTable::ProcessClass& TrackTable::Classify(const G4VProcess* process)
+{
+  if (process == fLastProcess) return fLastClass;
+
+  auto it = std::find_if(fProcesses.begin(), fProcesses.end(),
+                         [process](const std::pair<const G4VProcess*, ProcessClass>& known) { return known.first == process; });
+  if (it == fProcesses.end()) {
+    Process category = kUndefined;
+    const G4int subType = process->GetProcessSubType();
+    switch (process->GetProcessType()) {
+      case fDecay: category = kDecay; break;
+      case fHadronic: category = kNuclearInteraction; break;
+      case fElectromagnetic:
+        if (subType == fGammaConversion) category = kPhotonConversion;
+        else if (subType == fBremsstrahlung) category = kBremsstrahlung;
+        break;
+      default: break;
+    }
+    fProcesses.emplace_back(process, ProcessClass{process->GetProcessName() == "Decay", category});
+    it = fProcesses.end() - 1;
+  }
+  fLastProcess = process;
+  fLastClass = it->second;
+  return fLastClass;
+}
+
+G4int TrackTable::GetFlagOrigin(G4int trackID, Flag flag) const
+{
+  if (!Has(trackID, flag)) return 0;
+  while (Has(Get(trackID).parentID, flag)) trackID = Get(trackID).parentID;
+  return trackID;
+}
+
+const TrackTable::Entry& TrackTable::Register(const G4Track* track)
+{
+  const G4int trackID = track->GetTrackID();
+  const G4int parentID = track->GetParentID();
+  if (trackID <= 0) return fUnknown;
+  if (fEntries.size() <= static_cast<std::size_t>(trackID)) fEntries.resize(trackID + 1);
+
+  Entry& entry = fEntries[trackID];
+  entry = Entry{};
+  entry.parentID = parentID;
+  entry.pdg = track->GetParticleDefinition()->GetPDGEncoding();
+  if (std::abs(entry.pdg) == 13) entry.flags |= kFromMuon;
+
+  if (fRecordProduction) {
+    if (fProductions.size() <= static_cast<std::size_t>(trackID)) fProductions.resize(trackID + 1);
+    Production& production = fProductions[trackID];
+    production.position = track->GetPosition();
+    production.time = track->GetGlobalTime();
+    production.momentum = track->GetMomentum();
+    production.mass = track->GetDynamicParticle()->GetMass();
+    production.charge = track->GetDynamicParticle()->GetCharge();
+    const G4VProcess* creator = track->GetCreatorProcess();
+    production.process = creator ? Classify(creator).process : kUndefined;
+  }
+
+  // primaries are their own ancestor
+  if (parentID == 0) {
+    entry.ancestorID = trackID;
+    return entry;
+  }
+
+  const Entry& parent = Get(parentID);
+  if (parent.ancestorID < 0) return entry;
+  entry.ancestorID = parent.ancestorID;
+  entry.flags |= (parent.flags & (kFromMuon | kFastShower));
+  entry.generation = (parent.generation < 255) ? parent.generation + 1 : 255;
+
+  // the creator process is only needed below track 1 and pi0s
+  if (parentID != 1 && parent.pdg != 111) return entry;
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if (!creator || !Classify(creator).isDecay) return entry;
+  entry.flags |= kDecayProduct;
+
+  // decay products counted as primary particles
+  if (parent.parentID == 0 && parent.pdg == 111) entry.flags |= kFromPrimaryPizero;
+  if (parentID == 1 && (std::abs(parent.pdg) == 15 || std::abs(parent.pdg) == 13)) entry.flags |= kFromPrimaryLepton;
+  if (parent.parentID == 1 && parent.pdg == 111 && (parent.flags & kDecayProduct)) entry.flags |= kFromFSLPizero;
+
+  return entry;
+}
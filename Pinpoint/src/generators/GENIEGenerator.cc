@@ -23,6 +23,8 @@
 #include "TMath.h"
 #include "TFile.h"
 #include "TTree.h"
+#include "Logging.hh"
+#include "generators/TreeInput.hh"
 
 GENIEGenerator::GENIEGenerator()
 {
@@ -32,7 +34,7 @@ GENIEGenerator::GENIEGenerator()
   fGSTFile = nullptr;
   fGSTTree = nullptr;
   fRandomVtx = false;
-  fEventCounter = 0;
+  fEvtStartIdx = 0;
 }
 
 GENIEGenerator::~GENIEGenerator()
@@ -60,53 +62,62 @@ void GENIEGenerator::LoadData()
   fNEntries = fGSTTree->GetEntries();
   G4cout << "Input GST tree has " << fNEntries << ((fNEntries==1)? " entry." : " entries.") << G4endl;
 
-  fGSTTree->SetBranchAddress("qel",&m_qel); // is QEL?   
-  fGSTTree->SetBranchAddress("mec",&m_mec); // is MEC?
-  fGSTTree->SetBranchAddress("res",&m_res); // is RES?
-  fGSTTree->SetBranchAddress("dis",&m_dis); // is DIS?
-  fGSTTree->SetBranchAddress("coh",&m_coh); // is Coherent?
-  fGSTTree->SetBranchAddress("dfr",&m_dfr); // id Diffractive?
-  fGSTTree->SetBranchAddress("imd",&m_imd); // is IMD?
-  fGSTTree->SetBranchAddress("imdanh",&m_imdanh); // is IMD annihilation?
-  fGSTTree->SetBranchAddress("singlek",&m_singlek); // is single Kaon?
-  fGSTTree->SetBranchAddress("nuel",&m_nuel);  // is ve elastic?
-  fGSTTree->SetBranchAddress("em",&m_em); // is EM process?
-  fGSTTree->SetBranchAddress("cc",&m_cc); // is Weak CC?
-  fGSTTree->SetBranchAddress("nc",&m_nc); // is Weak NC?
-  fGSTTree->SetBranchAddress("charm",&m_charm); // produces charm?
-  fGSTTree->SetBranchAddress("amnugamma",&m_amnugamma); // is anomaly mediated nu gamma?
-
-  fGSTTree->SetBranchAddress("neu",&m_neuPDG); //neutrino PDG
-  fGSTTree->SetBranchAddress("Ev",&m_Ev); // neutrino energy (GeV)
-  fGSTTree->SetBranchAddress("pxv",&m_pxv); // neutrino px (GeV)
-  fGSTTree->SetBranchAddress("pyv",&m_pyv); // neutrino py (Gev)
-  fGSTTree->SetBranchAddress("pzv",&m_pzv); // neutrino pz (GeV)
+  // only the branches bound below are read, the gst tree has many more
+  TreeInput::Begin(fGSTTree, fIOCacheSize, fEvtStartIdx);
+
+  TreeInput::Bind(fGSTTree, "qel", &m_qel); // is QEL?   
+  TreeInput::Bind(fGSTTree, "mec", &m_mec); // is MEC?
+  TreeInput::Bind(fGSTTree, "res", &m_res); // is RES?
+  TreeInput::Bind(fGSTTree, "dis", &m_dis); // is DIS?
+  TreeInput::Bind(fGSTTree, "coh", &m_coh); // is Coherent?
+  TreeInput::Bind(fGSTTree, "dfr", &m_dfr); // id Diffractive?
+  TreeInput::Bind(fGSTTree, "imd", &m_imd); // is IMD?
+  TreeInput::Bind(fGSTTree, "imdanh", &m_imdanh); // is IMD annihilation?
+  TreeInput::Bind(fGSTTree, "singlek", &m_singlek); // is single Kaon?
+  TreeInput::Bind(fGSTTree, "nuel", &m_nuel);  // is ve elastic?
+  TreeInput::Bind(fGSTTree, "em", &m_em); // is EM process?
+  TreeInput::Bind(fGSTTree, "cc", &m_cc); // is Weak CC?
+  TreeInput::Bind(fGSTTree, "nc", &m_nc); // is Weak NC?
+  TreeInput::Bind(fGSTTree, "amnugamma", &m_amnugamma); // is anomaly mediated nu gamma?
+
+  TreeInput::Bind(fGSTTree, "neu", &m_neuPDG); //neutrino PDG
+  TreeInput::Bind(fGSTTree, "Ev", &m_Ev); // neutrino energy (GeV)
+  TreeInput::Bind(fGSTTree, "pxv", &m_pxv); // neutrino px (GeV)
+  TreeInput::Bind(fGSTTree, "pyv", &m_pyv); // neutrino py (Gev)
+  TreeInput::Bind(fGSTTree, "pzv", &m_pzv); // neutrino pz (GeV)
  
-  fGSTTree->SetBranchAddress("fspl",&m_fslPDG); // primary letpton PDG
-  fGSTTree->SetBranchAddress("El",&m_El); // primary lepton energy (GeV)
-  fGSTTree->SetBranchAddress("pxl",&m_pxl); // primary lepton px (GeV)
-  fGSTTree->SetBranchAddress("pyl",&m_pyl); // primary lepton py (Gev)
-  fGSTTree->SetBranchAddress("pzl",&m_pzl); // primary lepton pz (GeV)
+  TreeInput::Bind(fGSTTree, "fspl", &m_fslPDG); // primary letpton PDG
+  TreeInput::Bind(fGSTTree, "El", &m_El); // primary lepton energy (GeV)
+  TreeInput::Bind(fGSTTree, "pxl", &m_pxl); // primary lepton px (GeV)
+  TreeInput::Bind(fGSTTree, "pyl", &m_pyl); // primary lepton py (Gev)
+  TreeInput::Bind(fGSTTree, "pzl", &m_pzl); // primary lepton pz (GeV)
   
-  fGSTTree->SetBranchAddress("nf",&m_nf); // number of final state hadrons
-  fGSTTree->SetBranchAddress("pdgf",&m_pdgf); // hadrons PDG
-  fGSTTree->SetBranchAddress("Ef",&m_Ef); // hadrons energy (GeV)
-  fGSTTree->SetBranchAddress("pxf",&m_pxf); // hadrons px (GeV)
-  fGSTTree->SetBranchAddress("pyf",&m_pyf); // hadrons py (Gev)
-  fGSTTree->SetBranchAddress("pzf",&m_pzf); // hadrons pz (GeV)
+  TreeInput::Bind(fGSTTree, "nf", &m_nf); // number of final state hadrons
+  TreeInput::Bind(fGSTTree, "pdgf", &m_pdgf); // hadrons PDG
+  TreeInput::Bind(fGSTTree, "Ef", &m_Ef); // hadrons energy (GeV)
+  TreeInput::Bind(fGSTTree, "pxf", &m_pxf); // hadrons px (GeV)
+  TreeInput::Bind(fGSTTree, "pyf", &m_pyf); // hadrons py (Gev)
+  TreeInput::Bind(fGSTTree, "pzf", &m_pzf); // hadrons pz (GeV)
   
-  fGSTTree->SetBranchAddress("W",&m_W); // invariant hadronic mass (GeV)
-  fGSTTree->SetBranchAddress("Q2",&m_Q2); // momentum transfer (GeV^2)
-  fGSTTree->SetBranchAddress("x",&m_x); // Bjorken x
-  fGSTTree->SetBranchAddress("y",&m_y); // inelasticity
+  TreeInput::Bind(fGSTTree, "W", &m_W); // invariant hadronic mass (GeV)
+  TreeInput::Bind(fGSTTree, "Q2", &m_Q2); // momentum transfer (GeV^2)
+  TreeInput::Bind(fGSTTree, "x", &m_x); // Bjorken x
+  TreeInput::Bind(fGSTTree, "y", &m_y); // inelasticity
 
-  fGSTTree->SetBranchAddress("wght",&m_wght); // event weigth
+  TreeInput::Bind(fGSTTree, "wght", &m_wght); // event weigth
   
-  fGSTTree->SetBranchAddress("tgt",&m_tgt); // nuclear target pdg
-  fGSTTree->SetBranchAddress("Z",&m_Z); // nuclear target Z
-  fGSTTree->SetBranchAddress("A",&m_A); // nuclear target A
-  fGSTTree->SetBranchAddress("hitnuc",&m_hitnuc); // hit nucleon pfg
+  TreeInput::Bind(fGSTTree, "tgt", &m_tgt); // nuclear target pdg
+  TreeInput::Bind(fGSTTree, "Z", &m_Z); // nuclear target Z
+  TreeInput::Bind(fGSTTree, "A", &m_A); // nuclear target A
+  TreeInput::Bind(fGSTTree, "hitnuc", &m_hitnuc); // hit nucleon pfg
 
+  TreeInput::End(fGSTTree);
+
+}
+
+void GENIEGenerator::PrintIOStats() const
+{
+  if (fGSTTree) TreeInput::PrintStats(fGSTTree, "GENIE");
 }
 
 G4bool GENIEGenerator::FindParticleDefinition(G4int const pdg, G4ParticleDefinition* &particleDefinition) const
@@ -117,9 +128,8 @@ G4bool GENIEGenerator::FindParticleDefinition(G4int const pdg, G4ParticleDefinit
   const int genieLo = 2000000001;
   const int genieHi = 2000000202;
   if ( pdg >= genieLo && pdg <= genieHi) {
-    G4cout<< "This unknown PDG code [" << pdg << "] was present in the GENIE input, "
-             << "but will not be processed by Geant4."
-             << G4endl;
+    LOG_WARNING("This unknown PDG code [" << pdg << "] was present in the GENIE input, "
+                << "but will not be processed by Geant4.");
     return false; // return bad
   }
   
@@ -145,13 +155,12 @@ G4bool GENIEGenerator::FindParticleDefinition(G4int const pdg, G4ParticleDefinit
 void GENIEGenerator::GeneratePrimaries(G4Event* anEvent)
 {
 
-  // complete line from PrimaryGeneratorAction...
-  G4cout << ") : GENIE Generator ===oooOOOooo===" << G4endl;
-  
-  G4cout << "oooOOOooo Event # " << fEventCounter << " oooOOOooo" << G4endl;
-  G4cout << "GeneratePrimaries from file " << fGSTFilename << ", evtID starts from "<< fEvtStartIdx << ", now at " << fEvtStartIdx+fEventCounter << G4endl;
+  // the G4 event ID is unique across worker threads, a private counter is not
+  G4long currentIdx = fEvtStartIdx + anEvent->GetEventID();
+
+  LOG_DEBUG("oooOOOooo Event # " << anEvent->GetEventID() << " oooOOOooo");
+  LOG_DEBUG("GeneratePrimaries from file " << fGSTFilename << ", evtID starts from "<< fEvtStartIdx << ", now at " << currentIdx);
 
-  G4int currentIdx = fEvtStartIdx+fEventCounter;
   anEvent->SetEventID(currentIdx);
 
   if ( currentIdx >= fNEntries ) {
@@ -169,9 +178,9 @@ void GENIEGenerator::GeneratePrimaries(G4Event* anEvent)
   G4LorentzVector neuX4;
 
 
-  // G4Random::setTheSeed(currentIdx+1);
+  // the engine was already seeded for this event by PrimaryGeneratorAction
   if(fRandomVtx){
-    G4ThreeVector rdm_vtx = GenerateRandomPoint(currentIdx);
+    G4ThreeVector rdm_vtx = GenerateRandomPoint();
     neuX4.setX(rdm_vtx.x());
     neuX4.setY(rdm_vtx.y());
     neuX4.setZ(rdm_vtx.z());
@@ -237,7 +246,6 @@ void GENIEGenerator::GeneratePrimaries(G4Event* anEvent)
   fVertexMetadata.push_back(metadata);
 
   anEvent->AddPrimaryVertex(vtx);
-  fEventCounter++;
 
 }
 
@@ -335,7 +343,7 @@ G4String GENIEGenerator::EncodeProcessName() const
 
 
 
-G4ThreeVector GENIEGenerator::GenerateRandomPoint(G4int currentIdx) const {
+G4ThreeVector GENIEGenerator::GenerateRandomPoint() const {
   auto *runManager = G4RunManager::GetRunManager();
   auto detector = (DetectorConstruction*) (runManager->GetUserDetectorConstruction());
 
@@ -360,7 +368,6 @@ G4ThreeVector GENIEGenerator::GenerateRandomPoint(G4int currentIdx) const {
   G4double dy = box->GetYHalfLength();
   G4double dz = box->GetZHalfLength();
 
-  G4Random::setTheSeed(currentIdx+1);
   G4ThreeVector point;
   do {
     point = G4ThreeVector(
@@ -22,6 +22,8 @@
 #include "TTree.h"
 #include "TApplication.h"
 #include "TROOT.h"
+#include "Logging.hh"
+#include "generators/TreeInput.hh"
 
 #include <string>
 
@@ -33,12 +35,13 @@ GFaserGenerator::GFaserGenerator()
 
   fGfaserFile = nullptr;
   fGfaserTree = nullptr;
+  fFirstEvent = 0;
+  fUseFixedZPosition = true;
 }
 
 
 GFaserGenerator::~GFaserGenerator()
 {
-  delete fName; fName = nullptr;
   delete fPdgc; fPdgc = nullptr;
   delete fStatus; fStatus = nullptr;
   delete fPx; fPx = nullptr;
@@ -78,38 +81,41 @@ void GFaserGenerator::LoadData()
     return;
   }
 
-  fGfaserTree->SetBranchAddress("n", &fN);
-  fGfaserTree->SetBranchAddress("vx", &fVx);
-  fGfaserTree->SetBranchAddress("vy", &fVy);
-  fGfaserTree->SetBranchAddress("vz", &fVz);
-  fGfaserTree->SetBranchAddress("name", &fName);
-  fGfaserTree->SetBranchAddress("pdgc", &fPdgc);
-  fGfaserTree->SetBranchAddress("status", &fStatus);
-  fGfaserTree->SetBranchAddress("px", &fPx);
-  fGfaserTree->SetBranchAddress("py", &fPy);
-  fGfaserTree->SetBranchAddress("pz", &fPz);
-  fGfaserTree->SetBranchAddress("E", &fE);
-  fGfaserTree->SetBranchAddress("pxv", &fPxv);
-  fGfaserTree->SetBranchAddress("pyv", &fPyv);
-  fGfaserTree->SetBranchAddress("pzv", &fPzv);
-  fGfaserTree->SetBranchAddress("Ev", &fEv);
-  fGfaserTree->SetBranchAddress("Q2", &fQ2);
-  fGfaserTree->SetBranchAddress("W", &fW);
-  fGfaserTree->SetBranchAddress("x", &fX);
-  fGfaserTree->SetBranchAddress("y", &fY);
-  fGfaserTree->SetBranchAddress("xsec", &xsec);
-  fGfaserTree->SetBranchAddress("intType", &fIntType);
-  fGfaserTree->SetBranchAddress("scatteringType", &fScatType);
-  fGfaserTree->SetBranchAddress("cc", &fIsCc);
-  fGfaserTree->SetBranchAddress("nc", &fIsNc);
-  fGfaserTree->SetBranchAddress("Z", &fTgtZ);
-  fGfaserTree->SetBranchAddress("A", &fTgtA);
-  fGfaserTree->SetBranchAddress("tgt", &fTgtPdg);
-  fGfaserTree->SetBranchAddress("neu", &fNuPdg);
-  fGfaserTree->SetBranchAddress("fspl", &fLeptonPdg);
-  fGfaserTree->SetBranchAddress("hitnuc", &fHitPdg);
-
-  fCurrentEvent = fFirstEvent;
+  // only the branches bound below are read (the particle names are not used)
+  TreeInput::Begin(fGfaserTree, fIOCacheSize, fFirstEvent);
+
+  TreeInput::Bind(fGfaserTree, "n", &fN);
+  TreeInput::Bind(fGfaserTree, "vx", &fVx);
+  TreeInput::Bind(fGfaserTree, "vy", &fVy);
+  TreeInput::Bind(fGfaserTree, "vz", &fVz);
+  TreeInput::Bind(fGfaserTree, "pdgc", &fPdgc);
+  TreeInput::Bind(fGfaserTree, "status", &fStatus);
+  TreeInput::Bind(fGfaserTree, "px", &fPx);
+  TreeInput::Bind(fGfaserTree, "py", &fPy);
+  TreeInput::Bind(fGfaserTree, "pz", &fPz);
+  TreeInput::Bind(fGfaserTree, "E", &fE);
+  TreeInput::Bind(fGfaserTree, "pxv", &fPxv);
+  TreeInput::Bind(fGfaserTree, "pyv", &fPyv);
+  TreeInput::Bind(fGfaserTree, "pzv", &fPzv);
+  TreeInput::Bind(fGfaserTree, "Ev", &fEv);
+  TreeInput::Bind(fGfaserTree, "Q2", &fQ2);
+  TreeInput::Bind(fGfaserTree, "W", &fW);
+  TreeInput::Bind(fGfaserTree, "x", &fX);
+  TreeInput::Bind(fGfaserTree, "y", &fY);
+  TreeInput::Bind(fGfaserTree, "xsec", &xsec);
+  TreeInput::Bind(fGfaserTree, "intType", &fIntType);
+  TreeInput::Bind(fGfaserTree, "scatteringType", &fScatType);
+  TreeInput::Bind(fGfaserTree, "cc", &fIsCc);
+  TreeInput::Bind(fGfaserTree, "nc", &fIsNc);
+  TreeInput::Bind(fGfaserTree, "Z", &fTgtZ);
+  TreeInput::Bind(fGfaserTree, "A", &fTgtA);
+  TreeInput::Bind(fGfaserTree, "tgt", &fTgtPdg);
+  TreeInput::Bind(fGfaserTree, "neu", &fNuPdg);
+  TreeInput::Bind(fGfaserTree, "fspl", &fLeptonPdg);
+  TreeInput::Bind(fGfaserTree, "hitnuc", &fHitPdg);
+
+  TreeInput::End(fGfaserTree);
+
   fTotalEvents = fGfaserTree->GetEntries();
   
   G4cout << "Opened Gfaser file: " << fInputFileName << G4endl;
@@ -117,6 +123,12 @@ void GFaserGenerator::LoadData()
 }
 
 
+void GFaserGenerator::PrintIOStats() const
+{
+  if (fGfaserTree) TreeInput::PrintStats(fGfaserTree, "GFaser");
+}
+
+
 G4String GFaserGenerator::EncodeProcessName() const
 {
   G4String process = "";
@@ -137,10 +149,12 @@ G4String GFaserGenerator::EncodeProcessName() const
 
 void GFaserGenerator::GeneratePrimaries(G4Event* event)
 {
+  // the G4 event ID is unique across worker threads, a private counter is not
+  fCurrentEvent = fFirstEvent + event->GetEventID();
+
   // complete line from PrimaryGeneratorAction...
-  G4cout << ") : GFaser Generator ===oooOOOooo===" << G4endl;
-  G4cout << "oooOOOooo Event # " << fCurrentEvent << "/" << fTotalEvents << " oooOOOooo" << G4endl;
-  G4cout << "GeneratePrimaries from file " << fInputFileName << G4endl;
+  LOG_DEBUG("oooOOOooo Event # " << fCurrentEvent << "/" << fTotalEvents << " oooOOOooo");
+  LOG_DEBUG("GeneratePrimaries from file " << fInputFileName);
 
   event->SetEventID(fCurrentEvent);
   if (fCurrentEvent >= fTotalEvents) {
@@ -189,8 +203,6 @@ void GFaserGenerator::GeneratePrimaries(G4Event* event)
   metadata.W = fW;
   metadata.xs = xsec;
   fVertexMetadata.push_back(metadata);
-
-  fCurrentEvent++;
 }
 
 
@@ -202,9 +214,8 @@ G4bool GFaserGenerator::FindParticleDefinition(G4int const pdg, G4ParticleDefini
   const int genieLo = 2000000001;
   const int genieHi = 2000000202;
   if ( pdg >= genieLo && pdg <= genieHi) {
-    G4cout<< "This unknown PDG code [" << pdg << "] was present in the GENIE input, "
-             << "but will not be processed by Geant4."
-             << G4endl;
+    LOG_WARNING("This unknown PDG code [" << pdg << "] was present in the GENIE input, "
+                << "but will not be processed by Geant4.");
     return false; // return bad
   }
   
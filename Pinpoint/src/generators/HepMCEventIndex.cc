@@ -0,0 +1,110 @@
+#include "generators/HepMCEventIndex.hh"
+#include "Logging.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  const char* kIndexHeader = "# pinpoint hepmc index v1";
+}
+
+G4bool HepMCEventIndex::Load(const G4String& filename)
+{
+  fOffsets.clear();
+
+  struct stat st;
+  if (stat(filename.c_str(), &st) != 0) return false;
+  const long long size = st.st_size;
+  const long long mtime = st.st_mtime;
+
+  const G4String indexName = GetIndexFilename(filename);
+  if (ReadSidecar(indexName, size, mtime)) {
+    LOG_INFO("HepMC index: " << fOffsets.size() << " events from " << indexName);
+    return true;
+  }
+
+  LOG_INFO("HepMC index: scanning " << filename << " for event offsets");
+  if (!Build(filename)) return false;
+  WriteSidecar(indexName, size, mtime);
+  LOG_INFO("HepMC index: " << fOffsets.size() << " events found");
+  return true;
+}
+
+G4bool HepMCEventIndex::ReadSidecar(const G4String& indexName, long long size, long long mtime)
+{
+  std::ifstream in(indexName);
+  if (!in) return false;
+
+  std::string header;
+  std::getline(in, header);
+  if (header != kIndexHeader) return false;
+
+  long long idxSize = -1, idxMtime = -1;
+  std::size_t nEvents = 0;
+  in >> idxSize >> idxMtime >> nEvents;
+  if (!in || idxSize != size || idxMtime != mtime) return false;
+
+  fOffsets.resize(nEvents);
+  for (auto& offset : fOffsets) in >> offset;
+  if (!in) {
+    fOffsets.clear();
+    return false;
+  }
+  return true;
+}
+
+G4bool HepMCEventIndex::Build(const G4String& filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) return false;
+
+  // plain byte scan for "\nE " instead of parsing every event; the state
+  // is carried over chunk boundaries
+  std::vector<char> buffer(1 << 20);
+  std::streamoff position = 0;
+  std::streamoff candidate = -1;  // offset of an 'E' at the start of a line
+  G4bool atLineStart = true;
+
+  while (in) {
+    in.read(buffer.data(), buffer.size());
+    const std::streamsize n = in.gcount();
+    for (std::streamsize i = 0; i < n; ++i, ++position) {
+      const char c = buffer[i];
+      if (candidate >= 0) {
+        if (c == ' ') fOffsets.push_back(candidate);
+        candidate = -1;
+      }
+      if (atLineStart && c == 'E') candidate = position;
+      atLineStart = (c == '\n');
+    }
+  }
+  return true;
+}
+
+void HepMCEventIndex::WriteSidecar(const G4String& indexName, long long size, long long mtime) const
+{
+  // written to a temporary file and renamed, so that jobs started on the
+  // same input at the same time never read a partial index
+  std::ostringstream tmpName;
+  tmpName << indexName << ".tmp" << getpid();
+
+  // the stream is checked after close(), as the last buffered write (e.g.
+  // on a full disk) only fails when it is flushed
+  std::ofstream out(tmpName.str());
+  out << kIndexHeader << "\n" << size << " " << mtime << " " << fOffsets.size() << "\n";
+  for (const auto offset : fOffsets) out << offset << "\n";
+  out.close();
+  if (!out) {
+    LOG_WARNING("HepMC index: cannot write " << indexName << ", the index is kept in memory only");
+    std::remove(tmpName.str().c_str());
+    return;
+  }
+
+  if (std::rename(tmpName.str().c_str(), indexName.c_str()) != 0) {
+    LOG_WARNING("HepMC index: cannot write " << indexName << ", the index is kept in memory only");
+    std::remove(tmpName.str().c_str());
+  }
+}
@@ -13,8 +13,21 @@
 #include "G4TransportationManager.hh"
 #include "G4Navigator.hh"
 #include "G4RunManager.hh"
+#include "G4Run.hh"
 #include "G4PhysicalVolumeStore.hh"
 #include "G4Box.hh"
+#include "G4AutoLock.hh"
+#include "Logging.hh"
+
+#include <fstream>
+
+std::shared_ptr<HepMC3::Reader> HepMCGenerator::sSharedInput = nullptr;
+std::shared_ptr<std::istream> HepMCGenerator::sSharedStream = nullptr;
+std::shared_ptr<HepMCEventIndex> HepMCGenerator::sSharedIndex = nullptr;
+std::shared_ptr<HepMCPrefetcher> HepMCGenerator::sSharedPrefetcher = nullptr;
+G4String HepMCGenerator::sSharedFilename = "";
+G4int HepMCGenerator::sSharedRunID = -1;
+G4Mutex HepMCGenerator::sReaderMutex = G4MUTEX_INITIALIZER;
 
 
 HepMCGenerator::HepMCGenerator()
@@ -25,33 +38,115 @@ HepMCGenerator::HepMCGenerator()
   fAsciiInput = nullptr;
   fVtxOffset = G4ThreeVector(0,0,0);
   fUseHepMC2 = false;
+  fFirstEvent = 0;
+  fUseIndex = true;
+  fPrefetchDepth = 0;
+  fRunID = -1;
 }
 
 HepMCGenerator::~HepMCGenerator()
 {
-  delete fAsciiInput;
   delete fMessenger;
+
+  // the last generator using the prefetch thread stops it
+  G4AutoLock lock(&sReaderMutex);
+  if (fPrefetcher && fPrefetcher == sSharedPrefetcher && sSharedPrefetcher.use_count() == 2) {
+    sSharedPrefetcher->Stop();
+    LOG_INFO("HepMC prefetch: " << sSharedPrefetcher->GetNumberOfWaits() << " of "
+             << sSharedPrefetcher->GetNumberOfAcquired() << " events waited for the parser");
+    sSharedPrefetcher = nullptr;
+  }
 }
 
 void HepMCGenerator::LoadData()
 {   
   // this is called only once from PrimaryGeneratorAction, no need to worry about data bein reloaded anymore
-  // TODO: Would be nice if we could load specific events - no functionallity in HepMC to do this - could make use of `skip` method?
   
-  fAsciiInput = (fUseHepMC2) 
-              ? static_cast<HepMC3::Reader*>(new HepMC3::ReaderAsciiHepMC2(fHepMCFilename)) 
-              : static_cast<HepMC3::Reader*>(new HepMC3::ReaderAscii(fHepMCFilename));
+  // every worker thread calls this, only the first one loads the index; the
+  // reader is opened at the start of each run (BeginOfRun)
+  G4AutoLock lock(&sReaderMutex);
+  if (sSharedFilename != fHepMCFilename) {
+    sSharedIndex = nullptr;
+    if (fUseIndex) {
+      auto index = std::make_shared<HepMCEventIndex>();
+      if (index->Load(fHepMCFilename)) sSharedIndex = index;
+    }
+    sSharedFilename = fHepMCFilename;
+    // a new file is opened by the next run in any case
+    sSharedRunID = -1;
+  }
+}
 
-  if( fAsciiInput->failed() ){
+void HepMCGenerator::BeginOfRun(G4int runID)
+{
+  G4AutoLock lock(&sReaderMutex);
+  if (sSharedRunID != runID) {
+    RewindInput();
+    sSharedRunID = runID;
+  }
+  fRunID = runID;
+  fAsciiInput = sSharedInput;
+  fPrefetcher = sSharedPrefetcher;
+
+  if( !fPrefetcher && (!*sSharedStream || fAsciiInput->failed()) ){
     G4String err = "Cannot open HepMC file : " + fHepMCFilename;
     G4Exception("HepMCGenerator", "FileError", FatalErrorInArgument, err.c_str());
   }
 }
 
-std::shared_ptr<HepMC3::GenEvent> HepMCGenerator::GenerateHepMCEvent()
+void HepMCGenerator::RewindInput()
+{
+  // called with sReaderMutex held. The previous run has ended on all threads:
+  // its prefetched events are dropped, and a fresh reader makes the indexed,
+  // sequential and prefetch modes all start again at fFirstEvent
+  if (sSharedPrefetcher) {
+    sSharedPrefetcher->Stop();
+    LOG_INFO("HepMC prefetch: " << sSharedPrefetcher->GetNumberOfWaits() << " of "
+             << sSharedPrefetcher->GetNumberOfAcquired() << " events waited for the parser");
+    sSharedPrefetcher = nullptr;
+  }
+
+  // the readers are built on a stream we own so that it can be repositioned
+  sSharedStream = std::make_shared<std::ifstream>(fHepMCFilename);
+  sSharedInput = (fUseHepMC2)
+               ? std::static_pointer_cast<HepMC3::Reader>(std::make_shared<HepMC3::ReaderAsciiHepMC2>(sSharedStream))
+               : std::static_pointer_cast<HepMC3::Reader>(std::make_shared<HepMC3::ReaderAscii>(sSharedStream));
+
+  if (sSharedIndex && sSharedIndex->GetNumberOfEvents() > 0) {
+    // the run header (weight names, tools) sits before the first event and is
+    // only parsed by read_event, so read the first event once before seeking
+    HepMC3::GenEvent header;
+    sSharedInput->read_event(header);
+  }
+  else if (fFirstEvent > 0) {
+    // no index: fall back to parsing the events in front of the first one
+    sSharedInput->skip(fFirstEvent);
+  }
+
+  if (fPrefetchDepth > 0) {
+    // the prefetch thread reads sequentially from the first event on
+    if (sSharedIndex) {
+      sSharedStream->clear();
+      if (fFirstEvent < static_cast<G4long>(sSharedIndex->GetNumberOfEvents()))
+        sSharedStream->seekg(sSharedIndex->GetOffset(fFirstEvent));
+      else
+        sSharedStream->seekg(0, std::ios::end);
+    }
+    sSharedPrefetcher = std::make_shared<HepMCPrefetcher>(sSharedInput, fFirstEvent, fPrefetchDepth);
+  }
+}
+
+std::shared_ptr<HepMC3::GenEvent> HepMCGenerator::GenerateHepMCEvent(G4long entry)
 { 
   std::shared_ptr<HepMC3::GenEvent> evt = std::make_shared<HepMC3::GenEvent>();
+  G4AutoLock lock(&sReaderMutex);
+  if (sSharedIndex) {
+    if (entry < 0 || entry >= static_cast<G4long>(sSharedIndex->GetNumberOfEvents())) return nullptr;
+    sSharedStream->clear();
+    sSharedStream->seekg(sSharedIndex->GetOffset(entry));
+  }
   fAsciiInput->read_event(*evt);
+  if (fAsciiInput->failed()) return nullptr;
   //// HepMC3::Print::content(*evt);
   return evt;
 }
@@ -85,27 +180,44 @@ static G4VPhysicalVolume* FindPhysicalVolumeByName(const G4String& name) {
 void HepMCGenerator::GeneratePrimaries(G4Event* anEvent)
 {
 
-  // complete line from PrimaryGeneratorAction..
-  G4cout << ") : HepMC" << ((fUseHepMC2) ? "2" : "3") << " Generator ===oooOOOooo===" << G4endl;
-  
-  G4cout << "oooOOOooo Event # " << anEvent->GetEventID() << " oooOOOooo" << G4endl;
-  G4cout << "GeneratePrimaries from file " << fHepMCFilename << G4endl;
+  LOG_DEBUG("oooOOOooo Event # " << anEvent->GetEventID() << " oooOOOooo");
+  LOG_DEBUG("GeneratePrimaries from file " << fHepMCFilename);
+
+  // event IDs restart at 0 in every run, and so does the input
+  const G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  if (runID != fRunID) BeginOfRun(runID);
+
+  const G4long entry = fFirstEvent + anEvent->GetEventID();
+
+  // with prefetching the event was already parsed on the prefetch thread,
+  // its slot in the ring is handed back once the primaries are built
+  if (fPrefetcher) {
+    const HepMC3::GenEvent* HepMCEvent = fPrefetcher->Acquire(entry);
+    if(!HepMCEvent) {
+      LOG_WARNING("HepMCInterface: no generated particles. run terminated...");
+      G4RunManager::GetRunManager()-> AbortRun();
+      return;
+    }
+    HepMC2G4(*HepMCEvent, anEvent);
+    fPrefetcher->Release(entry);
+    return;
+  }
 
-  // generate next event
-  std::shared_ptr<HepMC3::GenEvent> HepMCEvent = GenerateHepMCEvent();
+  // generate next event, the entry is only used when the input is indexed
+  std::shared_ptr<HepMC3::GenEvent> HepMCEvent = GenerateHepMCEvent(entry);
   if(!HepMCEvent) {
-    G4cout << "HepMCInterface: no generated particles. run terminated..." << G4endl;
+    LOG_WARNING("HepMCInterface: no generated particles. run terminated...");
     G4RunManager::GetRunManager()-> AbortRun();
     return;
   }
 
-  HepMC2G4(HepMCEvent, anEvent);
+  HepMC2G4(*HepMCEvent, anEvent);
 }
 
 
-void HepMCGenerator::HepMC2G4(const std::shared_ptr<HepMC3::GenEvent> hepmcevt, G4Event* g4event)
+void HepMCGenerator::HepMC2G4(const HepMC3::GenEvent& hepmcevt, G4Event* g4event)
 {
-  for (const auto& vertex : hepmcevt->vertices()) {
+  for (const auto& vertex : hepmcevt.vertices()) {
 
     // check world boundary
     HepMC3::FourVector pos = vertex->position(); // in mm, ns
@@ -119,8 +231,8 @@ void HepMCGenerator::HepMC2G4(const std::shared_ptr<HepMC3::GenEvent> hepmcevt,
     G4LorentzVector xvtx(pos.x()*mm+vtx_x_offset, pos.y()*mm+vtx_y_offset, pos.z()*mm+vtx_z_offset, pos.t()*mm/c_light);
         
     if (! CheckVertexInsideWorld(xvtx.vect())){
-      G4cout << "WARNING: tried to generate vertex outside of world volume!" << G4endl;
-      G4cout << "WARNING: position was (" << pos.x() << ", "<<  pos.y() << ", " << pos.z() << ", " << pos.t() << ")" << G4endl;
+      LOG_WARNING("tried to generate vertex outside of world volume, position was ("
+                  << pos.x() << ", "<<  pos.y() << ", " << pos.z() << ", " << pos.t() << ")");
       continue;
     }
 
@@ -147,9 +259,9 @@ void HepMCGenerator::HepMC2G4(const std::shared_ptr<HepMC3::GenEvent> hepmcevt,
     GeneratorVertexMetadata metadata;
     metadata.generatorType = fGeneratorName;
     metadata.processName = "Decay";
-    metadata.weight = hepmcevt->weights()[0];
+    metadata.weight = hepmcevt.weights()[0];
     metadata.x4 = xvtx;
-    metadata.xs = hepmcevt->cross_section()->xsec();
+    metadata.xs = hepmcevt.cross_section()->xsec();
     fVertexMetadata.push_back(metadata);
 
     g4event->AddPrimaryVertex(g4vtx);
@@ -6,6 +6,7 @@
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -36,6 +37,27 @@ HepMCGeneratorMessenger::HepMCGeneratorMessenger(HepMCGenerator* action)
   fHepMCPlaceInDecayVolumeCmd->SetGuidance("will try and translate vertex into FASER2 decay volume. Note: Assumes that vertices in HepMC start from (0,0,0) - set /hepmc/vtxOffset if not. Also assumes that decay volume lengths match.");
   fHepMCPlaceInDecayVolumeCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
   fHepMCPlaceInDecayVolumeCmd->SetDefaultValue(true);
+
+  fHepMCFirstEventCmd = new G4UIcmdWithAnInteger("/gen/hepmc/firstEvent", this);
+  fHepMCFirstEventCmd->SetGuidance("set the index of the first event to simulate in the HepMC file");
+  fHepMCFirstEventCmd->SetGuidance("event N of the run reads entry firstEvent + N; with the event index this is a direct seek");
+  fHepMCFirstEventCmd->SetParameterName("firstEvent", false);
+  fHepMCFirstEventCmd->SetRange("firstEvent>=0");
+  fHepMCFirstEventCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
+  fHepMCUseIndexCmd = new G4UIcmdWithABool("/gen/hepmc/useIndex", this);
+  fHepMCUseIndexCmd->SetGuidance("use the byte-offset index of the HepMC file (cached in <file>.idx) to seek to each event");
+  fHepMCUseIndexCmd->SetGuidance("if false the file is read sequentially");
+  fHepMCUseIndexCmd->SetParameterName("useIndex", true);
+  fHepMCUseIndexCmd->SetDefaultValue(true);
+  fHepMCUseIndexCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
+  fHepMCPrefetchDepthCmd = new G4UIcmdWithAnInteger("/gen/hepmc/prefetchDepth", this);
+  fHepMCPrefetchDepthCmd->SetGuidance("parse the HepMC input on a background thread, keeping up to this many events decoded ahead");
+  fHepMCPrefetchDepthCmd->SetGuidance("0 parses each event on the simulation thread when it is needed");
+  fHepMCPrefetchDepthCmd->SetParameterName("prefetchDepth", false);
+  fHepMCPrefetchDepthCmd->SetRange("prefetchDepth>=0");
+  fHepMCPrefetchDepthCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -47,6 +69,9 @@ HepMCGeneratorMessenger::~HepMCGeneratorMessenger()
   delete fUseHepMC2Cmd;
   delete fHepMCGeneratorDir;
   delete fHepMCPlaceInDecayVolumeCmd;
+  delete fHepMCFirstEventCmd;
+  delete fHepMCUseIndexCmd;
+  delete fHepMCPrefetchDepthCmd;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -57,6 +82,9 @@ void HepMCGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValu
   else if (command == fHepMCVertexOffsetCmd) fHepMCAction->SetHepMCVertexOffset(fHepMCVertexOffsetCmd->GetNew3VectorValue(newValues));
   else if (command == fUseHepMC2Cmd) fHepMCAction->SetUseHepMC2(fUseHepMC2Cmd->GetNewBoolValue(newValues));
   else if (command == fHepMCPlaceInDecayVolumeCmd) fHepMCAction->SetPlaceInDecayVolume(fHepMCPlaceInDecayVolumeCmd->GetNewBoolValue(newValues));
+  else if (command == fHepMCFirstEventCmd) fHepMCAction->SetFirstEvent(fHepMCFirstEventCmd->GetNewIntValue(newValues));
+  else if (command == fHepMCUseIndexCmd) fHepMCAction->SetUseIndex(fHepMCUseIndexCmd->GetNewBoolValue(newValues));
+  else if (command == fHepMCPrefetchDepthCmd) fHepMCAction->SetPrefetchDepth(fHepMCPrefetchDepthCmd->GetNewIntValue(newValues));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,88 @@
+#include "generators/HepMCPrefetcher.hh"
+
+HepMCPrefetcher::HepMCPrefetcher(std::shared_ptr<HepMC3::Reader> reader, G4long firstEntry, std::size_t depth)
+  : fReader(std::move(reader)), fFirstEntry(firstEntry), fSlots(depth > 0 ? depth : 1)
+{
+  fThread = std::thread(&HepMCPrefetcher::Run, this);
+}
+
+HepMCPrefetcher::~HepMCPrefetcher()
+{
+  Stop();
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+const HepMC3::GenEvent* HepMCPrefetcher::Acquire(G4long entry)
+{
+  if (entry < fFirstEntry) return nullptr;
+
+  std::unique_lock<std::mutex> lock(fMutex);
+  Slot& slot = SlotFor(entry);
+  auto done = [&] {
+    return (slot.entry == entry && slot.ready) || (fEndEntry >= 0 && entry >= fEndEntry) || fStop;
+  };
+
+  ++fNAcquired;
+  if (!done()) {
+    ++fNWaits;
+    fReady.wait(lock, done);
+  }
+  return (slot.entry == entry && slot.ready) ? &slot.event : nullptr;
+}
+
+void HepMCPrefetcher::Release(G4long entry)
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    Slot& slot = SlotFor(entry);
+    if (slot.entry != entry) return;
+    slot.entry = -1;
+    slot.ready = false;
+  }
+  fFree.notify_one();
+}
+
+void HepMCPrefetcher::Stop()
+{
+  if (!fThread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = true;
+  }
+  fFree.notify_all();
+  fReady.notify_all();
+  fThread.join();
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void HepMCPrefetcher::Run()
+{
+  G4long next = fFirstEntry;
+  std::unique_lock<std::mutex> lock(fMutex);
+  while (true) {
+    Slot& slot = SlotFor(next);
+    fFree.wait(lock, [&] { return fStop || slot.entry < 0; });
+    if (fStop) break;
+
+    // the slot belongs to this thread until it is marked ready
+    slot.entry = next;
+    lock.unlock();
+    fReader->read_event(slot.event);
+    const G4bool failed = fReader->failed();
+    lock.lock();
+
+    if (failed) {
+      slot.entry = -1;
+      fEndEntry = next;
+      fReady.notify_all();
+      break;
+    }
+    slot.ready = true;
+    ++next;
+    fReady.notify_all();
+  }
+}
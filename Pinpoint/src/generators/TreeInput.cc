@@ -0,0 +1,54 @@
+#include "generators/TreeInput.hh"
+#include "Logging.hh"
+
+#include "G4Run.hh"
+#include "G4RunManager.hh"
+
+#include "TFile.h"
+#include "TTreeCache.h"
+
+#include <algorithm>
+
+namespace TreeInput {
+
+  void Begin(TTree* tree, Long64_t cacheSize, Long64_t firstEntry)
+  {
+    tree->SetBranchStatus("*", 0);
+
+    tree->SetCacheSize(cacheSize > 0 ? cacheSize : 0);
+    if (cacheSize <= 0) return;
+
+    // the generators are loaded at the first event, so the run is known
+    Long64_t lastEntry = tree->GetEntries() - 1;
+    const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+    if (run && run->GetNumberOfEventToBeProcessed() > 0)
+      lastEntry = std::min(lastEntry, firstEntry + run->GetNumberOfEventToBeProcessed() - 1);
+    tree->SetCacheEntryRange(firstEntry, lastEntry);
+  }
+
+  void End(TTree* tree)
+  {
+    // the branches were added explicitly, nothing left to learn
+    if (tree->GetCacheSize() > 0) tree->StopCacheLearningPhase();
+  }
+
+  void PrintStats(const TTree* tree, const G4String& label)
+  {
+    TFile* file = tree->GetCurrentFile();
+    if (!file) return;
+
+    LOG_INFO(label << " I/O: " << file->GetBytesRead() << " bytes in "
+             << file->GetReadCalls() << " read calls from " << file->GetName());
+
+    TTreeCache* cache = dynamic_cast<TTreeCache*>(file->GetCacheRead(const_cast<TTree*>(tree)));
+    if (cache) {
+      LOG_INFO(label << " I/O: cache of " << cache->GetBufferSize() << " bytes, "
+               << cache->GetCachedBranches()->GetEntriesFast() << " branches, efficiency "
+               << cache->GetEfficiency() << " (relative " << cache->GetEfficiencyRel() << ")");
+    }
+    else {
+      LOG_INFO(label << " I/O: no read cache");
+    }
+  }
+
+}  // namespace TreeInput
@@ -22,6 +22,33 @@ import multiprocessing
 from multiprocessing import Pool, Queue, Manager
 
 
+def get_number_of_events_from_index(hepmc_file: str) -> int:
+    """
+    Reads the number of events from the `<file>.idx` event index written by
+    the HepMC generator, if it exists and matches the file size and
+    modification time
+
+    Args:
+        hepmc_file (str): path to file
+
+    Returns:
+        int: number of events in file, -1 if there is no valid index
+    """
+    index_file = hepmc_file + ".idx"
+    if not os.path.exists(index_file):
+        return -1
+
+    with open(index_file) as index:
+        if index.readline().strip() != "# pinpoint hepmc index v1":
+            return -1
+        fields = index.readline().split()
+
+    stat = os.stat(hepmc_file)
+    if len(fields) != 3 or int(fields[0]) != stat.st_size or int(fields[1]) != int(stat.st_mtime):
+        return -1
+    return int(fields[2])
+
+
 def get_number_of_events_in_hepmc(hepmc_file: str) -> int:
     """
     Simple script to count the number of events in a HEPMC file
@@ -33,6 +60,11 @@ def get_number_of_events_in_hepmc(hepmc_file: str) -> int:
         int: number of events in file
     """
     
+    # the event index is much cheaper than parsing the whole file
+    event_count = get_number_of_events_from_index(hepmc_file)
+    if event_count >= 0:
+        return event_count
+
     # Open the HepMC3 file
     reader = pyhepmc.io.ReaderAscii(hepmc_file)
     event_count = 0